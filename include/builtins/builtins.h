@@ -9,9 +9,18 @@
 
 #include <stdbool.h>
 
+#include "interpreter/statement.h"
 #include "cd.h"
 #include "exit.h"
+#include "joblog.h"
+#include "jobs.h"
+#include "parallel.h"
+#include "pin.h"
+#include "set.h"
 #include "status.h"
+#include "time.h"
+#include "trace.h"
+#include "ulimit.h"
 
 /**
  * @brief Checks @p cmd against supported builtin commands.
@@ -20,4 +29,31 @@
  */
 bool SH_IsBuiltin(char const *cmd);
 
+/**
+ * @brief Checks whether builtin @p cmd changes the shell's own state, such
+ * that a subshell must run it to leave the shell as it was.
+ * @param cmd builtin command string to check
+ * @return true if @p cmd is @c cd, @c set or @c exit, false otherwise
+ */
+bool SH_BuiltinChangesShell(char const *cmd);
+
+/**
+ * @brief Runs a statement for a builtin that runs another command, such as
+ * @c time or @c ulimit.
+ * @param stmt @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @return 0 or 1 on success, -1 on failure
+ */
+typedef int (*SH_BuiltinExecFn)(SH_Statement *stmt, char *cmd);
+
+/**
+ * @brief Runs builtin statement @p stmt within the calling process.
+ * @param stmt @c Statement object whose command is a builtin
+ * @param cmd command text the statement was parsed from
+ * @param exec runs the command that follows @c time or @c ulimit
+ * @return 1 if the shell is to exit, 0 otherwise, or -1 if @p stmt is not a
+ * builtin
+ */
+int SH_RunBuiltin(SH_Statement *stmt, char *cmd, SH_BuiltinExecFn exec);
+
 #endif //SMALLSH_BUILTINS_H
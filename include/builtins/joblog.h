@@ -0,0 +1,25 @@
+/**
+ * @file joblog.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief joblog builtin command.
+ */
+#ifndef SMALLSH_JOBLOG_H
+#define SMALLSH_JOBLOG_H
+
+#include <stddef.h>
+
+/**
+ * @brief Shows the output kept for background jobs.
+ *
+ * Usage: <tt>joblog [job]</tt>, where @c job is a job spec such as @c %1, or
+ * the PID of a job. Output is kept with <tt>set -o bg-log=KiB</tt>, for
+ * running jobs and for the last few that completed. With @c job, the tail of
+ * its output is printed. Without, every job with a log is listed, with how
+ * many bytes it wrote.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ */
+void SH_joblog(size_t argc, char **args);
+
+#endif //SMALLSH_JOBLOG_H
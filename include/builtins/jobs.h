@@ -0,0 +1,22 @@
+/**
+ * @file jobs.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief jobs builtin command.
+ */
+#ifndef SMALLSH_JOBS_H
+#define SMALLSH_JOBS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Lists running and pending background jobs.
+ *
+ * Usage: <tt>jobs [-l]</tt>. With @c -l, each running job is shown with its
+ * wall time, CPU times, max RSS, and context switches so far.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ */
+void SH_jobs(size_t argc, char **args);
+
+#endif //SMALLSH_JOBS_H
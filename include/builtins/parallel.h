@@ -0,0 +1,41 @@
+/**
+ * @file parallel.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief parallel builtin command.
+ */
+#ifndef SMALLSH_PARALLEL_H
+#define SMALLSH_PARALLEL_H
+
+#include <stddef.h>
+
+#include "interpreter/statement.h"
+
+#define SH_PARALLEL_MAX_JOBS 4096 /**< max value accepted for -j */
+#define SH_PARALLEL_MAX_STATUS 101 /**< cap on exit value, as in GNU parallel */
+
+/**
+ * @brief Runs a command once for each of a list of arguments, with at most
+ * @c N of them running at a time.
+ *
+ * Usage: <tt>parallel [-j N] [command [word ...]] ::: arg ...</tt>, or
+ * <tt>parallel [-j N] [command [word ...]] < listfile</tt> to take one
+ * argument per line of @c listfile.
+ *
+ * Every @c {} in the command's words is replaced by the argument, which is
+ * otherwise appended to them. Without a command, each argument is run as a
+ * command line of its own. @c N defaults to the number of online CPUs.
+ *
+ * Commands run as jobs in the job table. As each one exits, the next one is
+ * started. Output redirections given to @c parallel are opened once, and
+ * shared by every command; their stdin is @c /dev/null. The exit value is the
+ * number of commands that failed, up to @c SH_PARALLEL_MAX_STATUS.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ * @param in builtin's stdin redirections; the last is read for arguments
+ * @param out builtin's output redirections
+ */
+void SH_parallel(size_t argc, char **args, StmtStdin const *in,
+                 StmtStdout const *out);
+
+#endif //SMALLSH_PARALLEL_H
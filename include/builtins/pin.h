@@ -0,0 +1,24 @@
+/**
+ * @file pin.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief pin builtin command.
+ */
+#ifndef SMALLSH_PIN_H
+#define SMALLSH_PIN_H
+
+#include <stddef.h>
+
+/**
+ * @brief Shows or sets the CPUs a job may run on.
+ *
+ * Usage: <tt>pin [cpus] job</tt>, where @c job is a job spec such as @c %1,
+ * or the PID of a job, and @c cpus is a CPU list such as @c 0,2-3. Every
+ * thread of every process in the job's process group is pinned to @c cpus.
+ * Without @c cpus, the CPUs the job may run on are printed.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ */
+void SH_pin(size_t argc, char **args);
+
+#endif //SMALLSH_PIN_H
@@ -0,0 +1,48 @@
+/**
+ * @file set.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief set builtin command.
+ */
+#ifndef SMALLSH_SET_H
+#define SMALLSH_SET_H
+
+#include <stddef.h>
+
+#define SH_SET_MAX_JOBS 4096 /**< max value accepted for max-jobs */
+#define SH_SET_MAX_EXIT_TIMEOUT 3600 /**< max value accepted for exit-timeout */
+
+/**
+ * @brief Sets or shows shell options.
+ *
+ * Usage: <tt>set -o name=value</tt> to set option @c name, or <tt>set -o</tt>
+ * to list every option with its value. Supported options are:
+ * - @c affinity: how background jobs are placed on CPUs, each pinned to the
+ *   one running the fewest jobs: @c spread across packages and cores first,
+ *   @c compact on the sibling threads of a core first, or @c off.
+ * - @c bg-io: I/O scheduling class of background jobs: @c none to leave it
+ *   as the shell's, @c best-effort at its lowest level, or @c idle.
+ * - @c bg-load: 1-minute load average per CPU over which background jobs are
+ *   held back as pending, or 0 for none. Meant for kernels without PSI.
+ * - @c bg-log: KiB of output kept in memory for each background job, from
+ *   streams not redirected, for @c joblog to show, or 0 to throw it away.
+ * - @c bg-nice: how many nice levels below the shell background jobs run.
+ * - @c bg-psi-cpu, @c bg-psi-io, @c bg-psi-memory: percent of time some task
+ *   stalled on the resource, over the last 10 seconds, over which background
+ *   jobs are held back as pending, or 0 for none.
+ * - @c bg-sched: CPU scheduling policy of background jobs: @c other to leave
+ *   it as the shell's, @c batch, or @c idle.
+ * - @c bg-stop: @c on to stop CPU-heavy background jobs while a foreground
+ *   job runs, continuing them after, or @c off.
+ * - @c exit-timeout: seconds jobs are given to exit after the shell sends
+ *   their process groups SIGTERM on exit, before they are sent SIGKILL.
+ * - @c max-jobs: how many background jobs may run at once, or 0 for no limit.
+ *   Jobs started beyond it are queued, and run as others complete.
+ * - @c notify: @c text to report on background jobs in tab-separated lines,
+ *   or @c json to report on them in JSON lines.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ */
+void SH_set(size_t argc, char **args);
+
+#endif //SMALLSH_SET_H
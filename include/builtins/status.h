@@ -8,7 +8,8 @@
 #define SMALLSH_STATUS_H
 
 /**
- * @brief Displays last exit SH_status value to user.
+ * @brief Displays last exit SH_status value to user, and how many jobs are
+ * pending, if any.
  */
 void SH_status(void);
 
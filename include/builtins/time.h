@@ -0,0 +1,48 @@
+/**
+ * @file time.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief time builtin command.
+ */
+#ifndef SMALLSH_TIME_BUILTIN_H
+#define SMALLSH_TIME_BUILTIN_H
+
+#include <stdint.h>
+#include <sys/resource.h>
+
+/**
+ * @brief A @c Timer object holds the state of a timed statement when it began
+ * to run.
+ */
+typedef struct {
+        uint64_t begin; /**< when the shell began parsing the statement */
+        uint64_t start; /**< when the timed command began to run */
+        struct rusage self; /**< shell's own resource usage at start */
+        struct rusage children; /**< reaped children's resource usage at start */
+} SH_Timer;
+
+/**
+ * @brief Starts timing a statement's command.
+ *
+ * The statement itself is run by the shell, as if @c time were not there.
+ * @param timer @c Timer object to start
+ * @param begin monotonic time the shell began parsing the statement, in
+ * nanoseconds
+ */
+void SH_TimerStart(SH_Timer *timer, uint64_t begin);
+
+/**
+ * @brief Reports the time taken by a statement started with @c SH_TimerStart
+ * on stderr.
+ *
+ * Wall time (@c real) is split between the command's own run time (@c run),
+ * and the shell's overhead: parsing and expanding the statement (@c parse),
+ * opening its redirections and forking it (@c spawn), and reaping it and
+ * taking back the terminal (@c reap). A builtin runs within the shell, so it
+ * has no spawn or reap time. CPU times (@c user, @c sys) cover both the shell
+ * and any children it reaped in the meantime.
+ * @param timer @c Timer object to report on
+ */
+void SH_TimerReport(SH_Timer const *timer);
+
+#endif //SMALLSH_TIME_BUILTIN_H
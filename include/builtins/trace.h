@@ -0,0 +1,22 @@
+/**
+ * @file trace.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief trace builtin command.
+ */
+#ifndef SMALLSH_TRACE_BUILTIN_H
+#define SMALLSH_TRACE_BUILTIN_H
+
+/**
+ * @brief Controls command latency tracing.
+ *
+ * Supported actions are @c on, @c off, @c clear, and @c dump. Dumping writes
+ * the recorded events as Chrome trace-event JSON to @p filename, or to stdout
+ * if @p filename is @c NULL. If @p action is @c NULL, the trace is dumped to
+ * stdout.
+ * @param action action to perform
+ * @param filename file to dump trace to
+ */
+void SH_trace(char const *action, char const *filename);
+
+#endif //SMALLSH_TRACE_BUILTIN_H
@@ -0,0 +1,35 @@
+/**
+ * @file ulimit.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief ulimit builtin command.
+ */
+#ifndef SMALLSH_ULIMIT_H
+#define SMALLSH_ULIMIT_H
+
+#include <stddef.h>
+
+#include "job-control/rlimits.h"
+
+/**
+ * @brief Shows or sets the resource limits jobs run with.
+ *
+ * Usage: <tt>ulimit [-SHa] [-cdfnstuv [limit]] ... [command [arg ...]]</tt>.
+ * Each resource option shows its limit, or sets it to @c limit, a number or
+ * @c unlimited. @c -S and @c -H select the soft or hard limit; both are set
+ * by default, and the soft one is shown. @c -a shows every limit, and with no
+ * options, the file size limit is shown.
+ *
+ * Limits are kept by the shell, and applied to each job it spawns, not to the
+ * shell itself. If a command follows the options, the limits are set for it
+ * alone: they are copied into @p command, and its index returned, for the
+ * caller to run it with them.
+ * @param argc number of arguments in @p args
+ * @param args builtin arguments, including its name
+ * @param command output param for the limits to run a command with
+ * @return index of the command in @p args, or @p argc if there is none, or
+ * on error
+ */
+size_t SH_ulimit(size_t argc, char **args, SH_Limits *command);
+
+#endif //SMALLSH_ULIMIT_H
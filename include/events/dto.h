@@ -8,6 +8,8 @@
 #ifndef SMALLSH_DTO_H
 #define SMALLSH_DTO_H
 
+#include <stdint.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 
 /**
@@ -17,6 +19,16 @@
 typedef struct {
         pid_t pid; /**< PID of child that sent the signal */
         int status; /**< exit SH_status of child */
+        struct rusage usage; /**< resources used by child */
+        uint64_t finished; /**< monotonic time child was reaped at, in ns */
 } SH_SigchldDTO;
 
+/**
+ * @brief A @c SignalDTO names a signal the shell was sent in init mode, for
+ * the shell to forward to its background jobs.
+ */
+typedef struct {
+        int signo; /**< signal number */
+} SH_SignalDTO;
+
 #endif //SMALLSH_DTO_H
@@ -7,11 +7,16 @@
 #ifndef SMALLSH_EVENTS_H
 #define SMALLSH_EVENTS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
 #include "channel.h"
 #include "receiver.h"
 #include "sender.h"
 
 extern SH_Channel *sigchld_channel; /**< communication channel for SIGCHLD events */
+extern SH_Channel *signal_channel; /**< communication channel for init mode signals */
 extern SH_Receiver *receiver; /**< list of channels waiting on new events */
 extern SH_Sender *sender; /**< list of channels to notify on new events */
 
@@ -26,10 +31,54 @@ void SH_CleanupEvents(void);
   */
 int SH_InitEvents(void);
 
+/**
+ * @brief Detaches the events of a forked child from the shell's.
+ *
+ * The child gets channels of its own, so that each process takes in only the
+ * SIGCHLD events of its own children, and stops draining the shell's job
+ * logs. It waits on events through select from then on.
+ * @return 0 on success, -1 on failure
+ */
+int SH_EventsDetach(void);
+
 /**
  * @brief Consumes new events, notifies user of any them, and removes completed
  * jobs from global job table.
+ *
+ * Pending jobs are then started in the slots the completed jobs freed.
  */
 int SH_NotifyEvents(void);
 
+/**
+ * @brief Blocks until new events arrive, and consumes them.
+ *
+ * Completed jobs are marked as such in the global job table, but are left
+ * there for the caller, or the next @c SH_NotifyEvents, to remove.
+ * @return 0 on success, -1 on failure
+ */
+int SH_WaitEvents(void);
+
+/**
+ * @brief Like @c SH_WaitEvents, but gives up after @p timeout.
+ * @param timeout nanoseconds to wait for at most
+ * @return 0 on success, -1 on failure
+ */
+int SH_WaitEventsFor(uint64_t timeout);
+
+/**
+ * @brief Reads up to @p count bytes from @p fd, handling child completions
+ * while it waits for input.
+ * Completed jobs are marked as such in the global job table, and pending jobs
+ * started in their slots, so that queued jobs do not sit idle at the prompt.
+ * They are reported by the next @c SH_NotifyEvents. Once the shell has been
+ * told to terminate in init mode, input is treated as ended.
+ * Uses io_uring when available, and select otherwise; setting
+ * @c SMALLSH_EVENTS to @c select forces the latter.
+ * @param fd file descriptor to read from
+ * @param buf buffer to read into
+ * @param count maximum number of bytes to read
+ * @return number of bytes read, 0 at end of input, or -1 on failure
+ */
+ssize_t SH_ReadEvents(int fd, void *buf, size_t count);
+
 #endif //SMALLSH_EVENTS_H
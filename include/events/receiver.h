@@ -44,11 +44,25 @@ int SH_ReceiverAddChannel(SH_Receiver *receiver, SH_Channel *channel);
  *
  * This function will read all events from channel pipe, then update the global
  * job table with information received on newly completed child processes.
+ * Children not in the job table, such as orphans reparented to the shell in
+ * init mode, are reaped all the same, and otherwise ignored.
  * @param channel @c Channel to update
  * @return 0 on success, -1 on failure
  */
 int SH_ReceiverSigchldCallbackHandler(SH_Channel channel);
 
+/**
+ * @brief Callback handler responsible for consuming signals the shell was sent
+ * in init mode.
+ *
+ * This function will read all events from channel pipe, then forward each
+ * signal to the process groups of the jobs in the global job table. The
+ * signal handler already forwarded it to the foreground job, if any.
+ * @param channel @c Channel to update
+ * @return 0 on success, -1 on failure
+ */
+int SH_ReceiverSignalCallbackHandler(SH_Channel channel);
+
 /**
  * @brief Consumes events for all of the channels in its notification list,
  * calling their respective callback handlers on receipt of relevant data.
@@ -62,6 +76,34 @@ int SH_ReceiverSigchldCallbackHandler(SH_Channel channel);
  */
 int SH_ReceiverConsumeEvents(SH_Receiver *receiver);
 
+/**
+ * @brief Like @c SH_ReceiverConsumeEvents, but blocks until at least one
+ * channel has new events.
+ * @param receiver @c Receiver object
+ * @return 0 on success, -1 on failure
+ */
+int SH_ReceiverWaitEvents(SH_Receiver *receiver);
+
+/**
+ * @brief Like @c SH_ReceiverWaitEvents, but gives up after @p timeout.
+ * @param receiver @c Receiver object
+ * @param timeout how long to wait for events
+ * @return 0 on success, -1 on failure
+ */
+int SH_ReceiverWaitEventsFor(SH_Receiver *receiver, struct timeval *timeout);
+
+/**
+ * @brief Like @c SH_ReceiverWaitEvents, but also wakes up when @p fd has
+ * input to read, or @p timeout passes.
+ * @param receiver @c Receiver object
+ * @param fd file descriptor to wait for input on
+ * @param timeout how long to wait, or @c NULL to wait until an event arrives
+ * @return 1 if @p fd has input, 0 if only channels had events or time ran
+ * out, -1 on failure
+ */
+int SH_ReceiverWaitInput(SH_Receiver *receiver, int fd,
+                         struct timeval *timeout);
+
 /**
  * @brief Initializes a new @c Receiver object.
  * @param capacity maximum number of channels receiver will support
@@ -58,7 +58,8 @@ void SH_DestroySender(SH_Sender **sender);
  * global data type that is being accessed within is the pipe's write file
  * descriptor, which is done so for reads only, and without any dereferences.
  * The file descriptor is initialized on program startup, and remains unchanged
- * until program termination.
+ * until program termination. Every child is reaped, the foreground job
+ * included; the shell waiting on it takes its status from @p channel.
  *
  * The data sent is used for updating the shell's global job table, as it
  * requires information on both which child completed and what their exit
@@ -68,4 +69,15 @@ void SH_DestroySender(SH_Sender **sender);
  */
 int SH_SenderNotifySigchldEvent(SH_Channel *channel);
 
+/**
+ * @brief Sends signal @p sig, received in init mode, to @p channel.
+ *
+ * Like @c SH_SenderNotifySigchldEvent, this is meant to be called from a
+ * signal handler, and is async-safe.
+ * @param channel @c Channel to send data to
+ * @param sig signal received
+ * @return 0 on success, -1 on failure
+ */
+int SH_SenderNotifySignalEvent(SH_Channel *channel, int sig);
+
 #endif //SMALLSH_SENDER_H
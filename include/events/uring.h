@@ -0,0 +1,99 @@
+/**
+ * @file uring.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Minimal io_uring submission and completion queue pair.
+ *
+ * This is a thin wrapper over the raw io_uring system calls, just large enough
+ * for the shell's event loop to submit a few operations at a time and harvest
+ * their completions, without depending on liburing.
+ */
+#ifndef SMALLSH_URING_H
+#define SMALLSH_URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+/**
+ * @brief Opcode of @c IORING_OP_WAITID (Linux 6.7), which older kernel
+ * headers lack.
+ */
+#define SH_URING_OP_WAITID 50
+
+/**
+ * @brief An @c Uring object holds an io_uring instance, and its mapped
+ * submission and completion rings.
+ */
+typedef struct {
+        int fd; /**< io_uring file descriptor */
+        void *ring; /**< mapped submission and completion rings */
+        size_t ring_size; /**< size of ring mapping in bytes */
+        struct io_uring_sqe *sqes; /**< mapped submission queue entries */
+        size_t sqes_size; /**< size of sqes mapping in bytes */
+        unsigned *sq_head; /**< submission queue head, advanced by kernel */
+        unsigned *sq_tail; /**< submission queue tail, advanced by us */
+        unsigned *sq_array; /**< submission queue index array */
+        unsigned sq_mask; /**< submission queue index mask */
+        unsigned sq_entries; /**< number of submission queue entries */
+        unsigned *cq_head; /**< completion queue head, advanced by us */
+        unsigned *cq_tail; /**< completion queue tail, advanced by kernel */
+        struct io_uring_cqe *cqes; /**< completion queue entries */
+        unsigned cq_mask; /**< completion queue index mask */
+        unsigned queued; /**< entries prepared but not yet submitted */
+        uint64_t ops; /**< bitmap of supported opcodes below 64 */
+} SH_Uring;
+
+/**
+ * @brief Sets up a new io_uring instance with room for @p entries
+ * submissions, and probes which operations it supports.
+ * @param entries number of submission queue entries
+ * @return new @c Uring object on success, @c NULL with errno set if io_uring
+ * is unavailable or blocked
+ */
+SH_Uring *SH_CreateUring(unsigned entries);
+
+/**
+ * @brief Unmaps @p ring's queues, and closes it.
+ *
+ * Operations still in flight are cancelled by the kernel.
+ * @param ring @c Uring object to destroy
+ */
+void SH_DestroyUring(SH_Uring **ring);
+
+/**
+ * @brief Returns whether or not @p ring's kernel supports operation @p op.
+ * @param ring @c Uring object
+ * @param op io_uring opcode
+ * @return true if supported, false otherwise
+ */
+bool SH_UringSupports(SH_Uring const *ring, unsigned op);
+
+/**
+ * @brief Returns the next free submission queue entry, zeroed, and queues it
+ * for the next @c SH_UringSubmitAndWait.
+ * @param ring @c Uring object
+ * @return submission queue entry, or @c NULL if the queue is full
+ */
+struct io_uring_sqe *SH_UringGetSqe(SH_Uring *ring);
+
+/**
+ * @brief Submits queued entries, then blocks until at least @p wait_nr
+ * completions are ready.
+ * @param ring @c Uring object
+ * @param wait_nr number of completions to wait for, or 0 to not block
+ * @return number of entries submitted, or -1 with errno set on failure
+ */
+int SH_UringSubmitAndWait(SH_Uring *ring, unsigned wait_nr);
+
+/**
+ * @brief Copies the oldest ready completion into @p cqe, and removes it from
+ * the completion queue.
+ * @param ring @c Uring object
+ * @param cqe output param for completion
+ * @return true if a completion was ready, false otherwise
+ */
+bool SH_UringNextCqe(SH_Uring *ring, struct io_uring_cqe *cqe);
+
+#endif //SMALLSH_URING_H
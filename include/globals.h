@@ -9,14 +9,21 @@
 
 #include <signal.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 extern volatile sig_atomic_t smallsh_fg_only_mode_flag; /**< foreground-only flag for handlers */
 extern int smallsh_fg_only_mode; /**< foreground-only mode */
 
+extern bool smallsh_init_mode; /**< whether or not shell runs as an init process */
+extern volatile sig_atomic_t smallsh_init_signal; /**< last signal forwarded in init mode, or 0 */
+extern volatile sig_atomic_t smallsh_fg_pgid; /**< PGID of foreground job, or 0 */
+
 extern int smallsh_interactive_mode; /**< whether or not shell is in interactive mode */
+extern bool smallsh_capturing; /**< whether or not output is captured for a command substitution */
 extern bool smallsh_line_buffer; /**< whether or not to add newlines to shell commands */
 extern pid_t smallsh_shell_pgid; /**< shell's PGID */
+extern uint64_t smallsh_stmt_begin; /**< when parsing of the running statement began, in monotonic nanoseconds */
 extern int smallsh_shell_terminal; /**< shell's terminal file */
 
 #endif //SMALLSH_GLOBALS_H
@@ -0,0 +1,177 @@
+/**
+ * @file bytecode.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For compiling parsed scripts into bytecode, and running it.
+ *
+ * A script's statements are lowered into a flat instruction stream, followed
+ * by a table of the strings it references. The compiled image is
+ * position-independent, so it can be written to a cache file as-is, and later
+ * mapped straight back into memory and run without lexing or parsing the
+ * script again. Cache files are keyed by a hash of the script's contents.
+ */
+#ifndef SMALLSH_BYTECODE_H
+#define SMALLSH_BYTECODE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "interpreter/script.h"
+#include "interpreter/statement.h"
+
+#define SH_BYTECODE_MAGIC "SHBC" /**< identifies a bytecode image */
+#define SH_BYTECODE_VERSION 10 /**< bumped when the image format changes */
+#define SH_BYTECODE_PREFETCH 8 /**< max statements assembled ahead of time */
+
+/**
+ * @brief Bytecode operations.
+ *
+ * Each statement is lowered into its words and redirections, which are
+ * collected until an @c EXEC instruction executes them. Whether a command is
+ * a builtin is only decided when it runs, so images do not depend on the
+ * shell's set of builtins.
+ */
+typedef enum {
+        OP_END = 0, /**< end of program */
+        OP_ARG, /**< append word to command arguments */
+        OP_REDIR, /**< append word to stdin or output redirections */
+        OP_EXEC, /**< execute collected statement as a builtin or a job */
+        OP_COUNT, /**< number of operations */
+} SH_BytecodeOp;
+
+/**
+ * @brief Bytecode instruction flags.
+ */
+typedef enum {
+        OPFLAGS_NONE = 0, /**< default flag */
+        OPFLAGS_EXPAND = 1, /**< word has variables, which can be expanded
+                                 ahead of time */
+        OPFLAGS_STDOUT = 2, /**< redirection is for output, not stdin */
+        OPFLAGS_BGCTRL = 4, /**< statement is run in the background */
+        OPFLAGS_SUBST = 8, /**< word has a command substitution, which must
+                                only be expanded when its statement runs */
+} SH_BytecodeFlags;
+
+/**
+ * @brief A bytecode instruction.
+ */
+typedef struct {
+        uint8_t op; /**< @c SH_BytecodeOp */
+        uint8_t flags; /**< @c SH_BytecodeFlags */
+        uint16_t redir; /**< @c IORedirType of a @c REDIR, otherwise zero */
+        uint32_t str; /**< offset of operand string in string table */
+} SH_BytecodeInsn;
+
+/**
+ * @brief Leading header of a bytecode image.
+ *
+ * The header is followed by @c n_insns instructions, and then by
+ * @c strtab_size bytes of NUL-terminated strings.
+ */
+typedef struct {
+        char magic[4]; /**< @c SH_BYTECODE_MAGIC */
+        uint32_t version; /**< @c SH_BYTECODE_VERSION */
+        uint64_t hash; /**< hash of script contents compiled */
+        uint32_t n_insns; /**< number of instructions */
+        uint32_t strtab_size; /**< size of string table in bytes */
+} SH_BytecodeHeader;
+
+/**
+ * @brief A @c Bytecode object holds a compiled bytecode image, either on the
+ * heap or mapped from a cache file.
+ */
+typedef struct {
+        void *image; /**< header, instructions, and string table */
+        size_t size; /**< size of image in bytes */
+        bool mapped; /**< whether image is mapped from a file */
+        SH_BytecodeHeader const *header; /**< image header */
+        SH_BytecodeInsn const *insns; /**< image instructions */
+        char const *strtab; /**< image string table */
+} SH_Bytecode;
+
+/**
+ * @brief Executes a statement assembled by @c SH_BytecodeRun.
+ * @param stmt statement to execute, with all words expanded
+ * @param cmd source line the statement was compiled from
+ * @param ctx caller context
+ * @return 0 to keep running, anything else to stop
+ */
+typedef int (*SH_BytecodeExecFn)(SH_Statement *stmt, char *cmd, void *ctx);
+
+/**
+ * @brief Compiles @p script's parsed statements into a new @c Bytecode object.
+ * @param script parsed @c Script object to compile
+ * @param hash hash of @p script's contents, from @c SH_BytecodeHash
+ * @return new @c Bytecode object on success, @c NULL on failure
+ */
+SH_Bytecode *SH_CreateBytecode(SH_Script const *script, uint64_t hash);
+
+/**
+ * @brief Maps a bytecode image previously saved to @p path.
+ *
+ * The image is validated, so a stale, truncated, or otherwise corrupt cache
+ * file is never run.
+ * @param path file to map image from
+ * @param hash hash of the script contents the image must have been compiled
+ * from
+ * @return new @c Bytecode object on success, @c NULL if the file is missing or
+ * invalid
+ */
+SH_Bytecode *SH_LoadBytecode(char const *path, uint64_t hash);
+
+/**
+ * @brief Frees or unmaps @p bc's image.
+ * @param bc @c Bytecode object to destroy
+ */
+void SH_DestroyBytecode(SH_Bytecode **bc);
+
+/**
+ * @brief Hashes @p n bytes of @p data with 64-bit FNV-1a.
+ * @param data bytes to hash
+ * @param n number of bytes to hash
+ * @return hash value
+ */
+uint64_t SH_BytecodeHash(void const *data, size_t n);
+
+/**
+ * @brief Determines the cache file for a script with content hash @p hash,
+ * creating the cache directory if needed.
+ *
+ * The cache directory is @c $SMALLSH_CACHE_DIR if set, or else
+ * @c $XDG_CACHE_HOME/smallsh, or else @c $HOME/.cache/smallsh. Setting
+ * @c SMALLSH_CACHE_DIR to the empty string disables caching.
+ * @param hash script content hash
+ * @param path output buffer for cache file path
+ * @param size size of @p path in bytes
+ * @return 0 on success, -1 if caching is disabled or unavailable
+ */
+int SH_BytecodeCachePath(uint64_t hash, char *path, size_t size);
+
+/**
+ * @brief Writes @p bc's image to @p path.
+ *
+ * The image is written to a temporary file first and then renamed into place,
+ * so concurrent runs never observe a partial cache file.
+ * @param bc @c Bytecode object to save
+ * @param path file to save image to
+ * @return 0 on success, -1 on failure
+ */
+int SH_BytecodeSave(SH_Bytecode const *bc, char const *path);
+
+/**
+ * @brief Runs @p bc, handing each assembled statement to @p exec.
+ *
+ * While a foreground job runs, up to @c SH_BYTECODE_PREFETCH of the following
+ * statements are assembled into a ready queue, with every word expanded
+ * except for command substitutions, whose side effects must happen in order.
+ * The next job can then be started as soon as the current one exits.
+ * @param bc @c Bytecode object to run
+ * @param exec callback to execute statements with
+ * @param ctx caller context passed to @p exec
+ * @return 0 when the program ends, the first nonzero value returned by
+ * @p exec, or -1 on failure
+ */
+int SH_BytecodeRun(SH_Bytecode const *bc, SH_BytecodeExecFn exec, void *ctx);
+
+#endif //SMALLSH_BYTECODE_H
@@ -28,6 +28,17 @@
 #define OUTPUT_REDIR_OP '>'
 #define IS_INPUT_REDIR_OP(c1, c2) (c1 == INPUT_REDIR_OP && IS_TERMINAL(c2))
 #define IS_OUTPUT_REDIR_OP(c1, c2) (c1 == OUTPUT_REDIR_OP && IS_TERMINAL(c2))
+#define STDERR_FD_SYM '2'
+#define STDOUT_FD_SYM '1'
+#define IS_APPEND_REDIR_OP(c1, c2, c3) \
+        (c1 == OUTPUT_REDIR_OP && c2 == OUTPUT_REDIR_OP && IS_TERMINAL(c3))
+#define IS_STDERR_REDIR_OP(c1, c2, c3) \
+        (c1 == STDERR_FD_SYM && c2 == OUTPUT_REDIR_OP && IS_TERMINAL(c3))
+#define IS_STDERR_TO_STDOUT_REDIR_OP(c1, c2, c3, c4, c5) \
+        (c1 == STDERR_FD_SYM && c2 == OUTPUT_REDIR_OP && c3 == BG_CTRL_OP \
+         && c4 == STDOUT_FD_SYM && IS_TERMINAL(c5))
+#define IS_BOTH_REDIR_OP(c1, c2, c3) \
+        (c1 == BG_CTRL_OP && c2 == OUTPUT_REDIR_OP && IS_TERMINAL(c3))
 
 // control operators
 #define BG_CTRL_OP '&'
@@ -40,6 +51,9 @@
 /**
  * @brief Given an text stream @p buf, scans stream and generates @c Token
  * objects to store in @p tokens.
+ *
+ * Scanning stops after the first newline or comment token, so that @p buf may
+ * point into a larger buffer holding further lines.
  * @param buf text stream to scan
  * @param max_tok size of @p tokens array
  * @param toks array of pointers to @c Token objects to store token data
@@ -7,6 +7,7 @@
 #ifndef SMALLSH_PARSER_H
 #define SMALLSH_PARSER_H
 
+#include <stdbool.h>
 #include <sys/types.h>
 
 #include "token-iterator.h"
@@ -21,6 +22,8 @@ typedef struct SH_Parser {
         SH_Token **toks; /**< parsed tokens */
         ssize_t n_stmts; /**< number of statements created */
         SH_Statement **stmts; /**< statements created */
+        bool defer_expansion; /**< leave words unexpanded until execution */
+        char const *error; /**< token near last syntax error, or NULL */
 } SH_Parser;
 
 /**
@@ -35,6 +38,27 @@ SH_Parser *SH_CreateParser(void);
  */
 void SH_DestroyParser(SH_Parser **parser);
 
+/**
+ * @brief Destroys @p parser's tokens and statements, so that it can be reused
+ * to parse another line.
+ *
+ * Statements that should outlive the parser must be detached beforehand, by
+ * taking them from @c SH_Parser::stmts and zeroing @c SH_Parser::n_stmts.
+ * @param parser @c Parser object to clear
+ */
+void SH_ParserClear(SH_Parser *parser);
+
+/**
+ * @brief Expands every word in @p stmt in place.
+ *
+ * Used to expand statements parsed with @c SH_Parser::defer_expansion set,
+ * just before they are executed. The builtin flag is re-evaluated against the
+ * expanded command name.
+ * @param stmt @c Statement object to expand
+ * @return 0 on success, -1 on failure
+ */
+int SH_ParserExpandStatement(SH_Statement *stmt);
+
 /**
  * @brief Substitutes all variables in a word string with their literal value,
  * and returns the modified string.
@@ -42,7 +66,8 @@ void SH_DestroyParser(SH_Parser **parser);
  * This is the core expansion step for the parser.
  *
  * @param word word string to expand variables
- * @return new word string containing literal substitutions for all variables
+ * @return new word string containing literal substitutions for all variables,
+ * or @c NULL on failure
  */
 char *SH_ParserExpandWord(char *word);
 
@@ -59,6 +84,7 @@ char *SH_ParserExpandWord(char *word);
  * @param ptr pointer to current position in string
  * @param len input/output param for final string length
  * @return new string with PID at end, or @c NULL on error
+ * @note @p str is resized in place, and must not be used after this call.
  */
 char *SH_ParserInsertPid(char *str, char **ptr, size_t *len);
 
@@ -77,14 +103,21 @@ char *SH_ParserInsertPid(char *str, char **ptr, size_t *len);
  * comment: ^((whitespace)* '#' whitespace)\n
  * command: ^(word)+ [excluding '<', '>', '&', '#', whitespace, newline]\n
  * bg_ctrl: (whitespace '&' (whitespace | newline))$\n
- * io_redir: whitespace ('<' | '>') whitespace word\n
- * word: any consecutive characters, excluding whitespace and newline\n
+ * io_redir: whitespace (('<' | '>' | '>>' | '2>' | '&>') whitespace word |
+ * '2>&1')\n
+ * word: any consecutive characters, excluding whitespace (outside of a
+ * substitution) and newline\n
+ * substitution: '$(' (any characters, excluding newline) ')'\n
  * whitespace: (' ' | '\\t')+\n
  * newline: '\\n'\n
  *
+ * Parsing stops at the first newline. Words are expanded as they are parsed,
+ * unless @c SH_Parser::defer_expansion is set.
+ *
  * @param parser @c Parser object
  * @param buf character stream to parse
- * @return number of statements created on success, -1 on failure
+ * @return number of statements created on success, -1 on failure; on a syntax
+ * error, @c SH_Parser::error is set to the offending token
  * @note Caller is responsible for freeing parsed statements via @c
  * SH_DestroyStatement.
  */
@@ -101,7 +134,8 @@ void *SH_ParserPrintStmt(SH_Statement const *stmt);
  * no valid variable follows '$', then the '$' is copied into word instead.
  *
  * This is used during the expansion step of the parser, where variable
- * substitution is performed. As of now, only PID expansion is supported.
+ * substitution is performed. PID expansion ("$$") and command substitution
+ * ("$(command)") are supported.
  *
  * @pre @p old_ptr must point to the first '$' character.
  * @pre @p new_pointer must point to the first null ('\\0) character in @p word.
@@ -112,7 +146,7 @@ void *SH_ParserPrintStmt(SH_Statement const *stmt);
  * @param new_ptr pointer to next available character in @p word for insertion
  * @param len input/output parameter for final string length
  * @return new string with variable substituted at end, or just the '$' if no
- * valid variables present
+ * valid variables present; @c NULL on failure, with @p word freed
  */
 char *SH_ParserSubstituteVariable(char *word, char **old_ptr, char **new_ptr,
                                   size_t *len);
@@ -0,0 +1,67 @@
+/**
+ * @file script.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For parsing a script file into statements ahead of execution.
+ *
+ * The script file is mapped into memory, and lexed and parsed line by line in
+ * a single pass over the mapping. Expansion is deferred until each statement
+ * is executed, so that parsing has no side effects, and syntax errors can be
+ * reported before anything runs.
+ */
+#ifndef SMALLSH_SCRIPT_H
+#define SMALLSH_SCRIPT_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "interpreter/statement.h"
+
+/**
+ * @brief A parsed statement along with where it came from.
+ */
+typedef struct {
+        SH_Statement *stmt; /**< parsed statement, with words unexpanded */
+        char const *text; /**< source line, including its newline */
+        size_t len; /**< length of source line, including its newline */
+        size_t lineno; /**< 1-based line number of source line */
+} SH_ScriptStmt;
+
+/**
+ * @brief A @c Script object holds a mapped script file and its statements.
+ */
+typedef struct {
+        char *path; /**< path script was loaded from */
+        char *data; /**< mapped file contents, or NULL if empty */
+        size_t size; /**< size of mapped file contents */
+        char *tail; /**< newline-terminated copy of final line */
+        size_t n_stmts; /**< number of statements parsed */
+        size_t cap; /**< number of statements allocated */
+        SH_ScriptStmt *stmts; /**< statements parsed */
+} SH_Script;
+
+/**
+ * @brief Initializes a new @c Script object by mapping the file at @p path.
+ * @param path script file to load
+ * @return new @c Script object on success, @c NULL on failure
+ * @note An error message is printed to stderr on failure.
+ */
+SH_Script *SH_CreateScript(char const *path);
+
+/**
+ * @brief Unmaps @p script's file and frees its statements.
+ * @param script @c Script object to destroy
+ */
+void SH_DestroyScript(SH_Script **script);
+
+/**
+ * @brief Parses every line of @p script into statements.
+ *
+ * Every syntax error in the script is reported to stderr, along with its line
+ * number, rather than only the first.
+ * @param script @c Script object to parse
+ * @return number of syntax errors found, or -1 on failure
+ */
+ssize_t SH_ScriptParse(SH_Script *script);
+
+#endif //SMALLSH_SCRIPT_H
@@ -7,6 +7,19 @@
 #ifndef SMALLSH_STATEMENT_H
 #define SMALLSH_STATEMENT_H
 
+/**
+ * @brief IO Redirection types are used for determining which default
+ * IO streams to operate on, and how.
+ */
+typedef enum {
+        IOREDIR_STDIN = 0, /**< '<': stdin from file */
+        IOREDIR_STDOUT = 1, /**< '>': stdout to file, truncated */
+        IOREDIR_APPEND = 2, /**< '>>': stdout to file, appended */
+        IOREDIR_STDERR = 3, /**< '2>': stderr to file, truncated */
+        IOREDIR_STDERR_TO_STDOUT = 4, /**< '2>&1': stderr to stdout */
+        IOREDIR_BOTH = 5, /**< '&>': stdout and stderr to file, truncated */
+} IORedirType;
+
 /**
  * @brief Command object.
  *
@@ -32,12 +45,14 @@ typedef struct {
 /**
  * @brief STDOUT Stream object.
  *
- * A stdout stream is composed of a list of filenames, and a count of the
- * number of filenames. These streams will be later opened for stdout.
+ * A stdout stream is composed of a list of output redirections, in the order
+ * they were given, along with their types. These streams will be later opened
+ * for stdout and stderr.
  */
 typedef struct {
         size_t n; /**< number of file streams */
-        char **streams; /**< stream list */
+        char **streams; /**< stream list; NULL for IOREDIR_STDERR_TO_STDOUT */
+        IORedirType *types; /**< redirection type of each stream */
 } StmtStdout;
 
 /**
@@ -63,14 +78,6 @@ typedef struct {
         StmtFlags flags; /**< special properties */
 } SH_Statement;
 
-/**
- * @brief IO Redirection types are used for determining which default
- * IO stream to operate on.
- */
-typedef enum {
-        IOREDIR_STDIN = 0, /**< stdin stream */
-        IOREDIR_STDOUT = 1, /**< stdout stream */
-} IORedirType;
 
 /**
  * @brief Create and initialize a new @c Statement object.
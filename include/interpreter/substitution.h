@@ -0,0 +1,48 @@
+/**
+ * @file substitution.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For performing command substitution during word expansion.
+ */
+#ifndef SMALLSH_SUBSTITUTION_H
+#define SMALLSH_SUBSTITUTION_H
+
+#include <stddef.h>
+
+#include "utils/buffer.h"
+
+/**
+ * @brief Returns a pointer to the ')' that closes the command substitution
+ * starting at @p str.
+ *
+ * Nested substitutions are skipped over, so that the outermost closing
+ * parenthesis is matched.
+ * @pre @p str must point to the '$' of a "$(" sequence.
+ * @param str start of command substitution
+ * @return pointer to matching ')', or @c NULL if substitution is unterminated
+ */
+char *SH_SubstitutionFindEnd(char const *str);
+
+/**
+ * @brief Runs @p cmd and appends its standard output to @p out.
+ *
+ * <br>
+ *
+ * Builtin commands are short-circuited and evaluated within the shell process,
+ * with their output captured in a memory file. As with a subshell, @c cd,
+ * @c set and @c exit cannot alter the shell's state, so only they are run in
+ * a forked copy of the shell. All other commands are run in a child process,
+ * and their output is read from a pipe directly into @p out's spare capacity.
+ *
+ * <br>
+ *
+ * Trailing newlines are removed from the captured output. The output is not
+ * subject to further expansion or field splitting.
+ * @param cmd command string to run
+ * @param n length of @p cmd
+ * @param out @c Buffer object to append output to
+ * @return 0 on success, -1 on failure
+ */
+int SH_SubstitutionCapture(char const *cmd, size_t n, SH_Buffer *out);
+
+#endif //SMALLSH_SUBSTITUTION_H
@@ -70,6 +70,7 @@ SH_Token *SH_TokenIteratorNext(SH_TokenIterator *iter);
  * @param offset how far ahead to peek
  * @return the nth character past the iterators cursor, or an empty
  * @c NewlineToken object if no more tokens to seek past
+ * @note The empty @c NewlineToken object is shared, and must not be freed.
  */
 SH_Token *SH_TokenIteratorPeek(SH_TokenIterator *iter, unsigned int offset);
 
@@ -26,7 +26,11 @@ typedef enum {
         TOK_REDIR_INPUT = 4, /**< an input redirection is a '<' to redirect file io */
         TOK_REDIR_OUTPUT = 5, /**< an output redirection is a '>' to redirect file io */
         TOK_WORD = 6, /**< a basic token is any word */
-        TOK_COUNT = 7, /**< count of tokens to allow iterating over them */
+        TOK_REDIR_APPEND = 7, /**< an append redirection is a '>>' to append output to a file */
+        TOK_REDIR_STDERR = 8, /**< an error redirection is a '2>' to redirect stderr */
+        TOK_REDIR_STDERR_TO_STDOUT = 9, /**< a '2>&1' sends stderr wherever stdout goes */
+        TOK_REDIR_BOTH = 10, /**< a '&>' redirects both stdout and stderr to a file */
+        TOK_COUNT = 11, /**< count of tokens to allow iterating over them */
 } SH_TokenType;
 
 /**
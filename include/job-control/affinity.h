@@ -0,0 +1,86 @@
+/**
+ * @file affinity.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief CPU placement of background jobs.
+ *
+ * Background jobs can be pinned to a CPU each, chosen from those running the
+ * fewest jobs, so that long-running jobs keep their caches warm rather than
+ * being moved from core to core.
+ */
+#ifndef SMALLSH_AFFINITY_H
+#define SMALLSH_AFFINITY_H
+
+#include <sched.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "job-control/job-table.h"
+
+/**
+ * @brief Policies for placing background jobs on CPUs.
+ */
+typedef enum {
+        AFFINITY_OFF, /**< leave placement to the kernel */
+        AFFINITY_SPREAD, /**< across packages and cores first */
+        AFFINITY_COMPACT, /**< on the sibling threads of a core first */
+} SH_AffinityPolicy;
+
+/**
+ * @brief Sets the policy background jobs are placed by from now on.
+ * @param policy placement policy
+ */
+void SH_AffinitySetPolicy(SH_AffinityPolicy policy);
+
+/**
+ * @brief Returns the policy background jobs are placed by.
+ * @return current placement policy
+ */
+SH_AffinityPolicy SH_AffinityGetPolicy(void);
+
+/**
+ * @brief Chooses a CPU for a new background job.
+ *
+ * Of the CPUs the shell may run on, the one the fewest running jobs in
+ * @p table are placed on is chosen, in the order the policy lays them out.
+ * @param table JobTable object
+ * @return CPU to pin job to, or -1 if the policy is off
+ */
+int SH_AffinityPlace(SH_JobTable const *table);
+
+/**
+ * @brief Pins the calling process to @p cpu.
+ *
+ * This is meant to be called by a forked child, right before exec, so that
+ * every process the job starts inherits it. Failures are ignored.
+ * @param cpu CPU to pin to, or -1 to leave affinity as is
+ */
+void SH_AffinityApply(int cpu);
+
+/**
+ * @brief Pins every thread of every process in process group @p pgid to
+ * @p cpus.
+ * @param pgid process group to pin
+ * @param cpus CPUs to allow
+ * @return number of threads pinned, or -1 on failure
+ */
+int SH_AffinityPinGroup(pid_t pgid, cpu_set_t const *cpus);
+
+/**
+ * @brief Parses a CPU list such as @c 0,2-3 into @p cpus.
+ * @param list CPU list
+ * @param cpus output param for CPUs listed
+ * @return 0 on success, -1 if @p list is malformed
+ */
+int SH_AffinityParseList(char const *list, cpu_set_t *cpus);
+
+/**
+ * @brief Formats @p cpus as a CPU list such as @c 0,2-3.
+ * @param cpus CPUs to format
+ * @param buf output buffer
+ * @param size size of @p buf in bytes
+ * @return length of the formatted list, as by @c snprintf
+ */
+int SH_AffinityFormatList(cpu_set_t const *cpus, char *buf, size_t size);
+
+#endif //SMALLSH_AFFINITY_H
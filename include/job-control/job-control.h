@@ -17,12 +17,77 @@
 
 extern SH_JobTable *job_table; /**< shell global job-control table */
 
+/**
+ * @brief When the last foreground job started and exited, as monotonic
+ * timestamps in nanoseconds.
+ */
+typedef struct {
+        uint64_t started; /**< child was forked, and put into its group */
+        uint64_t exited; /**< shell saw the child exit */
+} SH_JobControlTimes;
+
+/**
+ * @brief Work to do while a foreground job runs.
+ * @param ctx context given to @c SH_JobControlSetWaitHook
+ */
+typedef void (*SH_JobControlWaitHook)(void *ctx);
+
+/**
+ * @brief Sets @p hook to be called once for every foreground job, after it has
+ * been spawned and before the shell blocks waiting for it.
+ *
+ * This lets the shell overlap its own work with the job's execution. The hook
+ * should be kept short, since the job is not waited on until it returns.
+ * @param hook function to call, or @c NULL to remove the current hook
+ * @param ctx context to pass to @p hook
+ */
+void SH_JobControlSetWaitHook(SH_JobControlWaitHook hook, void *ctx);
+
 /**
  * @brief Creates new child process and runs @p job within child.
+ *
+ * If the job table caps how many background jobs may run at once, a
+ * background job that would exceed the cap is marked pending instead, and
+ * left in the table to be started by @c SH_JobControlLaunchPending. So is
+ * one started while the machine is under pressure, with thresholds set.
  * @param job job to run
  * @param run_fg whether or not the job should run in the foreground
  * @return 0 on success, -1 on failure
  */
 int SH_JobControlLaunchJob(SH_Job **job, bool run_fg);
 
+/**
+ * @brief Creates new child process and runs @p job within it in the
+ * background, without announcing it or waiting for it.
+ *
+ * The job's completion is picked up through SIGCHLD events, as for any other
+ * background job.
+ * @param job job to run
+ */
+void SH_JobControlSpawnJob(SH_Job *job);
+
+/**
+ * @brief Starts pending jobs, oldest first, until the job table's running job
+ * cap is reached, a pressure threshold is exceeded, or none are left.
+ *
+ * Pressure never holds back a job when no other is running.
+ *
+ * Each started job is announced as any other background job, though the
+ * notices are left buffered until the next @c SH_NoticeFlush.
+ */
+void SH_JobControlLaunchPending(void);
+
+/**
+ * @brief Returns when the last foreground job started and exited.
+ * @return timestamps of the last foreground job, or zeroes if none has run
+ */
+SH_JobControlTimes SH_JobControlLastForeground(void);
+
+/**
+ * @brief Returns the exit status of the last foreground job, as a shell
+ * reports it: its exit value, or 128 plus the signal that ended it.
+ * @return exit status, or 0 if no foreground job has run
+ */
+int SH_JobControlLastStatus(void);
+
 #endif //SMALLSH_JOB_CONTROL_H
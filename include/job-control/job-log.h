@@ -0,0 +1,138 @@
+/**
+ * @file job-log.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief In-memory logs of background job output.
+ *
+ * Background jobs have their output thrown away unless redirected, so a job
+ * that fails leaves nothing behind to look at. With logs enabled, output they
+ * would have thrown away goes through a pipe instead, into a ring buffer of a
+ * fixed size per job, for @c joblog to show the tail of. Nothing is written to
+ * disk.
+ */
+#ifndef SMALLSH_JOB_LOG_H
+#define SMALLSH_JOB_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "job-control/job.h"
+
+#define SH_JOB_LOG_MAX_SIZE (64u * 1024 * 1024) /**< max bytes per log */
+#define SH_JOB_LOG_KEEP 16 /**< logs of destroyed jobs kept */
+
+typedef struct SH_JobLog SH_JobLog;
+
+/**
+ * @brief A @c JobLog object holds the tail of a background job's output.
+ */
+struct SH_JobLog {
+        char *buf; /**< ring buffer, allocated once output arrives */
+        size_t size; /**< size of ring buffer in bytes */
+        uint64_t written; /**< bytes of output read in all */
+        int fd; /**< read end of output pipe, or -1 once drained */
+        unsigned spec; /**< job's position within job table */
+        pid_t pid; /**< job's PID */
+        char *command; /**< job's command */
+        bool finished; /**< whether job was destroyed */
+        SH_JobLog *next; /**< next log, newest first */
+};
+
+/**
+ * @brief Sets up the descriptor that becomes readable when any log has
+ * output to read.
+ * @return descriptor to wait on, or -1 on failure
+ */
+int SH_JobLogInit(void);
+
+/**
+ * @brief Frees every log, and closes their pipes.
+ */
+void SH_JobLogCleanup(void);
+
+/**
+ * @brief Stops a forked child from draining the shell's logs.
+ *
+ * The child's copies of the pipes are closed, leaving the output they hold
+ * for the shell, and what the logs kept so far readable. The descriptor of
+ * @c SH_JobLogFd then refers to an epoll instance of the child's own.
+ */
+void SH_JobLogDetach(void);
+
+/**
+ * @brief Sets how many bytes of output are kept per job, for jobs started from
+ * now on.
+ * @param size bytes per log, or 0 to keep no logs
+ */
+void SH_JobLogSetSize(size_t size);
+
+/**
+ * @brief Returns how many bytes of output are kept per job.
+ * @return bytes per log, or 0 if logs are off
+ */
+size_t SH_JobLogGetSize(void);
+
+/**
+ * @brief Returns the descriptor that becomes readable when any log has output
+ * to read.
+ * @return descriptor set up by @c SH_JobLogInit, or -1
+ */
+int SH_JobLogFd(void);
+
+/**
+ * @brief Returns whether or not any log still has its pipe open.
+ * @return true if output may yet arrive, false otherwise
+ */
+bool SH_JobLogActive(void);
+
+/**
+ * @brief Captures into a new log the output of @p job that would otherwise be
+ * thrown away, if logs are on.
+ *
+ * This is meant to be called right before @p job is forked, with its
+ * redirections open.
+ * @param job background job about to be spawned
+ */
+void SH_JobLogOpen(SH_Job *job);
+
+/**
+ * @brief Lets go of @p job's log, if it has one, which is kept for a while.
+ *
+ * Only the newest @c SH_JOB_LOG_KEEP logs of destroyed jobs are kept.
+ * @param job job being destroyed
+ */
+void SH_JobLogRelease(SH_Job *job);
+
+/**
+ * @brief Reads whatever output is ready from every open log's pipe.
+ */
+void SH_JobLogDrain(void);
+
+/**
+ * @brief Finds the newest log of a job, by job spec, such as @c %2, or by the
+ * PID of its process.
+ * @param spec job spec or PID
+ * @return @c JobLog object if found, @c NULL if not
+ */
+SH_JobLog *SH_JobLogFind(char const *spec);
+
+/**
+ * @brief Returns the newest log.
+ * @return newest @c JobLog object, or @c NULL if there is none
+ */
+SH_JobLog *SH_JobLogFirst(void);
+
+/**
+ * @brief Writes the output kept in @p log to @p stream, oldest first.
+ *
+ * If older output was overwritten, the partial line left of it is skipped,
+ * unless no other line was kept.
+ * @param log @c JobLog object
+ * @param stream stream to write to
+ */
+void SH_JobLogPrint(SH_JobLog const *log, FILE *stream);
+
+#endif //SMALLSH_JOB_LOG_H
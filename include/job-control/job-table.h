@@ -10,13 +10,19 @@
 #ifndef SMALLSH_JOB_TABLE_H
 #define SMALLSH_JOB_TABLE_H
 
+#include <stdint.h>
+
 #include "job.h"
 
+#define SH_JOB_TABLE_EXIT_TIMEOUT UINT64_C(3000000000) /**< default exit_timeout */
+
 /**
  * @brief JobTable object.
  */
 typedef struct {
         size_t n_jobs; /**< number of jobs in table */
+        size_t max_running; /**< cap on running background jobs, 0 for none */
+        uint64_t exit_timeout; /**< ns jobs get to exit before SIGKILL */
         SH_Job *head; /**< pointer to linked list head */
 } SH_JobTable;
 
@@ -39,6 +45,39 @@ void SH_DestroyJobTable(SH_JobTable *table);
  */
 void SH_JobTableAddJob(SH_JobTable *table, SH_Job *job);
 
+/**
+ * @brief Removes @p job from the JobTable and frees it, without notifying the
+ * user.
+ * @param table JobTable object
+ * @param job Job object to remove
+ */
+void SH_JobTableRemoveJob(SH_JobTable *table, SH_Job *job);
+
+/**
+ * @brief Counts the background jobs in the JobTable that are running.
+ * @param table JobTable object
+ * @return number of running background jobs
+ */
+size_t SH_JobTableCountRunning(SH_JobTable const *table);
+
+/**
+ * @brief Counts the jobs in the JobTable that are queued to run.
+ * @param table JobTable object
+ * @return number of pending jobs
+ */
+size_t SH_JobTableCountPending(SH_JobTable const *table);
+
+/**
+ * @brief Finds the pending job to launch next, if the running job cap allows
+ * another background job to run.
+ *
+ * Pending jobs are launched in the order they were queued.
+ * @param table JobTable object
+ * @return oldest pending @c Job object, or @c NULL if there is none, or no
+ * free slot for it
+ */
+SH_Job *SH_JobTableNextPending(SH_JobTable const *table);
+
 /**
  * @brief Clean the JobTable, displaying completed job statuses along
  * the way.
@@ -55,13 +94,33 @@ void SH_JobTableCleanJobs(SH_JobTable *table);
 SH_Job *SH_JobTableFindJob(SH_JobTable const *table, pid_t job_pgid);
 
 /**
- * @brief Kills all children in JobTable.
+ * @brief Find a Job within the JobTable by a job spec, such as @c %2, or by
+ * the PID of its process.
+ * @param table JobTable object
+ * @param spec job spec or PID
+ * @return @c Job object if found, @c NULL if not
+ */
+SH_Job *SH_JobTableFindSpec(SH_JobTable const *table, char const *spec);
+
+/**
+ * @brief Sends @p sig to the process group of every job that was started,
+ * completed or not, so that it reaches any processes the job left behind.
  *
- * Called on program exit to clean up any unterminated children
- * the shell created.
+ * With @p sig 0, nothing is sent, but groups are still counted.
+ * @param table JobTable object
+ * @param sig signal to send
+ * @return number of process groups that still had members
+ */
+size_t SH_JobTableSignalJobs(SH_JobTable const *table, int sig);
+
+/**
+ * @brief Lists running and pending background jobs, oldest first, in the
+ * format used to report completed ones.
  * @param table JobTable object
+ * @param usage whether or not to show the resources each running job has
+ * used so far
  */
-void SH_JobTableKillAllJobs(SH_JobTable *table);
+void SH_JobTableListJobs(SH_JobTable const *table, bool usage);
 
 /**
  * @brief List all Jobs in a pretty-printed format.
@@ -74,8 +133,11 @@ void SH_JobTablePrintJobs(SH_JobTable const *table);
  * @param table JobTable object
  * @param pid Job PID
  * @param status SH_status to give Job
+ * @param usage resources used by Job's process, or @c NULL if unknown
+ * @param finished monotonic time Job's process was reaped at, in nanoseconds
  * @return 0 if Job was found and updated, -1 otherwise
  */
-int SH_JobTableUpdateJob(SH_JobTable const *table, pid_t pid, int status);
+int SH_JobTableUpdateJob(SH_JobTable const *table, pid_t pid, int status,
+                         struct rusage const *usage, uint64_t finished);
 
 #endif //SMALLSH_JOB_TABLE_H
@@ -11,8 +11,10 @@
 #define SMALLSH_JOB_H
 
 #include "process.h"
+#include "rlimits.h"
 
 typedef struct SH_Job SH_Job;
+struct SH_JobLog;
 
 /**
  * @brief Job object.
@@ -21,10 +23,14 @@ struct SH_Job {
         char *command; /**< command typed by user for this job */
         SH_Process *proc; /**< process object */
         pid_t pgid; /**< PGID */
-        char *infile; /**< STDIN filename */
-        char *outfile; /**< STDOUT filename */
+        SH_Redirs redirs; /**< descriptors opened for io redirections */
         unsigned spec; /**< position within job table */
         bool run_bg; /**< whether or not job is to run in background */
+        bool pending; /**< whether job is queued, waiting for a free slot */
+        bool paused; /**< whether shell stopped job for a foreground one */
+        int cpu; /**< CPU job was placed on, or -1 if not pinned to one */
+        SH_Limits limits; /**< resource limits to apply at spawn */
+        struct SH_JobLog *log; /**< log of job's output, or NULL if not kept */
         SH_Job *next; /**< next job in table */
 };
 
@@ -32,13 +38,11 @@ struct SH_Job {
  * @brief Initializes new Job object.
  * @param command job command entered by user
  * @param proc job's process object
- * @param infile job's STDIN filename
- * @param outfile job's STDOUT filename
  * @param run_bg whether or not job is to be run in background
- * @return new Job object
+ * @return new Job object, with no redirections, and the resource limits in
+ * effect for jobs created now
  */
-SH_Job *SH_CreateJob(char *command, SH_Process *proc, char *infile,
-                     char *outfile, bool run_bg);
+SH_Job *SH_CreateJob(char *command, SH_Process *proc, bool run_bg);
 
 /**
  * @brief Cleans up and frees job resources.
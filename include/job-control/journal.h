@@ -0,0 +1,99 @@
+/**
+ * @file journal.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For logging job lifecycle events to a binary file, for post-mortem
+ * analysis.
+ *
+ * The journal is a file of fixed-size records, used as a ring: once it is
+ * full, the oldest records are overwritten. It is mapped into memory, so that
+ * logging an event costs one copy, and no system call, and what was logged
+ * survives the shell crashing. Sessions that share a journal file append to
+ * it in turn.
+ */
+#ifndef SMALLSH_JOURNAL_H
+#define SMALLSH_JOURNAL_H
+
+#include <stdint.h>
+
+#include "job-control/job.h"
+
+#define SH_JOURNAL_MAGIC "SHJRNL01" /**< identifies a journal file */
+#define SH_JOURNAL_VERSION 1 /**< bumped whenever the record format changes */
+#define SH_JOURNAL_RECORDS 65536 /**< records held by a new journal */
+#define SH_JOURNAL_COMMAND_LEN 48 /**< bytes of command kept in a record */
+
+/**
+ * @brief Job lifecycle events.
+ */
+typedef enum {
+        JOURNAL_CREATED = 0, /**< job added to the job table */
+        JOURNAL_SPAWNED = 1, /**< job's process forked */
+        JOURNAL_STOPPED = 2, /**< foreground job stopped by a signal */
+        JOURNAL_CONTINUED = 3, /**< stopped foreground job resumed */
+        JOURNAL_REAPED = 4, /**< job's process reaped */
+        JOURNAL_COUNT = 5, /**< number of events */
+} SH_JournalEvent;
+
+/**
+ * @brief A @c JournalHeader starts a journal file, and is followed by its
+ * records.
+ */
+typedef struct {
+        char magic[8]; /**< @c SH_JOURNAL_MAGIC, without its terminator */
+        uint32_t version; /**< @c SH_JOURNAL_VERSION */
+        uint32_t record_size; /**< size of each record */
+        uint64_t capacity; /**< number of records the file holds */
+        uint64_t head; /**< records ever logged; next goes at head % capacity */
+        int64_t clock_offset; /**< realtime minus monotonic clock, in ns */
+        uint8_t reserved[24]; /**< pads header to 64 bytes */
+} SH_JournalHeader;
+
+/**
+ * @brief A @c JournalRecord holds a single job event.
+ */
+typedef struct {
+        uint64_t seq; /**< position in journal, counting from 0 */
+        uint64_t time; /**< monotonic time of event, in nanoseconds */
+        int32_t session; /**< PID of the shell that logged the event */
+        int32_t pid; /**< job's process PID, or 0 before it is spawned */
+        int32_t pgid; /**< job's PGID, or 0 before it is spawned */
+        int32_t status; /**< wait status once reaped, or stop signal */
+        uint16_t event; /**< @c SH_JournalEvent */
+        uint16_t background; /**< 1 if job runs in the background */
+        uint32_t spec; /**< job's position within job table */
+        int64_t utime_us; /**< user CPU time once reaped, in microseconds */
+        int64_t stime_us; /**< system CPU time once reaped, in microseconds */
+        int64_t maxrss_kb; /**< max RSS once reaped, in kilobytes */
+        int64_t nvcsw; /**< voluntary context switches once reaped */
+        int64_t nivcsw; /**< involuntary context switches once reaped */
+        char command[SH_JOURNAL_COMMAND_LEN]; /**< start of job's command */
+} SH_JournalRecord;
+
+/**
+ * @brief Opens the journal if the @c SMALLSH_JOURNAL environment variable is
+ * set.
+ *
+ * The variable's value names the journal file. An existing journal is
+ * appended to; anything else is replaced by a new, empty journal. Errors are
+ * reported on stderr, and leave the journal disabled.
+ */
+void SH_JournalInit(void);
+
+/**
+ * @brief Logs @p event for @p job, if the journal is open.
+ * @param event event that happened
+ * @param job job it happened to
+ * @param status wait status for @c JOURNAL_REAPED, signal for
+ * @c JOURNAL_STOPPED, 0 otherwise
+ */
+void SH_JournalLog(SH_JournalEvent event, SH_Job const *job, int status);
+
+/**
+ * @brief Closes the journal.
+ *
+ * Called on shell exit. Everything logged is already in the file by then.
+ */
+void SH_JournalShutdown(void);
+
+#endif //SMALLSH_JOURNAL_H
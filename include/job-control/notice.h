@@ -0,0 +1,80 @@
+/**
+ * @file notice.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Renders job notices, such as completed background jobs, for the
+ * user.
+ *
+ * Notices are formatted into a single buffer, and written out together with
+ * the next prompt in one system call, so that reporting on many jobs at once
+ * does not cost a write for each line of each of them.
+ */
+#ifndef SMALLSH_NOTICE_H
+#define SMALLSH_NOTICE_H
+
+#include <stddef.h>
+
+#include "job-control/job.h"
+
+#define SH_NOTICE_BUF_SIZE 16384 /**< bytes of notices buffered at most */
+
+/**
+ * @brief Formats notices can be rendered in.
+ */
+typedef enum {
+        NOTICE_TEXT, /**< tab-separated lines, for people */
+        NOTICE_JSON, /**< a JSON object per line, for programs */
+} SH_NoticeFormat;
+
+/**
+ * @brief Sets the format of all notices rendered from now on.
+ * @param format format to render notices in
+ */
+void SH_NoticeSetFormat(SH_NoticeFormat format);
+
+/**
+ * @brief Returns the format notices are rendered in.
+ * @return current notice format
+ */
+SH_NoticeFormat SH_NoticeGetFormat(void);
+
+/**
+ * @brief Sets the file notices are written to, stdout by default.
+ * @param fd file descriptor to write notices to
+ * @return file descriptor notices were written to until now
+ */
+int SH_NoticeSetFd(int fd);
+
+/**
+ * @brief Renders a notice that background @p job was started.
+ * @param job job that was started
+ */
+void SH_NoticeJobStarted(SH_Job const *job);
+
+/**
+ * @brief Renders a notice that background @p job was queued, rather than
+ * started.
+ * @param job job that was queued
+ */
+void SH_NoticeJobPending(SH_Job const *job);
+
+/**
+ * @brief Renders a notice that background @p job completed, with its status
+ * and the resources it used.
+ * @param job job that completed
+ * @param marker @c + for the last job, @c - for the second last, or @c 0
+ */
+void SH_NoticeJobDone(SH_Job const *job, char marker);
+
+/**
+ * @brief Writes out all rendered notices, followed by @p prompt, in a single
+ * @c writev to stdout, or the file set with @c SH_NoticeSetFd.
+ *
+ * Anything buffered by stdio is flushed first, to keep output in order.
+ * @param prompt prompt to write after the notices, or @c NULL for none
+ * @param len length of @p prompt
+ * @return 0 on success, -1 on failure
+ */
+int SH_NoticeFlush(char const *prompt, size_t len);
+
+#endif //SMALLSH_NOTICE_H
@@ -0,0 +1,79 @@
+/**
+ * @file prepare.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Speculative preparation of commands before they are launched.
+ *
+ * While a foreground job runs, the shell can get ahead on the setup of the
+ * commands likely to follow it: resolving their programs on PATH, warming the
+ * page cache for their binaries, and opening their input redirection files.
+ * Launching a prepared command then skips that work. Everything prepared is
+ * checked against the shell's current state before use, and discarded if the
+ * working directory, PATH, or the files involved have since changed.
+ */
+#ifndef SMALLSH_PREPARE_H
+#define SMALLSH_PREPARE_H
+
+#include <stddef.h>
+
+#define SH_PREPARE_CACHE_SIZE 32 /**< max commands tracked */
+#define SH_PREPARE_INPUTS 4 /**< max input files held open */
+#define SH_PREPARE_LIKELY 4 /**< number of frequent commands to prepare */
+
+/**
+ * @brief Resolves command @p name on PATH, and advises the kernel that its
+ * binary will be read soon.
+ * @param name command name, as typed
+ */
+void SH_PrepareCommand(char const *name);
+
+/**
+ * @brief Prepares the most frequently run commands that have not yet been
+ * prepared.
+ *
+ * This is used when the next command is not known, as in interactive mode.
+ */
+void SH_PrepareLikely(void);
+
+/**
+ * @brief Counts a run of command @p name towards its frequency.
+ * @param name command name, as typed
+ */
+void SH_PrepareRecord(char const *name);
+
+/**
+ * @brief Returns the resolved path of command @p name, if it was prepared.
+ * @param name command name, as typed
+ * @return path to program, or @c NULL if not prepared or no longer valid
+ */
+char const *SH_PrepareLookup(char const *name);
+
+/**
+ * @brief Opens input redirection file @p file ahead of its command.
+ *
+ * Only regular files are opened, since opening anything else may block or
+ * have side effects.
+ * @param file input filename, as typed
+ */
+void SH_PrepareInput(char const *file);
+
+/**
+ * @brief Takes ownership of the descriptor opened for input file @p file.
+ *
+ * The descriptor is only handed out if @p file still names the same file it
+ * was opened as, and the working directory has not changed since.
+ * @param file input filename, as typed
+ * @return close-on-exec descriptor open for reading at offset 0, or -1 if
+ * none is available
+ */
+int SH_PrepareTakeInput(char const *file);
+
+/**
+ * @brief Discards everything prepared so far.
+ *
+ * Must be called whenever the working directory changes, since relative names
+ * may now refer to different files.
+ */
+void SH_PrepareInvalidate(void);
+
+#endif //SMALLSH_PREPARE_H
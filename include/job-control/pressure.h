@@ -0,0 +1,67 @@
+/**
+ * @file pressure.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Holding back background jobs while the machine is under pressure.
+ *
+ * A fixed cap on running jobs cannot tell an idle machine from a saturated
+ * one. With pressure thresholds set, background jobs are only started while
+ * the kernel's pressure stall information (or, without it, the load average)
+ * stays under them, and are otherwise left pending, to be looked at again
+ * every @c SH_PRESSURE_INTERVAL.
+ */
+#ifndef SMALLSH_PRESSURE_H
+#define SMALLSH_PRESSURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SH_PRESSURE_INTERVAL 500000000 /**< ns between checks of pending jobs */
+#define SH_PRESSURE_MAX_PSI 100 /**< highest PSI threshold, in percent */
+#define SH_PRESSURE_MAX_LOAD 1000 /**< highest load threshold, per CPU */
+
+/**
+ * @brief A @c Pressure object holds the thresholds over which background jobs
+ * are held back. A threshold of 0 is not checked.
+ */
+typedef struct {
+        double cpu; /**< percent of time some task waited for a CPU */
+        double io; /**< percent of time some task waited for I/O */
+        double memory; /**< percent of time some task waited for memory */
+        double load; /**< 1-minute load average per online CPU */
+} SH_Pressure;
+
+/**
+ * @brief Returns the thresholds background jobs are held back over.
+ * @return current thresholds, all 0 by default
+ */
+SH_Pressure SH_PressureGet(void);
+
+/**
+ * @brief Sets the thresholds background jobs are held back over from now on.
+ * @param pressure new thresholds
+ */
+void SH_PressureSet(SH_Pressure const *pressure);
+
+/**
+ * @brief Returns whether or not any threshold is set.
+ * @return true if background jobs may be held back, false otherwise
+ */
+bool SH_PressureEnabled(void);
+
+/**
+ * @brief Returns whether or not another background job may be started now.
+ *
+ * Pressure is averaged over 10 seconds, so jobs started in a burst would all
+ * get in before any of them shows. To give it time to, no more jobs than
+ * there are CPUs are started per @c SH_PRESSURE_INTERVAL.
+ * @return true if no threshold is exceeded, false otherwise
+ */
+bool SH_PressureAllowLaunch(void);
+
+/**
+ * @brief Counts a background job just started against this interval's share.
+ */
+void SH_PressureNoteLaunch(void);
+
+#endif //SMALLSH_PRESSURE_H
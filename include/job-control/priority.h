@@ -0,0 +1,91 @@
+/**
+ * @file priority.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Scheduling policy for background jobs.
+ *
+ * Background jobs run at a lower CPU and I/O priority than the foreground
+ * command the user is waiting on, so that interactive latency holds up even
+ * when the machine is saturated with batch work. Optionally, background jobs
+ * that keep a CPU busy are stopped outright while a foreground job runs.
+ */
+#ifndef SMALLSH_PRIORITY_H
+#define SMALLSH_PRIORITY_H
+
+#include <stdbool.h>
+
+#include "job-control/job-table.h"
+
+#define SH_PRIORITY_MAX_NICE 19 /**< highest niceness */
+#define SH_PRIORITY_HEAVY_CPU 50 /**< CPU use, in percent, of a heavy job */
+
+/**
+ * @brief I/O scheduling classes background jobs can run in.
+ */
+typedef enum {
+        PRIORITY_IO_NONE, /**< as inherited from the shell */
+        PRIORITY_IO_BEST_EFFORT, /**< best-effort, at its lowest level */
+        PRIORITY_IO_IDLE, /**< only when no other process does I/O */
+} SH_PriorityIO;
+
+/**
+ * @brief CPU scheduling policies background jobs can run under.
+ */
+typedef enum {
+        PRIORITY_SCHED_OTHER, /**< as inherited from the shell */
+        PRIORITY_SCHED_BATCH, /**< SCHED_BATCH, for CPU-bound work */
+        PRIORITY_SCHED_IDLE, /**< SCHED_IDLE, only when a CPU is idle */
+} SH_PrioritySched;
+
+/**
+ * @brief A @c Priority object holds the scheduling policy background jobs
+ * are started under.
+ */
+typedef struct {
+        int nice; /**< niceness added to the shell's own */
+        SH_PriorityIO io; /**< I/O scheduling class */
+        SH_PrioritySched sched; /**< CPU scheduling policy */
+        bool stop_heavy; /**< whether to stop heavy jobs during foreground ones */
+} SH_Priority;
+
+/**
+ * @brief Returns the policy background jobs are started under.
+ *
+ * By default, they run 10 nice levels below the shell, and at the lowest
+ * best-effort I/O level.
+ * @return current policy
+ */
+SH_Priority SH_PriorityGet(void);
+
+/**
+ * @brief Sets the policy background jobs are started under from now on.
+ * @param priority new policy
+ */
+void SH_PrioritySet(SH_Priority const *priority);
+
+/**
+ * @brief Applies the background job policy to the calling process.
+ *
+ * This is meant to be called by a forked child, right before exec. Failures
+ * are ignored: the job still runs, only at the shell's own priority.
+ */
+void SH_PriorityApply(void);
+
+/**
+ * @brief Stops the process group of every running background job in @p table
+ * that is CPU-heavy, if the policy asks for it.
+ *
+ * A job is heavy if it has used at least @c SH_PRIORITY_HEAVY_CPU percent of
+ * a CPU on average since it was started. This is meant to be called when a
+ * foreground job starts.
+ * @param table JobTable object
+ */
+void SH_PriorityPauseBackground(SH_JobTable *table);
+
+/**
+ * @brief Continues the jobs stopped by @c SH_PriorityPauseBackground.
+ * @param table JobTable object
+ */
+void SH_PriorityResumeBackground(SH_JobTable *table);
+
+#endif //SMALLSH_PRIORITY_H
@@ -12,16 +12,24 @@
 #define SMALLSH_PROCESS_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 
+#include "job-control/redirect.h"
+
 /**
  * @brief A Process object holds information related to running a program.
  */
 typedef struct {
         char **args; /**< process arguments */
+        char *path; /**< resolved program path, or NULL to search PATH */
         pid_t pid; /**< process PID */
         bool has_completed; /**< process completion SH_status */
         int status; /**< process exit SH_status */
+        struct rusage usage; /**< resources used, as reaped or last sampled */
+        uint64_t started; /**< monotonic start time, in nanoseconds */
+        uint64_t finished; /**< monotonic completion time, in nanoseconds */
 } SH_Process;
 
 /**
@@ -38,15 +46,58 @@ SH_Process *SH_CreateProcess(size_t n_args, char **args);
  */
 void SH_DestroyProcess(SH_Process *proc);
 
+/**
+ * @brief Marks @p proc as completed, with the resources it used.
+ * @param proc process that completed
+ * @param status wait status it was reaped with
+ * @param usage resources it used, or @c NULL if unknown
+ * @param finished monotonic time it was reaped at, in nanoseconds
+ */
+void SH_ProcessComplete(SH_Process *proc, int status,
+                        struct rusage const *usage, uint64_t finished);
+
+/**
+ * @brief Samples the resources @p proc has used so far from @c /proc, for a
+ * process that is still running.
+ *
+ * CPU times, max RSS, and context switch counts are stored into the
+ * process's @c usage.
+ * @param proc running process
+ * @return 0 on success, -1 if the process could not be sampled
+ */
+int SH_ProcessSampleUsage(SH_Process *proc);
+
+/**
+ * @brief Formats the wall time, CPU times, max RSS, and context switches of
+ * @p proc into @p buf, as a single line without a trailing newline.
+ *
+ * Wall time runs up to now for a process that is still running.
+ * @param proc process to format usage of
+ * @param buf buffer to format into
+ * @param size size of @p buf
+ * @return length of the formatted usage, as by @c snprintf
+ */
+int SH_ProcessFormatUsage(SH_Process const *proc, char *buf, size_t size);
+
+/**
+ * @brief Returns the wall time of @p proc, in nanoseconds.
+ *
+ * Wall time runs up to now for a process that is still running.
+ * @param proc process to return wall time of
+ * @return nanoseconds since @p proc started, until it completed
+ */
+uint64_t SH_ProcessWallTime(SH_Process const *proc);
+
 /**
  * @brief Launches a new process.
  * @param proc process to launch
  * @param pgid process PGID
- * @param infile STDIN file stream
- * @param outfile STDOUT file stream
+ * @param redirs redirections opened for process by the shell
  * @param foreground whether or not the process is to run in the foreground
+ * @param background whether or not the process is a background job, to run
+ * under the background scheduling policy
  */
-void SH_LaunchProcess(SH_Process *proc, pid_t pgid, char *infile, char *outfile,
-                      bool foreground);
+void SH_LaunchProcess(SH_Process *proc, pid_t pgid, SH_Redirs const *redirs,
+                      bool foreground, bool background);
 
 #endif //SMALLSH_PROCESS_H
@@ -0,0 +1,101 @@
+/**
+ * @file redirect.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For opening a command's io redirections, and installing them.
+ *
+ * Redirection files are opened by the shell itself, before the command is
+ * forked, so that a missing or unwritable file is reported without paying for
+ * a fork, and the child is left with nothing to do but install the opened
+ * descriptors over its standard streams and exec.
+ */
+#ifndef SMALLSH_REDIRECT_H
+#define SMALLSH_REDIRECT_H
+
+#include <stdbool.h>
+
+#include "interpreter/statement.h"
+
+#define SH_REDIRS_STDOUT (-2) /**< stderr follows the child's own stdout */
+
+/**
+ * @brief A @c Redirs object holds the descriptors to install over a command's
+ * stdin, stdout, and stderr.
+ *
+ * A descriptor of -1 leaves the stream as inherited from the shell. All other
+ * descriptors are close-on-exec, and numbered above the standard streams.
+ */
+typedef struct {
+        int fds[3]; /**< descriptor for each standard stream, or -1 */
+} SH_Redirs;
+
+/**
+ * @brief Initializes @p redirs to leave every stream as inherited.
+ * @param redirs @c Redirs object to initialize
+ */
+void SH_RedirsInit(SH_Redirs *redirs);
+
+/**
+ * @brief Opens the redirections of a statement, in the order they were given.
+ *
+ * Output files are created with mode @c -rw-rw----. When @p background is
+ * set, stdin and stdout default to @c /dev/null, whose descriptor is opened
+ * once and shared by every background command. Errors are reported on stderr.
+ * @param redirs @c Redirs object to open descriptors into
+ * @param in statement's stdin redirections
+ * @param out statement's stdout and stderr redirections
+ * @param background whether or not the command will run in the background
+ * @return 0 on success, -1 on failure, with nothing left open
+ */
+int SH_RedirsOpen(SH_Redirs *redirs, StmtStdin const *in,
+                  StmtStdout const *out, bool background);
+
+/**
+ * @brief Redirects @p stream to the shared @c /dev/null descriptor, unless it
+ * is already redirected.
+ * @param redirs @c Redirs object to update
+ * @param stream standard stream to redirect
+ * @return 0 on success, -1 on failure
+ */
+int SH_RedirsNull(SH_Redirs *redirs, int stream);
+
+/**
+ * @brief Redirects every stream that @p redirs leaves as inherited to a copy
+ * of @p from's descriptor for it.
+ *
+ * This lets many commands share redirections that were opened only once.
+ * @param redirs @c Redirs object to update
+ * @param from @c Redirs object to copy descriptors from
+ * @return 0 on success, -1 on failure
+ */
+int SH_RedirsInherit(SH_Redirs *redirs, SH_Redirs const *from);
+
+/**
+ * @brief Redirects the output streams of a background command that were left
+ * to their defaults (stdout to @c /dev/null, stderr inherited) to @p fd.
+ *
+ * On success, @p redirs owns @p fd, and closes it with the rest.
+ * @param redirs @c Redirs object opened by @c SH_RedirsOpen for a background
+ * command
+ * @param fd descriptor to write output to
+ * @return 0 if any stream was redirected, -1 if both were redirected by the
+ * user or on failure, and @p fd was left alone
+ */
+int SH_RedirsCapture(SH_Redirs *redirs, int fd);
+
+/**
+ * @brief Installs @p redirs over the calling process's standard streams.
+ *
+ * This is meant to be called by a forked child, right before exec.
+ * @param redirs @c Redirs object opened by @c SH_RedirsOpen
+ * @return 0 on success, -1 on failure
+ */
+int SH_RedirsApply(SH_Redirs const *redirs);
+
+/**
+ * @brief Closes the descriptors held by @p redirs, and resets it.
+ * @param redirs @c Redirs object to close
+ */
+void SH_RedirsClose(SH_Redirs *redirs);
+
+#endif //SMALLSH_REDIRECT_H
@@ -0,0 +1,82 @@
+/**
+ * @file rlimits.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Resource limits applied to jobs as they are spawned.
+ *
+ * Limits set with @c ulimit are kept by the shell, rather than applied to it,
+ * so that a memory cap meant for jobs cannot starve the shell itself. Each job
+ * takes a copy of them when created, and applies it in its child before exec.
+ */
+#ifndef SMALLSH_RLIMITS_H
+#define SMALLSH_RLIMITS_H
+
+#include <sys/resource.h>
+
+/**
+ * @brief A @c Limits object holds a soft and hard limit for each resource,
+ * of which only those set are applied.
+ */
+typedef struct {
+        struct rlimit values[RLIM_NLIMITS]; /**< limits, by resource */
+        unsigned set; /**< bitmap of resources with a limit in @c values */
+} SH_Limits;
+
+/**
+ * @brief Initializes @p limits with no limit set.
+ * @param limits @c Limits object to initialize
+ */
+void SH_LimitsInit(SH_Limits *limits);
+
+/**
+ * @brief Returns the limits kept by the shell, for @c ulimit to change.
+ * @return shell's @c Limits object
+ */
+SH_Limits *SH_LimitsShell(void);
+
+/**
+ * @brief Overrides the shell's limits with @p limits for every job created
+ * until it is called again with @c NULL.
+ * @param limits limits to use instead, or @c NULL to use the shell's
+ */
+void SH_LimitsSetCommand(SH_Limits const *limits);
+
+/**
+ * @brief Copies the limits a job created now is to run with into @p limits.
+ * @param limits output param for limits
+ */
+void SH_LimitsCurrent(SH_Limits *limits);
+
+/**
+ * @brief Gets the limit of @p resource in @p limits, or the shell's own if
+ * none is set.
+ * @param limits @c Limits object
+ * @param resource @c RLIMIT_ constant
+ * @param value output param for limit
+ * @return 0 on success, -1 with errno set on failure
+ */
+int SH_LimitsGet(SH_Limits const *limits, int resource, struct rlimit *value);
+
+/**
+ * @brief Sets the limit of @p resource in @p limits.
+ *
+ * Limits are checked here, as far as they can be without applying them, so
+ * that a job is not spawned just to fail: the soft limit may not exceed the
+ * hard one, and only root may raise the hard limit above the shell's.
+ * @param limits @c Limits object
+ * @param resource @c RLIMIT_ constant
+ * @param value new limit
+ * @return 0 on success, -1 with errno set to @c EINVAL or @c EPERM on failure
+ */
+int SH_LimitsSet(SH_Limits *limits, int resource, struct rlimit const *value);
+
+/**
+ * @brief Applies every limit set in @p limits to the calling process.
+ *
+ * This is meant to be called by a forked child, right before exec.
+ * @param limits @c Limits object
+ * @return 0 on success, -1 with errno set on failure
+ */
+int SH_LimitsApply(SH_Limits const *limits);
+
+#endif //SMALLSH_RLIMITS_H
@@ -40,6 +40,16 @@ void SH_HandlerEnableFgOnlyMode(int sig);
  */
 void SH_HandlerHandleSigchld(int sig);
 
+/**
+ * @brief Handles a SIGTERM, SIGINT or SIGHUP signal in init mode.
+ *
+ * Forwards the signal to the foreground job's process group, if any, and
+ * relays it over its channel, for the shell to forward to background jobs
+ * once it is back in its event loop, and then terminate.
+ * @param sig signal received
+ */
+void SH_HandlerForwardSignal(int sig);
+
 /**
  * @brief Switches SIGTSTP mask to enable fg_only_mode on next receipt.
  *
@@ -32,4 +32,10 @@ void SH_InstallerInstallSigchldHandler(void);
  */
 void SH_InstallerInstallSigtstpHandler(void);
 
+/**
+ * @brief Installs handlers forwarding SIGTERM, SIGINT and SIGHUP to jobs, for
+ * the shell's init mode.
+ */
+void SH_InstallerInstallForwardSignals(void);
+
 #endif //SMALLSH_INSTALLER_H
@@ -0,0 +1,119 @@
+/**
+ * @file trace.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For recording per-phase command latencies.
+ *
+ * Timestamps are recorded into a fixed-size in-memory ring, which can later be
+ * exported in the Chrome trace-event format (viewable in chrome://tracing or
+ * Perfetto). When tracing is disabled, each trace point costs a single branch.
+ */
+#ifndef SMALLSH_TRACE_H
+#define SMALLSH_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#define SH_TRACE_RING_SIZE 4096 /**< maximum number of events retained */
+
+/**
+ * @brief Begins timing a phase, returning its start timestamp.
+ */
+#define SH_TRACE_BEGIN() (smallsh_trace_enabled ? SH_TraceNow() : 0)
+
+/**
+ * @brief Ends timing a phase that began at @p start, recording the event.
+ *
+ * Phases that began while tracing was off, such as the one turning it on, are
+ * not recorded.
+ */
+#define SH_TRACE_END(phase, pid, start)                                        \
+        do {                                                                   \
+                if (smallsh_trace_enabled && (start) != 0) {                   \
+                        SH_TraceRecord((phase), (pid), (start), SH_TraceNow());\
+                }                                                              \
+        } while (0)
+
+/**
+ * @brief Phases of evaluating a command.
+ */
+typedef enum {
+        TRACE_EVAL = 0, /**< evaluating a complete command */
+        TRACE_READ = 1, /**< reading a command */
+        TRACE_LEX = 2, /**< tokenizing a command */
+        TRACE_PARSE = 3, /**< parsing tokens into statements */
+        TRACE_EXPAND = 4, /**< expanding a word */
+        TRACE_SPAWN = 5, /**< forking a child process */
+        TRACE_EXEC = 6, /**< child process setup until exec */
+        TRACE_WAIT = 7, /**< waiting on a foreground job */
+        TRACE_REAP = 8, /**< consuming reaped child statuses */
+        TRACE_NOTIFY = 9, /**< notifying user of job events */
+        TRACE_COUNT = 10, /**< number of phases */
+} SH_TracePhase;
+
+/**
+ * @brief A @c TraceEvent records a single timed phase.
+ */
+typedef struct {
+        SH_TracePhase phase; /**< phase that was timed */
+        pid_t pid; /**< child PID the phase relates to, or 0 */
+        uint64_t start; /**< start timestamp in nanoseconds */
+        uint64_t end; /**< end timestamp in nanoseconds */
+} SH_TraceEvent;
+
+extern bool smallsh_trace_enabled; /**< whether or not tracing is enabled */
+
+/**
+ * @brief Discards all recorded events.
+ */
+void SH_TraceClear(void);
+
+/**
+ * @brief Writes all recorded events to @p stream as Chrome trace-event JSON.
+ * @param stream stream to write to
+ * @return 0 on success, -1 on failure
+ */
+int SH_TraceDump(FILE *stream);
+
+/**
+ * @brief Writes all recorded events to the file at @p path as Chrome
+ * trace-event JSON, replacing any existing contents.
+ * @param path file to write to
+ * @return 0 on success, -1 on failure
+ */
+int SH_TraceDumpFile(char const *path);
+
+/**
+ * @brief Enables tracing if the @c SMALLSH_TRACE environment variable is set.
+ *
+ * The variable's value names the file that the trace is written to on exit.
+ */
+void SH_TraceInit(void);
+
+/**
+ * @brief Returns the current monotonic time.
+ * @return monotonic time in nanoseconds
+ */
+uint64_t SH_TraceNow(void);
+
+/**
+ * @brief Records an event into the trace ring, overwriting the oldest event
+ * once the ring is full.
+ * @param phase phase that was timed
+ * @param pid child PID the phase relates to, or 0
+ * @param start start timestamp in nanoseconds
+ * @param end end timestamp in nanoseconds
+ */
+void SH_TraceRecord(SH_TracePhase phase, pid_t pid, uint64_t start,
+                    uint64_t end);
+
+/**
+ * @brief Writes the trace to the file named by @c SMALLSH_TRACE, if set.
+ *
+ * Called on shell exit.
+ */
+void SH_TraceShutdown(void);
+
+#endif //SMALLSH_TRACE_H
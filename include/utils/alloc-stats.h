@@ -0,0 +1,61 @@
+/**
+ * @file alloc-stats.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For counting heap allocations made while evaluating commands.
+ *
+ * When the shell is built with the @c SMALLSH_ALLOC_STATS CMake option, calls
+ * to malloc, calloc, realloc, strdup, strndup and free made by the shell's own
+ * code are interposed at link time (@c -Wl,--wrap) and counted. Allocations
+ * made internally by libc, such as by getline, are not counted.
+ */
+#ifndef SMALLSH_ALLOC_STATS_H
+#define SMALLSH_ALLOC_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Heap operation counts.
+ */
+typedef struct {
+        size_t n_allocs; /**< number of allocations, including reallocs */
+        size_t n_frees; /**< number of frees, including reallocs */
+        size_t n_bytes; /**< number of bytes requested */
+} SH_AllocStats;
+
+extern bool smallsh_alloc_stats_enabled; /**< whether or not to report counts */
+
+/**
+ * @brief Returns whether or not allocations are being counted in this build.
+ * @return @c true if built with @c SMALLSH_ALLOC_STATS, @c false otherwise
+ */
+bool SH_AllocStatsAvailable(void);
+
+/**
+ * @brief Copies the counts accumulated since the last reset into @p stats.
+ * @param stats @c AllocStats object to copy counts into
+ */
+void SH_AllocStatsGet(SH_AllocStats *stats);
+
+/**
+ * @brief Enables per-command reporting if the @c SMALLSH_ALLOC_STATS
+ * environment variable is set to a non-empty value other than "0".
+ */
+void SH_AllocStatsInit(void);
+
+/**
+ * @brief Writes the counts accumulated since the last reset to @p stream as a
+ * single line, labelled with @p cmd.
+ * @param stream stream to write to
+ * @param cmd command the counts belong to
+ */
+void SH_AllocStatsReport(FILE *stream, char const *cmd);
+
+/**
+ * @brief Zeroes all counts.
+ */
+void SH_AllocStatsReset(void);
+
+#endif //SMALLSH_ALLOC_STATS_H
@@ -0,0 +1,72 @@
+/**
+ * @file buffer.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Growable byte buffer.
+ *
+ * This is a utility module for accumulating bytes of unknown length, such as
+ * the output of a child process. Data can be read from a file descriptor
+ * straight into the buffer's spare capacity, so that no intermediate copies
+ * are needed.
+ */
+#ifndef SMALLSH_BUFFER_H
+#define SMALLSH_BUFFER_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/**
+ * @brief A @c Buffer object holds a heap-allocated array of bytes, along with
+ * its used length and allocated capacity.
+ *
+ * The structure is public so that callers may wrap an existing heap string in
+ * a stack-allocated @c Buffer and grow it in place.
+ */
+typedef struct {
+        char *data; /**< heap-allocated byte array */
+        size_t len; /**< number of bytes in use */
+        size_t cap; /**< number of bytes allocated */
+} SH_Buffer;
+
+/**
+ * @brief Initializes a new @c Buffer object.
+ * @param cap initial capacity in bytes
+ * @return new @c Buffer object on success, @c NULL on failure
+ */
+SH_Buffer *SH_CreateBuffer(size_t cap);
+
+/**
+ * @brief Frees @p buf and its data.
+ * @param buf @c Buffer object to destroy
+ */
+void SH_DestroyBuffer(SH_Buffer **buf);
+
+/**
+ * @brief Appends @p n bytes from @p data to the end of @p buf.
+ * @param buf @c Buffer object
+ * @param data bytes to append
+ * @param n number of bytes to append
+ * @return 0 on success, -1 on failure
+ */
+int SH_BufferAppend(SH_Buffer *buf, char const *data, size_t n);
+
+/**
+ * @brief Reads from @p fd into @p buf until end of file is reached.
+ *
+ * Bytes are read directly into the buffer's spare capacity, which is doubled
+ * whenever it runs out.
+ * @param buf @c Buffer object
+ * @param fd file descriptor to read from
+ * @return number of bytes read on success, -1 on failure
+ */
+ssize_t SH_BufferReadFd(SH_Buffer *buf, int fd);
+
+/**
+ * @brief Ensures @p buf can hold at least @p n more bytes without growing.
+ * @param buf @c Buffer object
+ * @param n number of spare bytes required
+ * @return 0 on success, -1 on failure
+ */
+int SH_BufferReserve(SH_Buffer *buf, size_t n);
+
+#endif //SMALLSH_BUFFER_H
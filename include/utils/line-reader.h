@@ -0,0 +1,80 @@
+/**
+ * @file line-reader.h
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Buffered reader for newline-terminated input lines.
+ *
+ * This is a utility module for reading commands from a file descriptor. Input
+ * is read in large chunks into a single reusable buffer, and each line is
+ * handed out as a view into that buffer, so that reading a line costs no
+ * allocations and, for batch input, rarely a system call.
+ */
+#ifndef SMALLSH_LINE_READER_H
+#define SMALLSH_LINE_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "utils/buffer.h"
+
+#define SH_LINE_READER_CHUNK 65536 /**< default number of bytes to read at once */
+
+/**
+ * @brief Function a @c LineReader reads input with, as @c read(2).
+ */
+typedef ssize_t (*SH_LineReaderReadFn)(int fd, void *buf, size_t count);
+
+/**
+ * @brief A @c LineReader object splits the bytes read from a file descriptor
+ * into lines.
+ */
+typedef struct {
+        int fd; /**< file descriptor to read from */
+        SH_LineReaderReadFn read_fn; /**< function to read fd with */
+        SH_Buffer *buf; /**< bytes read but not yet consumed */
+        size_t start; /**< offset of next line within buf */
+        size_t scan; /**< offset to resume newline search from */
+        size_t held_at; /**< offset of byte overwritten by last line's NUL */
+        char held; /**< byte overwritten by last line's NUL */
+        bool eof; /**< whether or not fd has reached end of file */
+} SH_LineReader;
+
+/**
+ * @brief Initializes a new @c LineReader object.
+ * @param fd file descriptor to read from
+ * @param cap initial buffer capacity in bytes, or 0 for the default
+ * @return new @c LineReader object on success, @c NULL on failure
+ */
+SH_LineReader *SH_CreateLineReader(int fd, size_t cap);
+
+/**
+ * @brief Frees @p reader and its buffer.
+ * @param reader @c LineReader object to destroy
+ */
+void SH_DestroyLineReader(SH_LineReader **reader);
+
+/**
+ * @brief Makes @p reader read its input with @p read_fn instead of @c read(2).
+ * @param reader @c LineReader object
+ * @param read_fn function to read with
+ */
+void SH_LineReaderSetRead(SH_LineReader *reader, SH_LineReaderReadFn read_fn);
+
+/**
+ * @brief Returns the next line of input.
+ *
+ * <br>
+ *
+ * The line is a view into the reader's buffer: it always ends in a newline
+ * followed by a NUL terminator, and remains valid until the next call. A final
+ * line without a trailing newline has one added. Lines longer than the buffer
+ * grow it by doubling.
+ * @param reader @c LineReader object
+ * @param line output param for start of line
+ * @return length of line including its newline, 0 at end of input, or -1 on
+ * failure
+ */
+ssize_t SH_LineReaderNext(SH_LineReader *reader, char **line);
+
+#endif //SMALLSH_LINE_READER_H
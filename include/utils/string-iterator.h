@@ -30,9 +30,9 @@ typedef struct {
  *
  * Source: https://www.state-machine.com/doc/AN_OOP_in_C.pdf*
  * @param str the string to iterate over
- * @note A copy is made of @p string, so the caller can free/overwrite the
- * string safely after calling this constructor. Note this also means the
- * caller must destroy the data via calling the @c SH_DestroyStringIterator function.
+ * @note No copy is made of @p str, so the caller must keep it alive and
+ * unmodified until the iterator is destroyed via calling the
+ * @c SH_DestroyStringIterator function.
  */
 SH_StringIterator *SH_CreateStringIterator(char *str);
 
@@ -63,6 +63,7 @@ char *SH_StringIteratorConsumeChar(SH_StringIterator *iter);
  * <br>
  *
  * A word is any sequence of characters, excluding a space character.
+ * Whitespace within a command substitution ("$(...)") does not end the word.
  *
  * <br><br>
  *
@@ -8,6 +8,8 @@
 #include <string.h>
 
 #include "builtins/builtins.h"
+#include "globals.h"
+#include "job-control/rlimits.h"
 /* *****************************************************************************
  * PRIVATE DEFINITIONS
  *
@@ -45,6 +47,14 @@ enum {
         BUILTINS_CD, /**< cd command */
         BUILTINS_EXIT, /**< exit command */
         BUILTINS_STATUS, /**< status command */
+        BUILTINS_TRACE, /**< trace command */
+        BUILTINS_PARALLEL, /**< parallel command */
+        BUILTINS_SET, /**< set command */
+        BUILTINS_JOBS, /**< jobs command */
+        BUILTINS_TIME, /**< time command */
+        BUILTINS_PIN, /**< pin command */
+        BUILTINS_ULIMIT, /**< ulimit command */
+        BUILTINS_JOBLOG, /**< joblog command */
         BUILTINS_COUNT, /**< number of supported builtins */
 };
 
@@ -55,7 +65,108 @@ static const char * const BUILTINS[] = {
         [BUILTINS_CD] = "cd",
         [BUILTINS_EXIT] = "exit",
         [BUILTINS_STATUS] = "status",
+        [BUILTINS_TRACE] = "trace",
+        [BUILTINS_PARALLEL] = "parallel",
+        [BUILTINS_SET] = "set",
+        [BUILTINS_JOBS] = "jobs",
+        [BUILTINS_TIME] = "time",
+        [BUILTINS_PIN] = "pin",
+        [BUILTINS_ULIMIT] = "ulimit",
+        [BUILTINS_JOBLOG] = "joblog",
 };
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Executes the words of @p stmt from @p first on as a statement of
+ * their own.
+ * @param stmt @c Statement object
+ * @param cmd command text the statement was parsed from
+ * @param first index of the word to run as the command
+ * @param exec runs the statement
+ * @return status of the statement run
+ */
+static int SH_BuiltinExecTail(SH_Statement *stmt, char *cmd, size_t first,
+                              SH_BuiltinExecFn exec)
+{
+        StmtCmd tail_cmd;
+        SH_Statement tail;
+
+        tail_cmd.count = stmt->cmd->count - first;
+        tail_cmd.args = stmt->cmd->args + first;
+
+        tail = *stmt;
+        tail.cmd = &tail_cmd;
+        tail.flags &= ~FLAGS_BUILTIN;
+        if (SH_IsBuiltin(tail_cmd.args[0])) {
+                tail.flags |= FLAGS_BUILTIN;
+        }
+
+        return exec(&tail, cmd);
+}
+
+/**
+ * @brief Executes the statement following a @c time builtin, and reports how
+ * long it took.
+ * @param stmt @c Statement object whose command starts with @c time
+ * @param cmd command text the statement was parsed from
+ * @param exec runs the timed statement
+ * @return status of the timed statement
+ */
+static int SH_BuiltinExecTimed(SH_Statement *stmt, char *cmd,
+                               SH_BuiltinExecFn exec)
+{
+        int status_;
+        SH_Timer timer;
+
+        SH_TimerStart(&timer, smallsh_stmt_begin);
+
+        /* Run the rest of the statement as a statement of its own. */
+        status_ = 0;
+        if (stmt->cmd->count > 1) {
+                status_ = SH_BuiltinExecTail(stmt, cmd, 1, exec);
+        }
+
+        SH_TimerReport(&timer);
+
+        return status_;
+}
+
+/**
+ * @brief Runs a @c ulimit builtin, and the command following its options, if
+ * any, with the limits it gave.
+ * @param stmt @c Statement object whose command starts with @c ulimit
+ * @param cmd command text the statement was parsed from
+ * @param exec runs the limited statement
+ * @return status of the limited statement
+ */
+static int SH_BuiltinExecLimited(SH_Statement *stmt, char *cmd,
+                                 SH_BuiltinExecFn exec)
+{
+        int status_;
+        SH_Limits limits;
+        size_t first;
+
+        first = SH_ulimit(stmt->cmd->count, stmt->cmd->args, &limits);
+        if (first >= stmt->cmd->count) {
+                return 0;
+        }
+
+        /* Jobs the command creates take these limits, and no others do. */
+        SH_LimitsSetCommand(&limits);
+        status_ = SH_BuiltinExecTail(stmt, cmd, first, exec);
+        SH_LimitsSetCommand(NULL);
+
+        return status_;
+}
+
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -97,3 +208,61 @@ bool SH_IsBuiltin(char const * const cmd)
 
         return false;
 }
+
+bool SH_BuiltinChangesShell(char const * const cmd)
+{
+        return strcmp("cd", cmd) == 0 || strcmp("set", cmd) == 0
+               || strcmp("exit", cmd) == 0;
+}
+
+int SH_RunBuiltin(SH_Statement *stmt, char *cmd, SH_BuiltinExecFn exec)
+{
+        int status_;
+        char *cmd_name;
+
+        /* Determine builtin name and run it. */
+        cmd_name = stmt->cmd->args[0];
+        if (strcmp("exit", cmd_name) == 0) {
+                status_ = 1;
+                smallsh_line_buffer = true;
+        } else if (strcmp("cd", cmd_name) == 0) {
+                char *dirname = stmt->cmd->args[1];
+                SH_cd(dirname);
+                status_ = 0;
+                smallsh_line_buffer = true;
+        } else if (strcmp("status", cmd_name) == 0) {
+                SH_status();
+                status_ = 0;
+        } else if (strcmp("trace", cmd_name) == 0) {
+                char *action = stmt->cmd->args[1];
+                char *filename = stmt->cmd->count > 2
+                        ? stmt->cmd->args[2] : NULL;
+                SH_trace(action, filename);
+                status_ = 0;
+        } else if (strcmp("parallel", cmd_name) == 0) {
+                SH_parallel(stmt->cmd->count, stmt->cmd->args,
+                            stmt->infile, stmt->outfile);
+                status_ = 0;
+        } else if (strcmp("set", cmd_name) == 0) {
+                SH_set(stmt->cmd->count, stmt->cmd->args);
+                status_ = 0;
+        } else if (strcmp("jobs", cmd_name) == 0) {
+                SH_jobs(stmt->cmd->count, stmt->cmd->args);
+                status_ = 0;
+        } else if (strcmp("joblog", cmd_name) == 0) {
+                SH_joblog(stmt->cmd->count, stmt->cmd->args);
+                status_ = 0;
+        } else if (strcmp("pin", cmd_name) == 0) {
+                SH_pin(stmt->cmd->count, stmt->cmd->args);
+                status_ = 0;
+        } else if (strcmp("time", cmd_name) == 0) {
+                status_ = SH_BuiltinExecTimed(stmt, cmd, exec);
+        } else if (strcmp("ulimit", cmd_name) == 0) {
+                status_ = SH_BuiltinExecLimited(stmt, cmd, exec);
+        } else {
+                /* Error */
+                status_ = -1;
+        }
+
+        return status_;
+}
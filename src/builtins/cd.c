@@ -11,6 +11,7 @@
 #include <unistd.h>
 
 #include "builtins/cd.h"
+#include "job-control/prepare.h"
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -64,5 +65,9 @@ void SH_cd(char const * const dirname)
                 /* Couldn't cd into directory. */
                 fprintf(stderr, "-smallsh: cd: %s: %s\n", dir, strerror(errno));
                 fflush(stderr);
+                return;
         }
+
+        /* Relative names prepared ahead of time now point elsewhere. */
+        SH_PrepareInvalidate();
 }
@@ -4,6 +4,8 @@
  * @date 04 Feb 2022
  * @brief exit builtin command.
  */
+#include <signal.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 
@@ -11,6 +13,107 @@
 #include "events/events.h"
 #include "globals.h"
 #include "job-control/job-control.h"
+#include "job-control/journal.h"
+#include "job-control/notice.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define SH_EXIT_POLL_INTERVAL UINT64_C(10000000) /**< ns between group checks */
+#define SH_EXIT_KILL_WAIT UINT64_C(1000000000) /**< ns to wait after SIGKILL */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Waits until every job's process group is empty, or until @p deadline
+ * passes.
+ *
+ * Children wake the wait up as they are reaped; processes they left behind
+ * are not the shell's to wait for, so their groups are checked periodically.
+ * @return number of process groups that still have members
+ */
+static size_t SH_ExitWaitJobs(SH_JobTable const *const table,
+                              uint64_t const deadline)
+{
+        size_t n_groups;
+        uint64_t now, timeout;
+
+        while ((n_groups = SH_JobTableSignalJobs(table, 0)) > 0) {
+                now = SH_TraceNow();
+                if (now >= deadline) {
+                        break;
+                }
+
+                timeout = deadline - now;
+                if (timeout > SH_EXIT_POLL_INTERVAL) {
+                        timeout = SH_EXIT_POLL_INTERVAL;
+                }
+                if (SH_WaitEventsFor(timeout) == -1) {
+                        break;
+                }
+        }
+
+        /* Groups empty as soon as they are reaped; take in the last ones. */
+        SH_ReceiverConsumeEvents(receiver);
+
+        return n_groups;
+}
+
+/**
+ * @brief Terminates the process group of every job, waiting for them all at
+ * once until the job table's exit timeout, then killing those that remain.
+ *
+ * Stopped jobs are continued, so that they can act on SIGTERM. Exit then takes
+ * as long as the slowest job, and no longer than the timeout.
+ */
+static void SH_ExitStopJobs(SH_JobTable *const table)
+{
+        if (SH_JobTableSignalJobs(table, SIGTERM) == 0) {
+                return;
+        }
+        SH_JobTableSignalJobs(table, SIGCONT);
+
+        if (SH_ExitWaitJobs(table, SH_TraceNow() + table->exit_timeout) == 0) {
+                return;
+        }
+
+        SH_JobTableSignalJobs(table, SIGKILL);
+        SH_ExitWaitJobs(table, SH_TraceNow() + SH_EXIT_KILL_WAIT);
+}
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -43,14 +146,22 @@
  ******************************************************************************/
 void SH_exit(int const status)
 {
-        /* Clean up job table and kill any child processes. */
-        SH_JobTableKillAllJobs(job_table);
+        /* Stop every job, and report on them, before cleaning up job table. */
+        SH_ExitStopJobs(job_table);
+        SH_JobTableCleanJobs(job_table);
         SH_DestroyJobTable(job_table);
         job_table = NULL;
+        SH_NoticeFlush(NULL, 0);
 
         /* Teardown event handling channels. */
         SH_CleanupEvents();
 
+        /* Write out command trace if requested via the environment. */
+        SH_TraceShutdown();
+
+        /* Close job lifecycle journal, whose events are already logged. */
+        SH_JournalShutdown();
+
         /* Make exit output pretty in case we are operating inside another shell. */
         if (!smallsh_interactive_mode) {
                 write(STDOUT_FILENO, "\n", 1);
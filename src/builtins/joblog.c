@@ -0,0 +1,82 @@
+/**
+ * @file joblog.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief joblog builtin command.
+ */
+#include <stdio.h>
+
+#include "builtins/joblog.h"
+#include "job-control/job-control.h"
+#include "job-control/job-log.h"
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_joblog(size_t const argc, char **const args)
+{
+        SH_JobLog *log;
+        SH_Job *job;
+
+        if (argc > 2) {
+                fprintf(stderr, "joblog: usage: joblog [job]\n");
+                fflush(stderr);
+                return;
+        }
+
+        /* Pick up whatever output arrived since the event loop last ran. */
+        SH_JobLogDrain();
+
+        if (argc == 1) {
+                log = SH_JobLogFirst();
+                while (log != NULL) {
+                        fprintf(stdout, "[%u]\t%d\t%s\t\t%llu bytes\t\t%s\n",
+                                log->spec, (int) log->pid,
+                                log->finished ? "Done" : "Running",
+                                (unsigned long long) log->written,
+                                log->command);
+                        log = log->next;
+                }
+                fflush(stdout);
+                return;
+        }
+
+        /* A job still in the table owns its spec, kept output or not. */
+        job = SH_JobTableFindSpec(job_table, args[1]);
+        log = job != NULL ? job->log : SH_JobLogFind(args[1]);
+        if (log == NULL) {
+                fprintf(stderr, "-smallsh: joblog: %s: no output kept\n",
+                        args[1]);
+                fflush(stderr);
+                return;
+        }
+
+        SH_JobLogPrint(log, stdout);
+        fflush(stdout);
+}
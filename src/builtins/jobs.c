@@ -0,0 +1,59 @@
+/**
+ * @file jobs.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief jobs builtin command.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "builtins/jobs.h"
+#include "job-control/job-control.h"
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_jobs(size_t const argc, char **const args)
+{
+        bool usage = false;
+
+        for (size_t i = 1; i < argc; i++) {
+                if (strcmp("-l", args[i]) == 0) {
+                        usage = true;
+                } else {
+                        fprintf(stderr, "-smallsh: jobs: %s: invalid option\n"
+                                        "jobs: usage: jobs [-l]\n", args[i]);
+                        fflush(stderr);
+                        return;
+                }
+        }
+
+        SH_JobTableListJobs(job_table, usage);
+}
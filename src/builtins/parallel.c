@@ -0,0 +1,569 @@
+/**
+ * @file parallel.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief parallel builtin command.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "builtins/builtins.h"
+#include "builtins/parallel.h"
+#include "error.h"
+#include "events/events.h"
+#include "interpreter/parser.h"
+#include "job-control/job-control.h"
+#include "job-control/prepare.h"
+#include "job-control/pressure.h"
+#include "utils/buffer.h"
+#include "utils/line-reader.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief State of a single run of the builtin.
+ */
+typedef struct {
+        size_t n_cmd; /**< number of words in command template */
+        char **cmd; /**< command template, or NULL to run arguments as is */
+        char const *path; /**< command's program, resolved once */
+        size_t n_args; /**< number of arguments given after ':::' */
+        char **args; /**< arguments given after ':::' */
+        size_t next; /**< index of next argument to run */
+        SH_LineReader *reader; /**< reader for arguments from a list file */
+        SH_Redirs shared; /**< redirections shared by every command */
+        size_t max_jobs; /**< max commands running at once */
+        size_t n_running; /**< number of commands running */
+        SH_Job **running; /**< commands running */
+        size_t n_failed; /**< number of commands that failed */
+} SH_Parallel;
+
+/**
+ * @brief Separates the command from its arguments.
+ */
+static char const * const PARALLEL_SEP = ":::";
+
+/**
+ * @brief Placeholder for the argument within the command's words.
+ */
+static char const * const PARALLEL_ARG = "{}";
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Reports an error with the builtin's usage.
+ */
+static void SH_ParallelUsage(char const * const msg)
+{
+        fprintf(stderr, "-smallsh: parallel: %s\n"
+                        "usage: parallel [-j N] [command ...] ::: arg ...\n"
+                        "       parallel [-j N] [command ...] < listfile\n",
+                msg);
+        fflush(stderr);
+}
+
+/**
+ * @brief Parses the argument to -j.
+ * @return number of jobs, or 0 if @p str is not a valid number of jobs
+ */
+static size_t SH_ParallelParseJobs(char const * const str)
+{
+        char *end;
+        long n;
+
+        errno = 0;
+        n = strtol(str, &end, 10);
+        if (errno != 0 || end == str || *end != '\0' || n < 1
+            || n > SH_PARALLEL_MAX_JOBS) {
+                return 0;
+        }
+
+        return (size_t) n;
+}
+
+/**
+ * @brief Returns the next argument to run a command for.
+ *
+ * Arguments read from a list file are views into the reader's buffer, valid
+ * until the next call. Empty lines are skipped.
+ * @return argument, or @c NULL when there are none left
+ */
+static char *SH_ParallelNextArg(SH_Parallel * const par)
+{
+        ssize_t len;
+        char *line;
+
+        if (par->reader == NULL) {
+                return par->next < par->n_args ? par->args[par->next++] : NULL;
+        }
+
+        while ((len = SH_LineReaderNext(par->reader, &line)) > 0) {
+                line[len - 1] = '\0';
+                if (len > 1) {
+                        return line;
+                }
+        }
+        if (len == -1) {
+                fprintf(stderr, "-smallsh: parallel: %s\n", strerror(errno));
+                fflush(stderr);
+        }
+
+        return NULL;
+}
+
+/**
+ * @brief Replaces every placeholder in @p word with @p arg.
+ * @param found output param, set if @p word had a placeholder
+ * @return new word, or @c NULL on failure
+ */
+static char *SH_ParallelSubstitute(char const *word, char const * const arg,
+                                   bool * const found)
+{
+        SH_Buffer *buf;
+        char const *ph;
+        char *result;
+
+        buf = SH_CreateBuffer(0);
+        if (buf == NULL) {
+                return NULL;
+        }
+
+        while ((ph = strstr(word, PARALLEL_ARG)) != NULL) {
+                *found = true;
+                if (SH_BufferAppend(buf, word, (size_t) (ph - word)) == -1
+                    || SH_BufferAppend(buf, arg, strlen(arg)) == -1) {
+                        SH_DestroyBuffer(&buf);
+                        return NULL;
+                }
+                word = ph + strlen(PARALLEL_ARG);
+        }
+        if (SH_BufferAppend(buf, word, strlen(word) + 1) == -1) {
+                SH_DestroyBuffer(&buf);
+                return NULL;
+        }
+
+        /* Hand the buffer's bytes over rather than copying them again. */
+        result = buf->data;
+        buf->data = NULL;
+        SH_DestroyBuffer(&buf);
+
+        return result;
+}
+
+/**
+ * @brief Joins the NULL-terminated @p words with spaces, for display as a
+ * job's command.
+ * @return joined words, or @c NULL on failure
+ */
+static char *SH_ParallelJoin(char * const *words)
+{
+        size_t len;
+        char *str, *p;
+
+        len = 1;
+        for (size_t i = 0; words[i] != NULL; i++) {
+                len += strlen(words[i]) + 1;
+        }
+
+        str = malloc(len);
+        if (str == NULL) {
+                return NULL;
+        }
+
+        p = str;
+        for (size_t i = 0; words[i] != NULL; i++) {
+                if (i > 0) {
+                        *p++ = ' ';
+                }
+                p = stpcpy(p, words[i]);
+        }
+        *p = '\0';
+
+        return str;
+}
+
+/**
+ * @brief Creates the process to run the command template for @p arg.
+ * @return new @c Process object, or @c NULL on failure
+ */
+static SH_Process *SH_ParallelTemplate(SH_Parallel const * const par,
+                                       char const * const arg)
+{
+        SH_Process *proc;
+        char **argv;
+        size_t n;
+        bool found;
+
+        argv = malloc((par->n_cmd + 2) * sizeof *argv);
+        if (argv == NULL) {
+                return NULL;
+        }
+
+        found = false;
+        proc = NULL;
+        for (n = 0; n < par->n_cmd; n++) {
+                argv[n] = SH_ParallelSubstitute(par->cmd[n], arg, &found);
+                if (argv[n] == NULL) {
+                        goto done;
+                }
+        }
+
+        /* Without a placeholder, the argument goes last. */
+        if (!found) {
+                argv[n] = strdup(arg);
+                if (argv[n] == NULL) {
+                        goto done;
+                }
+                n++;
+        }
+        argv[n] = NULL;
+
+        proc = SH_CreateProcess(n, argv);
+        if (par->path != NULL) {
+                proc->path = strdup(par->path);
+        }
+
+done:
+        while (n > 0) {
+                free(argv[--n]);
+        }
+        free(argv);
+
+        return proc;
+}
+
+/**
+ * @brief Starts the command for @p arg as a new job.
+ *
+ * Failures to start are reported, and counted as failed commands.
+ */
+static void SH_ParallelLaunch(SH_Parallel * const par, char const * const arg)
+{
+        SH_Parser *parser;
+        SH_Statement *stmt;
+        SH_Process *proc;
+        SH_Redirs redirs;
+        SH_Job *job;
+        char *line, *command;
+
+        SH_RedirsInit(&redirs);
+        proc = NULL;
+        command = NULL;
+        parser = NULL;
+        line = NULL;
+
+        if (par->cmd != NULL) {
+                proc = SH_ParallelTemplate(par, arg);
+                if (proc == NULL) {
+                        goto error;
+                }
+        } else {
+                /* Argument is a command line of its own. */
+                if (asprintf(&line, "%s\n", arg) == -1) {
+                        line = NULL;
+                        goto error;
+                }
+                parser = SH_CreateParser();
+                if (parser == NULL || SH_ParserParse(parser, line) < 1) {
+                        if (parser != NULL && parser->error != NULL) {
+                                fprintf(stderr, "-smallsh: parallel: syntax "
+                                        "error near unexpected token `%s'\n",
+                                        parser->error);
+                        }
+                        goto error;
+                }
+
+                stmt = parser->stmts[0];
+                if ((stmt->flags & FLAGS_BUILTIN) != 0) {
+                        fprintf(stderr, "-smallsh: parallel: %s: builtins "
+                                "cannot be run in parallel\n",
+                                stmt->cmd->args[0]);
+                        goto error;
+                }
+                if (SH_RedirsOpen(&redirs, stmt->infile, stmt->outfile,
+                                  false) == -1) {
+                        goto error;
+                }
+                proc = SH_CreateProcess(stmt->cmd->count, stmt->cmd->args);
+        }
+
+        if (SH_RedirsInherit(&redirs, &par->shared) == -1) {
+                fprintf(stderr, "-smallsh: parallel: %s\n", strerror(errno));
+                goto error;
+        }
+
+        /* Job is shown by the command it runs. */
+        if (par->cmd != NULL) {
+                command = SH_ParallelJoin(proc->args);
+                if (command == NULL) {
+                        goto error;
+                }
+        }
+
+        job = SH_CreateJob(command != NULL ? command : (char *) arg, proc,
+                           false);
+        job->redirs = redirs;
+        free(command);
+        if (parser != NULL) {
+                SH_DestroyParser(&parser);
+        }
+        free(line);
+
+        SH_JobTableAddJob(job_table, job);
+        SH_JobControlSpawnJob(job);
+        par->running[par->n_running++] = job;
+
+        return;
+
+error:
+        fflush(stderr);
+        SH_RedirsClose(&redirs);
+        if (proc != NULL) {
+                SH_DestroyProcess(proc);
+        }
+        if (parser != NULL) {
+                SH_DestroyParser(&parser);
+        }
+        free(command);
+        free(line);
+        par->n_failed++;
+}
+
+/**
+ * @brief Collects every command that has exited since the last call.
+ */
+static void SH_ParallelReap(SH_Parallel * const par)
+{
+        SH_Job *job;
+        int status;
+
+        for (size_t i = 0; i < par->n_running; ) {
+                job = par->running[i];
+                if (!job->proc->has_completed) {
+                        i++;
+                        continue;
+                }
+
+                status = job->proc->status;
+                if (WIFSIGNALED(status)) {
+                        fprintf(stdout, "terminated by signal %d\n",
+                                WTERMSIG(status));
+                        fflush(stdout);
+                }
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                        par->n_failed++;
+                }
+
+                SH_JobTableRemoveJob(job_table, job);
+                par->running[i] = par->running[--par->n_running];
+        }
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_parallel(size_t const argc, char ** const args,
+                 StmtStdin const * const in, StmtStdout const * const out)
+{
+        SH_Parallel par;
+        StmtStdin no_in;
+        char const *list;
+        char *arg;
+        size_t i;
+        long n_cpus;
+        int fd;
+
+        memset(&par, 0, sizeof par);
+        SH_RedirsInit(&par.shared);
+        fd = -1;
+
+        /* Default to one job per CPU. */
+        i = 1;
+        n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        par.max_jobs = n_cpus > 0 ? (size_t) n_cpus : 1;
+        if (i < argc && strncmp(args[i], "-j", 2) == 0) {
+                if (args[i][2] != '\0') {
+                        par.max_jobs = SH_ParallelParseJobs(&args[i][2]);
+                } else if (i + 1 < argc) {
+                        par.max_jobs = SH_ParallelParseJobs(args[++i]);
+                } else {
+                        par.max_jobs = 0;
+                }
+                if (par.max_jobs == 0) {
+                        SH_ParallelUsage("-j: invalid number of jobs");
+                        smallsh_errno = 2;
+                        return;
+                }
+                i++;
+        }
+
+        /* Command template runs up to the separator, if any. */
+        par.cmd = &args[i];
+        while (i < argc && strcmp(args[i], PARALLEL_SEP) != 0) {
+                par.n_cmd++;
+                i++;
+        }
+        if (par.n_cmd == 0) {
+                par.cmd = NULL;
+        } else if (!SH_IsBuiltin(par.cmd[0])) {
+                /* Every job runs the same program; look it up once. */
+                SH_PrepareCommand(par.cmd[0]);
+                par.path = SH_PrepareLookup(par.cmd[0]);
+        }
+
+        if (i < argc) {
+                par.args = &args[i + 1];
+                par.n_args = argc - i - 1;
+        } else if (in->n > 0) {
+                list = in->streams[in->n - 1];
+                errno = 0;
+                fd = open(list, O_RDONLY | O_CLOEXEC);
+                if (fd == -1) {
+                        fprintf(stderr, "-smallsh: %s: %s\n", list,
+                                strerror(errno));
+                        fflush(stderr);
+                        smallsh_errno = 1;
+                        return;
+                }
+                par.reader = SH_CreateLineReader(fd, 0);
+                if (par.reader == NULL) {
+                        print_error_msg("SH_CreateLineReader()");
+                        close(fd);
+                        smallsh_errno = 1;
+                        return;
+                }
+        } else {
+                SH_ParallelUsage("no arguments given");
+                smallsh_errno = 2;
+                return;
+        }
+        if (par.cmd != NULL && SH_IsBuiltin(par.cmd[0])) {
+                fprintf(stderr, "-smallsh: parallel: %s: builtins cannot be "
+                        "run in parallel\n", par.cmd[0]);
+                fflush(stderr);
+                smallsh_errno = 1;
+                goto done;
+        }
+
+        /* Output redirections are opened once, for every job to share. */
+        no_in.n = 0;
+        no_in.streams = NULL;
+        if (SH_RedirsOpen(&par.shared, &no_in, out, false) == -1) {
+                goto done;
+        }
+        if (SH_RedirsNull(&par.shared, STDIN_FILENO) == -1) {
+                fprintf(stderr, "-smallsh: /dev/null: %s\n", strerror(errno));
+                fflush(stderr);
+                smallsh_errno = 1;
+                goto done;
+        }
+
+        par.running = malloc(par.max_jobs * sizeof *par.running);
+        if (par.running == NULL) {
+                print_error_msg("malloc()");
+                smallsh_errno = 1;
+                goto done;
+        }
+
+        /*
+         * Keep every slot busy, refilling them as jobs exit, unless under
+         * pressure, which is looked at again every so often.
+         */
+        arg = NULL;
+        for (;;) {
+                while (par.n_running < par.max_jobs
+                       && (par.n_running == 0 || SH_PressureAllowLaunch())
+                       && (arg = SH_ParallelNextArg(&par)) != NULL) {
+                        SH_ParallelLaunch(&par, arg);
+                }
+                if (par.n_running == 0) {
+                        break;
+                }
+
+                if ((SH_PressureEnabled()
+                     ? SH_WaitEventsFor(SH_PRESSURE_INTERVAL)
+                     : SH_WaitEvents()) == -1) {
+                        break;
+                }
+                SH_ParallelReap(&par);
+        }
+
+        smallsh_errno = par.n_failed < SH_PARALLEL_MAX_STATUS
+                ? (int) par.n_failed : SH_PARALLEL_MAX_STATUS;
+
+done:
+        free(par.running);
+        SH_RedirsClose(&par.shared);
+        if (par.reader != NULL) {
+                SH_DestroyLineReader(&par.reader);
+        }
+        if (fd != -1) {
+                close(fd);
+        }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file pin.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief pin builtin command.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "builtins/pin.h"
+#include "job-control/affinity.h"
+#include "job-control/job-control.h"
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_pin(size_t const argc, char **const args)
+{
+        char const *spec;
+        SH_Job *job;
+        cpu_set_t cpus;
+        char list[256];
+
+        if (argc < 2 || argc > 3) {
+                fprintf(stderr, "pin: usage: pin [cpus] job\n");
+                fflush(stderr);
+                return;
+        }
+
+        /* Only jobs started and not yet reaped have a group to pin. */
+        spec = args[argc - 1];
+        job = SH_JobTableFindSpec(job_table, spec);
+        if (job == NULL || job->pgid <= 0 || job->proc->has_completed) {
+                fprintf(stderr, "-smallsh: pin: %s: no such job\n", spec);
+                fflush(stderr);
+                return;
+        }
+
+        if (argc == 2) {
+                if (sched_getaffinity(job->pgid, sizeof cpus, &cpus) == -1) {
+                        fprintf(stderr, "-smallsh: pin: %s: %s\n", spec,
+                                strerror(errno));
+                        fflush(stderr);
+                        return;
+                }
+                SH_AffinityFormatList(&cpus, list, sizeof list);
+                fprintf(stdout, "[%u]\t%d\t%s\n", job->spec, (int) job->pgid,
+                        list);
+                fflush(stdout);
+                return;
+        }
+
+        if (SH_AffinityParseList(args[1], &cpus) == -1) {
+                fprintf(stderr, "-smallsh: pin: %s: invalid CPU list\n",
+                        args[1]);
+                fflush(stderr);
+                return;
+        }
+
+        if (SH_AffinityPinGroup(job->pgid, &cpus) == -1) {
+                fprintf(stderr, "-smallsh: pin: %s: %s\n", spec,
+                        strerror(errno));
+                fflush(stderr);
+                return;
+        }
+
+        /* Count the job against its CPU only when pinned to a single one. */
+        job->cpu = -1;
+        if (CPU_COUNT(&cpus) == 1) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                        if (CPU_ISSET(cpu, &cpus)) {
+                                job->cpu = cpu;
+                                break;
+                        }
+                }
+        }
+}
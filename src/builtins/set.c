@@ -0,0 +1,569 @@
+/**
+ * @file set.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief set builtin command.
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "builtins/set.h"
+#include "job-control/affinity.h"
+#include "job-control/job-control.h"
+#include "job-control/job-log.h"
+#include "job-control/notice.h"
+#include "job-control/pressure.h"
+#include "job-control/priority.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A shell option, as named by @c set.
+ */
+typedef struct {
+        char const *name; /**< option name */
+        int (*set)(char const *value); /**< sets option, 0 if value is valid */
+        void (*show)(void); /**< prints option's value */
+} SH_SetOption;
+
+static int SH_SetAffinity(char const *value);
+static void SH_SetShowAffinity(void);
+static int SH_SetBgIO(char const *value);
+static void SH_SetShowBgIO(void);
+static int SH_SetBgLoad(char const *value);
+static void SH_SetShowBgLoad(void);
+static int SH_SetBgLog(char const *value);
+static void SH_SetShowBgLog(void);
+static int SH_SetBgNice(char const *value);
+static void SH_SetShowBgNice(void);
+static int SH_SetBgPsiCPU(char const *value);
+static void SH_SetShowBgPsiCPU(void);
+static int SH_SetBgPsiIO(char const *value);
+static void SH_SetShowBgPsiIO(void);
+static int SH_SetBgPsiMemory(char const *value);
+static void SH_SetShowBgPsiMemory(void);
+static int SH_SetBgSched(char const *value);
+static void SH_SetShowBgSched(void);
+static int SH_SetBgStop(char const *value);
+static void SH_SetShowBgStop(void);
+static int SH_SetExitTimeout(char const *value);
+static void SH_SetShowExitTimeout(void);
+static int SH_SetMaxJobs(char const *value);
+static void SH_SetShowMaxJobs(void);
+static int SH_SetNotify(char const *value);
+static void SH_SetShowNotify(void);
+
+/**
+ * @brief Options supported by @c set.
+ */
+static SH_SetOption const SET_OPTIONS[] = {
+        { "affinity", SH_SetAffinity, SH_SetShowAffinity },
+        { "bg-io", SH_SetBgIO, SH_SetShowBgIO },
+        { "bg-load", SH_SetBgLoad, SH_SetShowBgLoad },
+        { "bg-log", SH_SetBgLog, SH_SetShowBgLog },
+        { "bg-nice", SH_SetBgNice, SH_SetShowBgNice },
+        { "bg-psi-cpu", SH_SetBgPsiCPU, SH_SetShowBgPsiCPU },
+        { "bg-psi-io", SH_SetBgPsiIO, SH_SetShowBgPsiIO },
+        { "bg-psi-memory", SH_SetBgPsiMemory, SH_SetShowBgPsiMemory },
+        { "bg-sched", SH_SetBgSched, SH_SetShowBgSched },
+        { "bg-stop", SH_SetBgStop, SH_SetShowBgStop },
+        { "exit-timeout", SH_SetExitTimeout, SH_SetShowExitTimeout },
+        { "max-jobs", SH_SetMaxJobs, SH_SetShowMaxJobs },
+        { "notify", SH_SetNotify, SH_SetShowNotify },
+};
+
+#define SET_N_OPTIONS (sizeof SET_OPTIONS / sizeof SET_OPTIONS[0])
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Places background jobs on CPUs by policy @p value.
+ */
+static int SH_SetAffinity(char const *const value)
+{
+        if (strcmp("off", value) == 0) {
+                SH_AffinitySetPolicy(AFFINITY_OFF);
+        } else if (strcmp("spread", value) == 0) {
+                SH_AffinitySetPolicy(AFFINITY_SPREAD);
+        } else if (strcmp("compact", value) == 0) {
+                SH_AffinitySetPolicy(AFFINITY_COMPACT);
+        } else {
+                return -1;
+        }
+
+        return 0;
+}
+
+static void SH_SetShowAffinity(void)
+{
+        static char const *const names[] = { "off", "spread", "compact" };
+
+        fprintf(stdout, "%s", names[SH_AffinityGetPolicy()]);
+}
+
+/**
+ * @brief Runs background jobs in I/O scheduling class @p value.
+ */
+static int SH_SetBgIO(char const *const value)
+{
+        SH_Priority priority = SH_PriorityGet();
+
+        if (strcmp("none", value) == 0) {
+                priority.io = PRIORITY_IO_NONE;
+        } else if (strcmp("best-effort", value) == 0) {
+                priority.io = PRIORITY_IO_BEST_EFFORT;
+        } else if (strcmp("idle", value) == 0) {
+                priority.io = PRIORITY_IO_IDLE;
+        } else {
+                return -1;
+        }
+        SH_PrioritySet(&priority);
+
+        return 0;
+}
+
+static void SH_SetShowBgIO(void)
+{
+        static char const *const names[] = { "none", "best-effort", "idle" };
+
+        fprintf(stdout, "%s", names[SH_PriorityGet().io]);
+}
+
+/**
+ * @brief Parses pressure threshold @p value, between 0 and @p max, into
+ * @p threshold.
+ * @return 0 on success, -1 if @p value is not such a number
+ */
+static int SH_SetParseThreshold(char const *const value, double const max,
+                                double *const threshold)
+{
+        double n;
+        char *end;
+
+        if (*value < '0' || *value > '9') {
+                return -1;
+        }
+
+        errno = 0;
+        n = strtod(value, &end);
+        if (errno != 0 || *end != '\0' || n > max) {
+                return -1;
+        }
+        *threshold = n;
+
+        return 0;
+}
+
+/**
+ * @brief Sets pressure thresholds to @p pressure, starting any pending jobs
+ * they no longer hold back.
+ */
+static void SH_SetPressure(SH_Pressure const *const pressure)
+{
+        SH_PressureSet(pressure);
+        SH_JobControlLaunchPending();
+}
+
+/**
+ * @brief Holds back background jobs while the load average per CPU is over
+ * @p value.
+ */
+static int SH_SetBgLoad(char const *const value)
+{
+        SH_Pressure pressure = SH_PressureGet();
+
+        if (SH_SetParseThreshold(value, SH_PRESSURE_MAX_LOAD,
+                                 &pressure.load) == -1) {
+                return -1;
+        }
+        SH_SetPressure(&pressure);
+
+        return 0;
+}
+
+static void SH_SetShowBgLoad(void)
+{
+        fprintf(stdout, "%g", SH_PressureGet().load);
+}
+
+/**
+ * @brief Keeps the last @p value KiB of output of each background job
+ * started from now on.
+ */
+static int SH_SetBgLog(char const *const value)
+{
+        unsigned long n;
+        char *end;
+
+        if (*value < '0' || *value > '9') {
+                return -1;
+        }
+
+        errno = 0;
+        n = strtoul(value, &end, 10);
+        if (errno != 0 || *end != '\0' || n > SH_JOB_LOG_MAX_SIZE / 1024) {
+                return -1;
+        }
+
+        SH_JobLogSetSize(n * 1024);
+
+        return 0;
+}
+
+static void SH_SetShowBgLog(void)
+{
+        fprintf(stdout, "%zu", SH_JobLogGetSize() / 1024);
+}
+
+/**
+ * @brief Runs background jobs @p value nice levels below the shell.
+ */
+static int SH_SetBgNice(char const *const value)
+{
+        SH_Priority priority = SH_PriorityGet();
+        unsigned long n;
+        char *end;
+
+        if (*value < '0' || *value > '9') {
+                return -1;
+        }
+
+        errno = 0;
+        n = strtoul(value, &end, 10);
+        if (errno != 0 || *end != '\0' || n > SH_PRIORITY_MAX_NICE) {
+                return -1;
+        }
+
+        priority.nice = (int) n;
+        SH_PrioritySet(&priority);
+
+        return 0;
+}
+
+static void SH_SetShowBgNice(void)
+{
+        fprintf(stdout, "%d", SH_PriorityGet().nice);
+}
+
+/**
+ * @brief Holds back background jobs while tasks wait for a CPU more than
+ * @p value percent of the time.
+ */
+static int SH_SetBgPsiCPU(char const *const value)
+{
+        SH_Pressure pressure = SH_PressureGet();
+
+        if (SH_SetParseThreshold(value, SH_PRESSURE_MAX_PSI,
+                                 &pressure.cpu) == -1) {
+                return -1;
+        }
+        SH_SetPressure(&pressure);
+
+        return 0;
+}
+
+static void SH_SetShowBgPsiCPU(void)
+{
+        fprintf(stdout, "%g", SH_PressureGet().cpu);
+}
+
+/**
+ * @brief Holds back background jobs while tasks wait for I/O more than
+ * @p value percent of the time.
+ */
+static int SH_SetBgPsiIO(char const *const value)
+{
+        SH_Pressure pressure = SH_PressureGet();
+
+        if (SH_SetParseThreshold(value, SH_PRESSURE_MAX_PSI,
+                                 &pressure.io) == -1) {
+                return -1;
+        }
+        SH_SetPressure(&pressure);
+
+        return 0;
+}
+
+static void SH_SetShowBgPsiIO(void)
+{
+        fprintf(stdout, "%g", SH_PressureGet().io);
+}
+
+/**
+ * @brief Holds back background jobs while tasks wait for memory more than
+ * @p value percent of the time.
+ */
+static int SH_SetBgPsiMemory(char const *const value)
+{
+        SH_Pressure pressure = SH_PressureGet();
+
+        if (SH_SetParseThreshold(value, SH_PRESSURE_MAX_PSI,
+                                 &pressure.memory) == -1) {
+                return -1;
+        }
+        SH_SetPressure(&pressure);
+
+        return 0;
+}
+
+static void SH_SetShowBgPsiMemory(void)
+{
+        fprintf(stdout, "%g", SH_PressureGet().memory);
+}
+
+/**
+ * @brief Runs background jobs under CPU scheduling policy @p value.
+ */
+static int SH_SetBgSched(char const *const value)
+{
+        SH_Priority priority = SH_PriorityGet();
+
+        if (strcmp("other", value) == 0) {
+                priority.sched = PRIORITY_SCHED_OTHER;
+        } else if (strcmp("batch", value) == 0) {
+                priority.sched = PRIORITY_SCHED_BATCH;
+        } else if (strcmp("idle", value) == 0) {
+                priority.sched = PRIORITY_SCHED_IDLE;
+        } else {
+                return -1;
+        }
+        SH_PrioritySet(&priority);
+
+        return 0;
+}
+
+static void SH_SetShowBgSched(void)
+{
+        static char const *const names[] = { "other", "batch", "idle" };
+
+        fprintf(stdout, "%s", names[SH_PriorityGet().sched]);
+}
+
+/**
+ * @brief Stops CPU-heavy background jobs while foreground jobs run, or not.
+ */
+static int SH_SetBgStop(char const *const value)
+{
+        SH_Priority priority = SH_PriorityGet();
+
+        if (strcmp("on", value) == 0) {
+                priority.stop_heavy = true;
+        } else if (strcmp("off", value) == 0) {
+                priority.stop_heavy = false;
+        } else {
+                return -1;
+        }
+        SH_PrioritySet(&priority);
+
+        return 0;
+}
+
+static void SH_SetShowBgStop(void)
+{
+        fprintf(stdout, "%s", SH_PriorityGet().stop_heavy ? "on" : "off");
+}
+
+/**
+ * @brief Gives jobs @p value seconds to exit once the shell terminates them on
+ * exit, before they are killed.
+ */
+static int SH_SetExitTimeout(char const *const value)
+{
+        double seconds;
+        char *end;
+
+        if (*value < '0' || *value > '9') {
+                return -1;
+        }
+
+        errno = 0;
+        seconds = strtod(value, &end);
+        if (errno != 0 || *end != '\0' || seconds > SH_SET_MAX_EXIT_TIMEOUT) {
+                return -1;
+        }
+
+        job_table->exit_timeout = (uint64_t) (seconds * 1e9);
+
+        return 0;
+}
+
+static void SH_SetShowExitTimeout(void)
+{
+        fprintf(stdout, "%g", (double) job_table->exit_timeout / 1e9);
+}
+
+/**
+ * @brief Caps running background jobs at @p value, starting any pending jobs
+ * that now fit.
+ */
+static int SH_SetMaxJobs(char const *const value)
+{
+        unsigned long n;
+        char *end;
+
+        if (*value < '0' || *value > '9') {
+                return -1;
+        }
+
+        errno = 0;
+        n = strtoul(value, &end, 10);
+        if (errno != 0 || *end != '\0' || n > SH_SET_MAX_JOBS) {
+                return -1;
+        }
+
+        job_table->max_running = n;
+
+        /* A higher cap may leave room for jobs already queued. */
+        SH_JobControlLaunchPending();
+
+        return 0;
+}
+
+static void SH_SetShowMaxJobs(void)
+{
+        fprintf(stdout, "%zu", job_table->max_running);
+}
+
+/**
+ * @brief Renders job notices as text, or as JSON lines.
+ */
+static int SH_SetNotify(char const *const value)
+{
+        if (strcmp("text", value) == 0) {
+                SH_NoticeSetFormat(NOTICE_TEXT);
+        } else if (strcmp("json", value) == 0) {
+                SH_NoticeSetFormat(NOTICE_JSON);
+        } else {
+                return -1;
+        }
+
+        return 0;
+}
+
+static void SH_SetShowNotify(void)
+{
+        fprintf(stdout, "%s",
+                SH_NoticeGetFormat() == NOTICE_JSON ? "json" : "text");
+}
+
+/**
+ * @brief Finds the option @p arg sets, and sets it from the value after its
+ * @c = sign.
+ * @return 0 on success, -1 if @p arg does not name a valid option and value
+ */
+static int SH_SetOne(char const *const arg)
+{
+        char const *value;
+        size_t len;
+
+        value = strchr(arg, '=');
+        if (value == NULL) {
+                return -1;
+        }
+        len = (size_t) (value - arg);
+
+        for (size_t i = 0; i < SET_N_OPTIONS; i++) {
+                if (strlen(SET_OPTIONS[i].name) == len
+                    && strncmp(SET_OPTIONS[i].name, arg, len) == 0) {
+                        return SET_OPTIONS[i].set(value + 1);
+                }
+        }
+
+        return -1;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_set(size_t const argc, char **const args)
+{
+        /* Without option assignments, list the options. */
+        if (argc == 1 || (argc == 2 && strcmp("-o", args[1]) == 0)) {
+                for (size_t i = 0; i < SET_N_OPTIONS; i++) {
+                        fprintf(stdout, "%s\t", SET_OPTIONS[i].name);
+                        SET_OPTIONS[i].show();
+                        fprintf(stdout, "\n");
+                }
+                fflush(stdout);
+                return;
+        }
+
+        if (strcmp("-o", args[1]) != 0) {
+                fprintf(stderr, "-smallsh: set: %s: invalid option\n"
+                                "set: usage: set -o [name=value ...]\n",
+                        args[1]);
+                fflush(stderr);
+                return;
+        }
+
+        for (size_t i = 2; i < argc; i++) {
+                if (SH_SetOne(args[i]) == -1) {
+                        fprintf(stderr, "-smallsh: set: %s: invalid option "
+                                        "value\n", args[i]);
+                        fflush(stderr);
+                }
+        }
+}
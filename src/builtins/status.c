@@ -9,6 +9,7 @@
 #include "builtins/status.h"
 #include "error.h"
 #include "globals.h"
+#include "job-control/job-control.h"
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -41,10 +42,20 @@
  ******************************************************************************/
 void SH_status(void)
 {
-        if (!smallsh_interactive_mode) {
+        size_t n_pending;
+
+        /* Batch output is spaced out, but not within a substitution. */
+        if (!smallsh_interactive_mode && !smallsh_capturing) {
                 fprintf(stdout, "\nexit value %d\n", smallsh_errno);
         } else {
                 fprintf(stdout, "exit value %d\n", smallsh_errno);
         }
+
+        /* Mention jobs held back by the running job cap, if any. */
+        n_pending = SH_JobTableCountPending(job_table);
+        if (n_pending > 0) {
+                fprintf(stdout, "%zu job%s pending\n", n_pending,
+                        n_pending == 1 ? "" : "s");
+        }
         fflush(stdout);
 }
@@ -0,0 +1,134 @@
+/**
+ * @file time.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief time builtin command.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+
+#include "builtins/time.h"
+#include "job-control/job-control.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Returns the time from @p from to @p to, in seconds.
+ */
+static double SH_TimerSpan(struct timeval const *from,
+                           struct timeval const *to)
+{
+        return (double) (to->tv_sec - from->tv_sec)
+               + (double) (to->tv_usec - from->tv_usec) / 1e6;
+}
+
+/**
+ * @brief Prints a line of the report.
+ */
+static void SH_TimerPrint(char const *name, double seconds)
+{
+        fprintf(stderr, "%s\t%.6fs\n", name, seconds);
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_TimerStart(SH_Timer *const timer, uint64_t const begin)
+{
+        getrusage(RUSAGE_SELF, &timer->self);
+        getrusage(RUSAGE_CHILDREN, &timer->children);
+        timer->begin = begin;
+        timer->start = SH_TraceNow();
+}
+
+void SH_TimerReport(SH_Timer const *const timer)
+{
+        uint64_t end, run, spawn, reap;
+        SH_JobControlTimes fg;
+        struct rusage self, children;
+
+        end = SH_TraceNow();
+        getrusage(RUSAGE_SELF, &self);
+        getrusage(RUSAGE_CHILDREN, &children);
+
+        /* A foreground job that exited since the start was the command. */
+        fg = SH_JobControlLastForeground();
+        if (fg.started >= timer->start && fg.exited >= fg.started) {
+                spawn = fg.started - timer->start;
+                run = fg.exited - fg.started;
+                reap = end - fg.exited;
+        } else {
+                spawn = 0;
+                run = end - timer->start;
+                reap = 0;
+        }
+
+        SH_TimerPrint("real", (double) (end - timer->begin) / 1e9);
+        SH_TimerPrint("user", SH_TimerSpan(&timer->self.ru_utime,
+                                           &self.ru_utime)
+                              + SH_TimerSpan(&timer->children.ru_utime,
+                                             &children.ru_utime));
+        SH_TimerPrint("sys", SH_TimerSpan(&timer->self.ru_stime,
+                                          &self.ru_stime)
+                             + SH_TimerSpan(&timer->children.ru_stime,
+                                            &children.ru_stime));
+        SH_TimerPrint("run", (double) run / 1e9);
+        SH_TimerPrint("parse", (double) (timer->start - timer->begin) / 1e9);
+        SH_TimerPrint("spawn", (double) spawn / 1e9);
+        SH_TimerPrint("reap", (double) reap / 1e9);
+        fflush(stderr);
+}
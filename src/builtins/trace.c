@@ -0,0 +1,64 @@
+/**
+ * @file trace.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief trace builtin command.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "builtins/trace.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_trace(char const * const action, char const * const filename)
+{
+        if (action == NULL) {
+                SH_TraceDump(stdout);
+        } else if (strcmp("on", action) == 0) {
+                smallsh_trace_enabled = true;
+        } else if (strcmp("off", action) == 0) {
+                smallsh_trace_enabled = false;
+        } else if (strcmp("clear", action) == 0) {
+                SH_TraceClear();
+        } else if (strcmp("dump", action) == 0) {
+                if (filename == NULL) {
+                        SH_TraceDump(stdout);
+                } else {
+                        SH_TraceDumpFile(filename);
+                }
+        } else {
+                fprintf(stderr, "-smallsh: trace: %s: invalid action\n"
+                                "trace: usage: trace [on|off|clear|dump [file]]\n",
+                        action);
+                fflush(stderr);
+        }
+}
@@ -0,0 +1,360 @@
+/**
+ * @file ulimit.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief ulimit builtin command.
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "builtins/ulimit.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A resource @c ulimit can limit.
+ */
+typedef struct {
+        char option; /**< option letter */
+        int resource; /**< RLIMIT_ constant */
+        char const *name; /**< description */
+        char const *unit; /**< unit limits are given in, or NULL */
+        rlim_t scale; /**< bytes (or count) per unit */
+} SH_UlimitResource;
+
+/**
+ * @brief A resource option given to @c ulimit, with its value, if any.
+ */
+typedef struct {
+        SH_UlimitResource const *resource; /**< resource to show or set */
+        char const *value; /**< limit to set, or NULL to show it */
+} SH_UlimitRequest;
+
+/**
+ * @brief Resources supported by @c ulimit, by option letter.
+ */
+static SH_UlimitResource const ULIMIT_RESOURCES[] = {
+        { 'c', RLIMIT_CORE, "core file size", "blocks", 1024 },
+        { 'd', RLIMIT_DATA, "data seg size", "kbytes", 1024 },
+        { 'f', RLIMIT_FSIZE, "file size", "blocks", 1024 },
+        { 'n', RLIMIT_NOFILE, "open files", NULL, 1 },
+        { 's', RLIMIT_STACK, "stack size", "kbytes", 1024 },
+        { 't', RLIMIT_CPU, "cpu time", "seconds", 1 },
+        { 'u', RLIMIT_NPROC, "max user processes", NULL, 1 },
+        { 'v', RLIMIT_AS, "virtual memory", "kbytes", 1024 },
+};
+
+#define ULIMIT_N_RESOURCES \
+        (sizeof ULIMIT_RESOURCES / sizeof ULIMIT_RESOURCES[0])
+
+#define ULIMIT_MAX_REQUESTS 16 /**< max resource options per invocation */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Returns the resource for option letter @p option, or NULL.
+ */
+static SH_UlimitResource const *SH_UlimitFind(char const option)
+{
+        for (size_t i = 0; i < ULIMIT_N_RESOURCES; i++) {
+                if (ULIMIT_RESOURCES[i].option == option) {
+                        return &ULIMIT_RESOURCES[i];
+                }
+        }
+
+        return NULL;
+}
+
+/**
+ * @brief Returns whether or not @p arg is a limit, rather than an option or
+ * command.
+ */
+static bool SH_UlimitIsValue(char const *const arg)
+{
+        return strcmp("unlimited", arg) == 0 || (*arg >= '0' && *arg <= '9');
+}
+
+/**
+ * @brief Parses limit @p value of @p resource, in its units, into @p limit.
+ * @return 0 on success, -1 if @p value is not a number, or is too large
+ */
+static int SH_UlimitParse(SH_UlimitResource const *const resource,
+                          char const *const value, rlim_t *const limit)
+{
+        unsigned long long n;
+        char *end;
+
+        if (strcmp("unlimited", value) == 0) {
+                *limit = RLIM_INFINITY;
+                return 0;
+        }
+
+        errno = 0;
+        n = strtoull(value, &end, 10);
+        if (errno != 0 || *end != '\0' || *value < '0' || *value > '9'
+            || n > (RLIM_INFINITY - 1) / resource->scale) {
+                return -1;
+        }
+        *limit = (rlim_t) n * resource->scale;
+
+        return 0;
+}
+
+/**
+ * @brief Prints @p limit of @p resource, in its units.
+ */
+static void SH_UlimitPrint(SH_UlimitResource const *const resource,
+                           rlim_t const limit)
+{
+        if (limit == RLIM_INFINITY) {
+                fprintf(stdout, "unlimited\n");
+        } else {
+                fprintf(stdout, "%llu\n",
+                        (unsigned long long) (limit / resource->scale));
+        }
+}
+
+/**
+ * @brief Shows the soft or hard limit of @p resource in @p limits, labelled
+ * with its name if @p label.
+ */
+static void SH_UlimitShow(SH_Limits const *const limits,
+                          SH_UlimitResource const *const resource,
+                          bool const hard, bool const label)
+{
+        struct rlimit value;
+        char units[32];
+
+        if (SH_LimitsGet(limits, resource->resource, &value) == -1) {
+                fprintf(stderr, "-smallsh: ulimit: %s: cannot get limit: "
+                                "%s\n", resource->name, strerror(errno));
+                fflush(stderr);
+                return;
+        }
+
+        if (label) {
+                if (resource->unit != NULL) {
+                        snprintf(units, sizeof units, "(%s, -%c)",
+                                 resource->unit, resource->option);
+                } else {
+                        snprintf(units, sizeof units, "(-%c)",
+                                 resource->option);
+                }
+                fprintf(stdout, "%-20s %16s ", resource->name, units);
+        }
+        SH_UlimitPrint(resource, hard ? value.rlim_max : value.rlim_cur);
+}
+
+/**
+ * @brief Prints @c ulimit's usage.
+ * @return @p argc, for no command to be run
+ */
+static size_t SH_UlimitUsage(size_t const argc)
+{
+        fprintf(stderr, "ulimit: usage: ulimit [-SHa] [-cdfnstuv [limit]] "
+                        "... [command [arg ...]]\n");
+        fflush(stderr);
+
+        return argc;
+}
+
+/**
+ * @brief Sets the soft limit, hard limit or both, of @p resource in
+ * @p limits to @p value.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_UlimitSet(SH_Limits *const limits,
+                        SH_UlimitResource const *const resource,
+                        char const *const value, bool const soft,
+                        bool const hard)
+{
+        struct rlimit limit;
+        rlim_t n;
+
+        if (SH_UlimitParse(resource, value, &n) == -1) {
+                fprintf(stderr, "-smallsh: ulimit: %s: invalid number\n",
+                        value);
+                fflush(stderr);
+                return -1;
+        }
+
+        if (SH_LimitsGet(limits, resource->resource, &limit) == 0) {
+                if (soft) {
+                        limit.rlim_cur = n;
+                }
+                if (hard) {
+                        limit.rlim_max = n;
+                }
+                if (SH_LimitsSet(limits, resource->resource, &limit) == 0) {
+                        return 0;
+                }
+        }
+
+        fprintf(stderr, "-smallsh: ulimit: %s: cannot modify limit: %s\n",
+                resource->name, strerror(errno));
+        fflush(stderr);
+
+        return -1;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+size_t SH_ulimit(size_t const argc, char **const args,
+                 SH_Limits *const command)
+{
+        SH_UlimitRequest requests[ULIMIT_MAX_REQUESTS];
+        SH_UlimitResource const *resource;
+        size_t n_requests, i;
+        bool soft, hard, all;
+        SH_Limits *limits;
+        char const *arg;
+
+        soft = false;
+        hard = false;
+        all = false;
+        n_requests = 0;
+
+        for (i = 1; i < argc; i++) {
+                arg = args[i];
+                if (arg[0] != '-' || arg[1] == '\0') {
+                        break;
+                } else if (strcmp("--", arg) == 0) {
+                        i++;
+                        break;
+                }
+
+                for (arg++; *arg != '\0'; arg++) {
+                        if (*arg == 'S') {
+                                soft = true;
+                                continue;
+                        } else if (*arg == 'H') {
+                                hard = true;
+                                continue;
+                        } else if (*arg == 'a') {
+                                all = true;
+                                continue;
+                        }
+
+                        resource = SH_UlimitFind(*arg);
+                        if (resource == NULL
+                            || n_requests == ULIMIT_MAX_REQUESTS) {
+                                fprintf(stderr, "-smallsh: ulimit: -%c: "
+                                                "invalid option\n", *arg);
+                                return SH_UlimitUsage(argc);
+                        }
+
+                        /* Only the option ending a cluster takes a value. */
+                        requests[n_requests].resource = resource;
+                        requests[n_requests].value = NULL;
+                        if (arg[1] == '\0' && i + 1 < argc
+                            && SH_UlimitIsValue(args[i + 1])) {
+                                requests[n_requests].value = args[++i];
+                        }
+                        n_requests++;
+                }
+        }
+
+        /* Limits for a command alone start from those it would get anyway. */
+        if (i < argc) {
+                if (all || n_requests == 0) {
+                        return SH_UlimitUsage(argc);
+                }
+                for (size_t j = 0; j < n_requests; j++) {
+                        if (requests[j].value == NULL) {
+                                return SH_UlimitUsage(argc);
+                        }
+                }
+                SH_LimitsCurrent(command);
+                limits = command;
+        } else {
+                limits = SH_LimitsShell();
+        }
+
+        if (all) {
+                for (size_t j = 0; j < ULIMIT_N_RESOURCES; j++) {
+                        SH_UlimitShow(limits, &ULIMIT_RESOURCES[j], hard,
+                                      true);
+                }
+        } else if (n_requests == 0) {
+                SH_UlimitShow(limits, SH_UlimitFind('f'), hard, false);
+        }
+
+        for (size_t j = 0; j < n_requests; j++) {
+                if (requests[j].value == NULL) {
+                        SH_UlimitShow(limits, requests[j].resource, hard,
+                                      n_requests > 1);
+                } else if (SH_UlimitSet(limits, requests[j].resource,
+                                        requests[j].value,
+                                        soft || !hard, hard || !soft) == -1) {
+                        return argc;
+                }
+        }
+        fflush(stdout);
+
+        return i;
+}
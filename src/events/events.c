@@ -3,11 +3,31 @@
  * @author Mohamed Al-Hussein
  * @date 09 Feb 2022
  * @brief Contains functions for handling signal-generated events.
+ *
+ * While the shell waits for input, child completions are still handled: with
+ * io_uring, the read and a @c waitid are submitted together and harvested from
+ * one completion queue; otherwise the input and the SIGCHLD channel are
+ * selected on together.
  */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "events/events.h"
+#include "events/uring.h"
+#include "globals.h"
 #include "job-control/job-control.h"
+#include "job-control/job-log.h"
+#include "job-control/pressure.h"
+#include "trace/trace.h"
 /* *****************************************************************************
  * PRIVATE DEFINITIONS
  *
@@ -38,7 +58,451 @@
  *
  *
  ******************************************************************************/
-#define SH_MAX_EVENTS 1
+#define SH_MAX_EVENTS 3
+#define SH_EVENTS_URING_ENTRIES 8 /**< submission queue entries */
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Tags identifying what each io_uring completion is for.
+ */
+enum SH_EventsTag {
+        EVENTS_READ = 1, /**< read of input */
+        EVENTS_CHILD, /**< waitid, or poll of the SIGCHLD channel */
+        EVENTS_SIGNAL, /**< poll of the init mode signal channel */
+        EVENTS_CANCEL, /**< cancellation of the read */
+        EVENTS_TIMER, /**< timeout for another look at pending jobs */
+        EVENTS_LOG, /**< poll of background job output */
+};
+
+static SH_Uring *events_uring = NULL; /**< io_uring backend, if available */
+static bool events_waitid = false; /**< whether waitid can be submitted */
+static bool events_child_armed = false; /**< whether child op is in flight */
+static bool events_signal_armed = false; /**< whether signal poll is in flight */
+static bool events_timer_armed = false; /**< whether timeout is in flight */
+static bool events_log_armed = false; /**< whether output poll is in flight */
+static siginfo_t events_waitid_info; /**< waitid result, written by kernel */
+static struct __kernel_timespec events_timer_ts; /**< timeout, read by kernel */
+
+/**
+ * @brief Channel over the job logs' epoll instance, readable when background
+ * jobs have output to drain.
+ */
+static SH_Channel events_log_channel = { -1, -1, NULL };
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Gives @p channel a pipe of its own, in place of the one it shares
+ * with the shell since a fork.
+ *
+ * Both ends keep their descriptors, and are non-blocking, as set up by the
+ * sender and receiver.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_EventsRenewChannel(SH_Channel *const channel)
+{
+        int fds[2];
+        int status;
+
+        errno = 0;
+        if (pipe2(fds, O_NONBLOCK) == -1) {
+                return -1;
+        }
+
+        status = 0;
+        if (dup2(fds[0], channel->read_fd) == -1
+            || dup2(fds[1], channel->write_fd) == -1) {
+                status = -1;
+        }
+        close(fds[0]);
+        close(fds[1]);
+
+        return status;
+}
+
+/**
+ * @brief Sets up the io_uring backend, unless it is unavailable, or
+ * @c SMALLSH_EVENTS is set to @c select.
+ *
+ * Without io_uring, or without its read, the select backend is used instead.
+ * Without @c waitid (Linux 6.7), the SIGCHLD channel is polled through the
+ * ring instead.
+ */
+static void SH_EventsInitUring(void)
+{
+        char const *backend;
+
+        backend = getenv("SMALLSH_EVENTS");
+        if (backend != NULL && strcmp(backend, "select") == 0) {
+                return;
+        }
+
+        events_uring = SH_CreateUring(SH_EVENTS_URING_ENTRIES);
+        if (events_uring == NULL) {
+                return;
+        }
+
+        if (!SH_UringSupports(events_uring, IORING_OP_READ)
+            || !SH_UringSupports(events_uring, IORING_OP_POLL_ADD)
+            || !SH_UringSupports(events_uring, IORING_OP_TIMEOUT)) {
+                SH_DestroyUring(&events_uring);
+                return;
+        }
+
+        events_waitid = SH_UringSupports(events_uring, SH_URING_OP_WAITID);
+}
+
+/**
+ * @brief Queues an operation that completes once a child changes state,
+ * unless one is already in flight.
+ *
+ * The @c waitid leaves the child a zombie, for the SIGCHLD handler to reap
+ * along with its resource usage.
+ */
+static void SH_EventsArmChild(void)
+{
+        struct io_uring_sqe *sqe;
+
+        if (events_child_armed) {
+                return;
+        }
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                return;
+        }
+
+        if (events_waitid) {
+                sqe->opcode = SH_URING_OP_WAITID;
+                sqe->len = P_ALL;
+                sqe->fd = 0;
+                sqe->file_index = WEXITED | WNOWAIT;
+                sqe->addr2 = (uintptr_t) &events_waitid_info;
+        } else {
+                sqe->opcode = IORING_OP_POLL_ADD;
+                sqe->fd = sigchld_channel->read_fd;
+                sqe->poll32_events = POLLIN;
+        }
+        sqe->user_data = EVENTS_CHILD;
+
+        events_child_armed = true;
+}
+
+/**
+ * @brief Queues a poll of the init mode signal channel, unless one is already
+ * in flight.
+ */
+static void SH_EventsArmSignal(void)
+{
+        struct io_uring_sqe *sqe;
+
+        if (events_signal_armed) {
+                return;
+        }
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                return;
+        }
+
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = signal_channel->read_fd;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data = EVENTS_SIGNAL;
+
+        events_signal_armed = true;
+}
+
+/**
+ * @brief Returns whether or not pending jobs are to be looked at again after
+ * a while, even if no child changes state, as they may be held back by
+ * pressure that can ease by itself.
+ */
+static bool SH_EventsPendingTimer(void)
+{
+        return SH_PressureEnabled() && SH_JobTableCountPending(job_table) > 0;
+}
+
+/**
+ * @brief Queues a timeout of @c SH_PRESSURE_INTERVAL, if pending jobs need
+ * one, and none is already in flight.
+ */
+static void SH_EventsArmTimer(void)
+{
+        struct io_uring_sqe *sqe;
+
+        if (events_timer_armed || !SH_EventsPendingTimer()) {
+                return;
+        }
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                return;
+        }
+
+        events_timer_ts.tv_sec = SH_PRESSURE_INTERVAL / 1000000000;
+        events_timer_ts.tv_nsec = SH_PRESSURE_INTERVAL % 1000000000;
+
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->addr = (uintptr_t) &events_timer_ts;
+        sqe->len = 1;
+        sqe->user_data = EVENTS_TIMER;
+
+        events_timer_armed = true;
+}
+
+/**
+ * @brief Queues a poll of the job logs' pipes, if any are open, and none is
+ * already in flight.
+ */
+static void SH_EventsArmLog(void)
+{
+        struct io_uring_sqe *sqe;
+
+        if (events_log_armed || !SH_JobLogActive()) {
+                return;
+        }
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                return;
+        }
+
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = events_log_channel.read_fd;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data = EVENTS_LOG;
+
+        events_log_armed = true;
+}
+
+/**
+ * @brief Drains background job output into their logs.
+ */
+static int SH_EventsLogCallbackHandler(SH_Channel const channel)
+{
+        (void) channel;
+
+        SH_JobLogDrain();
+
+        return 0;
+}
+
+/**
+ * @brief Queues the cancellation of the read in flight.
+ */
+static void SH_EventsCancelRead(void)
+{
+        struct io_uring_sqe *sqe;
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                return;
+        }
+
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = EVENTS_READ;
+        sqe->user_data = EVENTS_CANCEL;
+}
+
+/**
+ * @brief Reaps completed children, updates the global job table, and starts
+ * pending jobs in the slots they freed.
+ *
+ * Completed jobs are left in the job table, for the next @c SH_NotifyEvents
+ * to report.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_EventsHandleChildren(void)
+{
+        sigset_t mask, old_mask;
+        int status;
+
+        /* The SIGCHLD handler may have beaten us to it. */
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+        status = SH_SenderNotifySigchldEvent(sigchld_channel);
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+        if (status == -1) {
+                return -1;
+        }
+
+        if (SH_ReceiverConsumeEvents(receiver) == -1) {
+                return -1;
+        }
+
+        SH_JobControlLaunchPending();
+
+        return 0;
+}
+
+/**
+ * @brief @c SH_ReadEvents through io_uring.
+ *
+ * The read is only ever in flight during this call, so that foreground jobs
+ * get the shell's input to themselves: once the shell is told to terminate,
+ * it is cancelled. The child and signal operations stay armed across calls,
+ * as does the timeout pending jobs are looked at again after.
+ */
+static ssize_t SH_EventsUringRead(int const fd, void * const buf,
+                                  size_t const count)
+{
+        struct io_uring_sqe *sqe;
+        struct io_uring_cqe cqe;
+        ssize_t n_read;
+        bool reading, children, signals, timer, output, cancelling;
+
+        if (smallsh_init_signal != 0) {
+                return 0;
+        }
+
+        sqe = SH_UringGetSqe(events_uring);
+        if (sqe == NULL) {
+                errno = EBUSY;
+                return -1;
+        }
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = (uintptr_t) buf;
+        sqe->len = (unsigned) count;
+        sqe->off = (uint64_t) -1;
+        sqe->user_data = EVENTS_READ;
+
+        SH_EventsArmChild();
+        SH_EventsArmSignal();
+
+        n_read = 0;
+        reading = true;
+        cancelling = false;
+        while (reading) {
+                SH_EventsArmTimer();
+                SH_EventsArmLog();
+                if (SH_UringSubmitAndWait(events_uring, 1) == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                }
+
+                children = false;
+                signals = false;
+                timer = false;
+                output = false;
+                while (SH_UringNextCqe(events_uring, &cqe)) {
+                        if (cqe.user_data == EVENTS_READ) {
+                                n_read = cqe.res;
+                                reading = false;
+                                continue;
+                        } else if (cqe.user_data == EVENTS_CANCEL) {
+                                continue;
+                        } else if (cqe.user_data == EVENTS_LOG) {
+                                events_log_armed = false;
+                                output = true;
+                                continue;
+                        } else if (cqe.user_data == EVENTS_TIMER) {
+                                events_timer_armed = false;
+                                timer = true;
+                                continue;
+                        } else if (cqe.user_data == EVENTS_SIGNAL) {
+                                events_signal_armed = false;
+                                signals = true;
+                                SH_EventsArmSignal();
+                                continue;
+                        }
+
+                        events_child_armed = false;
+                        children = true;
+
+                        /* No children: nothing to wait for until a spawn. */
+                        if (cqe.res == -ECHILD) {
+                                continue;
+                        }
+                        /* Kernel refused waitid; poll the channel instead. */
+                        if (cqe.res < 0) {
+                                if (!events_waitid) {
+                                        continue;
+                                }
+                                events_waitid = false;
+                        }
+                        SH_EventsArmChild();
+                }
+
+                if (children && SH_EventsHandleChildren() == -1) {
+                        return -1;
+                }
+                if (signals && SH_ReceiverConsumeEvents(receiver) == -1) {
+                        return -1;
+                }
+                if (timer && !children) {
+                        SH_JobControlLaunchPending();
+                }
+                if (output) {
+                        SH_JobLogDrain();
+                }
+
+                /* Told to terminate: input read from now on goes unused. */
+                if (reading && !cancelling && smallsh_init_signal != 0) {
+                        SH_EventsCancelRead();
+                        cancelling = true;
+                }
+        }
+
+        if (cancelling && n_read == -ECANCELED) {
+                return 0;
+        }
+        if (n_read < 0) {
+                errno = (int) -n_read;
+                return -1;
+        }
+
+        return n_read;
+}
+
+/**
+ * @brief @c SH_ReadEvents through select.
+ */
+static ssize_t SH_EventsSelectRead(int const fd, void * const buf,
+                                   size_t const count)
+{
+        struct timeval tv;
+        int ready;
+
+        for (;;) {
+                if (smallsh_init_signal != 0) {
+                        return 0;
+                }
+
+                tv.tv_sec = SH_PRESSURE_INTERVAL / 1000000000;
+                tv.tv_usec = SH_PRESSURE_INTERVAL % 1000000000 / 1000;
+                ready = SH_ReceiverWaitInput(receiver, fd,
+                                             SH_EventsPendingTimer()
+                                             ? &tv : NULL);
+                if (ready == -1) {
+                        return -1;
+                } else if (ready == 1) {
+                        return read(fd, buf, count);
+                }
+
+                /* Channel callbacks already consumed any events. */
+                SH_JobControlLaunchPending();
+        }
+}
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -69,6 +533,20 @@
  *
  *
  ******************************************************************************/
+int SH_EventsDetach(void)
+{
+        /* Completions on the ring are the shell's, as are its job logs. */
+        SH_DestroyUring(&events_uring);
+        SH_JobLogDetach();
+
+        if (SH_EventsRenewChannel(sigchld_channel) == -1
+            || SH_EventsRenewChannel(signal_channel) == -1) {
+                return -1;
+        }
+
+        return 0;
+}
+
 int SH_InitEvents(void)
 {
         int status;
@@ -80,6 +558,12 @@ int SH_InitEvents(void)
                 return -1;
         }
 
+        signal_channel = SH_CreateChannel(SH_ReceiverSignalCallbackHandler);
+        if (signal_channel == NULL) {
+                fprintf(stderr, "SH_CreateChannel()");
+                return -1;
+        }
+
         /* Initialize event handler */
         receiver = SH_CreateReceiver(SH_MAX_EVENTS);
         if (receiver == NULL) {
@@ -93,6 +577,23 @@ int SH_InitEvents(void)
                 return -1;
         }
 
+        status = SH_ReceiverAddChannel(receiver, signal_channel);
+        if (status == -1) {
+                fprintf(stderr, "SH_ReceiverAddChannel()");
+                return -1;
+        }
+
+        /* Job logs are drained wherever the shell waits on its channels. */
+        events_log_channel.read_fd = SH_JobLogInit();
+        events_log_channel.callback_handler = SH_EventsLogCallbackHandler;
+        if (events_log_channel.read_fd != -1) {
+                status = SH_ReceiverAddChannel(receiver, &events_log_channel);
+                if (status == -1) {
+                        fprintf(stderr, "SH_ReceiverAddChannel()");
+                        return -1;
+                }
+        }
+
         /* Initialize event notifier */
         sender = SH_CreateSender(SH_MAX_EVENTS);
         if (sender == NULL) {
@@ -106,19 +607,35 @@ int SH_InitEvents(void)
                 return -1;
         }
 
+        status = SH_SenderAddChannel(sender, signal_channel);
+        if (status == -1) {
+                fprintf(stderr, "SH_SenderAddChannel()");
+                return -1;
+        }
+
+        /* Fall back on select if io_uring is unavailable. */
+        SH_EventsInitUring();
+
         return 0;
 }
 
 void SH_CleanupEvents(void)
 {
+        SH_DestroyUring(&events_uring);
         SH_DestroyReceiver(&receiver);
         SH_DestroySender(&sender);
         SH_DestroyChannel(&sigchld_channel);
+        SH_DestroyChannel(&signal_channel);
+        SH_JobLogCleanup();
+        events_log_channel.read_fd = -1;
 }
 
 int SH_NotifyEvents(void)
 {
         int status;
+        uint64_t trace_start;
+
+        trace_start = SH_TRACE_BEGIN();
 
         status = SH_ReceiverConsumeEvents(receiver);
         if (status == -1) {
@@ -128,5 +645,49 @@ int SH_NotifyEvents(void)
 
         SH_JobTableCleanJobs(job_table);
 
+        /* Completed jobs may have freed slots for pending ones. */
+        SH_JobControlLaunchPending();
+
+        SH_TRACE_END(TRACE_NOTIFY, 0, trace_start);
+
+        return 0;
+}
+
+int SH_WaitEvents(void)
+{
+        int status;
+
+        status = SH_ReceiverWaitEvents(receiver);
+        if (status == -1) {
+                fprintf(stderr, "SH_ReceiverWaitEvents()\n");
+                return -1;
+        }
+
         return 0;
 }
+
+int SH_WaitEventsFor(uint64_t const timeout)
+{
+        struct timeval tv;
+        int status;
+
+        tv.tv_sec = (time_t) (timeout / 1000000000);
+        tv.tv_usec = (suseconds_t) (timeout % 1000000000 / 1000);
+
+        status = SH_ReceiverWaitEventsFor(receiver, &tv);
+        if (status == -1) {
+                fprintf(stderr, "SH_ReceiverWaitEventsFor()\n");
+                return -1;
+        }
+
+        return 0;
+}
+
+ssize_t SH_ReadEvents(int const fd, void * const buf, size_t const count)
+{
+        if (events_uring != NULL) {
+                return SH_EventsUringRead(fd, buf, count);
+        }
+
+        return SH_EventsSelectRead(fd, buf, count);
+}
@@ -16,6 +16,83 @@
 #include "events/receiver.h"
 #include "events/dto.h"
 #include "job-control/job-control.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Selects on @p receiver's channels, and on @p fd unless it is -1, for
+ * at most @p timeout, and calls the callback handlers of channels with new
+ * events.
+ * @param receiver @c Receiver object
+ * @param fd extra file descriptor to wait for input on, or -1
+ * @param timeout how long to wait for events, or @c NULL to wait until one
+ * arrives
+ * @return 1 if @p fd has input, 0 if not, -1 on failure
+ */
+static int SH_ReceiverSelect(SH_Receiver * const receiver, int const fd,
+                             struct timeval * const timeout)
+{
+        int ready, n_fds;
+        fd_set fds;
+        SH_Channel ch;
+
+        n_fds = receiver->n;
+        if (fd >= n_fds) {
+                n_fds = fd + 1;
+        }
+
+        errno = 0;
+        do {
+                fds = receiver->fds;
+                if (fd != -1) {
+                        FD_SET(fd, &fds);
+                }
+        } while ((ready = select(n_fds, &fds, NULL, NULL, timeout)) == -1
+                 && errno == EINTR);
+        if (ready == -1 && errno != EINTR) {
+                fprintf(stderr, "Failed to consume events: %s\n",
+                        strerror(errno));
+                return -1;
+        }
+
+        for (size_t i = 0; i < receiver->size; i++) {
+                ch = *receiver->channels[i];
+                if (FD_ISSET(ch.read_fd, &fds)) {
+                        ch.callback_handler(ch);
+                }
+        }
+
+        return fd != -1 && FD_ISSET(fd, &fds);
+}
+
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -149,8 +226,11 @@ SH_ReceiverAddChannel(SH_Receiver * const receiver, SH_Channel * const channel)
 int SH_ReceiverSigchldCallbackHandler(struct SH_Channel const channel)
 {
         SH_SigchldDTO dto;
+        uint64_t trace_start;
 
         for (;;) {
+                trace_start = SH_TRACE_BEGIN();
+
                 /* Drain pipe and for any SIGCHLD DTOs. */
                 errno = 0;
                 if (read(channel.read_fd, &dto, sizeof(dto)) == -1) {
@@ -164,7 +244,33 @@ int SH_ReceiverSigchldCallbackHandler(struct SH_Channel const channel)
                 }
 
                 /* Update relevant job in job table. */
-                SH_JobTableUpdateJob(job_table, dto.pid, dto.status);
+                SH_JobTableUpdateJob(job_table, dto.pid, dto.status,
+                                     &dto.usage, dto.finished);
+
+                SH_TRACE_END(TRACE_REAP, dto.pid, trace_start);
+        }
+
+        return 0;
+}
+
+int SH_ReceiverSignalCallbackHandler(struct SH_Channel const channel)
+{
+        SH_SignalDTO dto;
+
+        for (;;) {
+                /* Drain pipe of any signal DTOs. */
+                errno = 0;
+                if (read(channel.read_fd, &dto, sizeof(dto)) == -1) {
+                        if (errno == EAGAIN) {
+                                break;
+                        } else {
+                                fprintf(stderr, "Failed to receive data: %s\n",
+                                        strerror(errno));
+                                return -1;
+                        }
+                }
+
+                SH_JobTableSignalJobs(job_table, dto.signo);
         }
 
         return 0;
@@ -172,10 +278,7 @@ int SH_ReceiverSigchldCallbackHandler(struct SH_Channel const channel)
 
 int SH_ReceiverConsumeEvents(SH_Receiver * const receiver)
 {
-        int ready, n_fds;
         struct timeval timeout;
-        fd_set fds;
-        SH_Channel ch;
 
         /*
          * Don't block; just poll for file descriptors.
@@ -185,31 +288,22 @@ int SH_ReceiverConsumeEvents(SH_Receiver * const receiver)
         timeout.tv_sec = 0;
         timeout.tv_usec = 0;
 
-        n_fds = receiver->n;
-        fds = receiver->fds;
-
-        errno = 0;
-        while ((ready = select(n_fds, &fds, NULL, NULL, &timeout)) == -1
-                && errno == EINTR)
-                ;
-        if (ready == -1 && errno != EINTR) {
-                fprintf(stderr, "Failed to consume events: %s\n",
-                        strerror(errno));
-                return -1;
-        }
+        return SH_ReceiverSelect(receiver, -1, &timeout);
+}
 
-        for (size_t i = 0; i < receiver->size; i++) {
-                ch = *receiver->channels[i];
-                if (FD_ISSET(ch.read_fd, &fds)) {
-                        ch.callback_handler(ch);
-                }
-        }
+int SH_ReceiverWaitEvents(SH_Receiver * const receiver)
+{
+        return SH_ReceiverSelect(receiver, -1, NULL);
+}
 
-        FD_ZERO(&fds);
-        for (size_t i = 0; i < receiver->size; i++) {
-                ch = *receiver->channels[i];
-                FD_SET(ch.read_fd, &fds);
-        }
+int SH_ReceiverWaitEventsFor(SH_Receiver * const receiver,
+                             struct timeval * const timeout)
+{
+        return SH_ReceiverSelect(receiver, -1, timeout);
+}
 
-        return 0;
+int SH_ReceiverWaitInput(SH_Receiver * const receiver, int const fd,
+                         struct timeval * const timeout)
+{
+        return SH_ReceiverSelect(receiver, fd, timeout);
 }
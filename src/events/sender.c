@@ -4,16 +4,19 @@
  * @date 09 Feb 2022
  * @brief Responsible for sending messages to subscribers via a dedicated Channel.
  */
+#define _GNU_SOURCE
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include "events/sender.h"
 #include "events/dto.h"
+#include "trace/trace.h"
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -132,19 +135,25 @@ int SH_SenderNotifySigchldEvent(SH_Channel * const channel)
 {
         int status;
         pid_t child_pid;
+        struct rusage usage;
         SH_SigchldDTO dto;
 
         /*
          * Catch all incoming SIGCHLD signals and dispatch their status to
-         * listening parties.
+         * listening parties, along with the resources each child used.
+         *
+         * The foreground job is reaped like any other; the shell waiting on it
+         * takes its status from the channel.
          *
          * Source: TLPI section 26.3
          */
         errno = 0;
-        while ((child_pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        while ((child_pid = wait4(-1, &status, WNOHANG, &usage)) > 0) {
                 /* Initialize DTO object to transfer PID and status through. */
                 dto.pid = child_pid;
                 dto.status = status;
+                dto.usage = usage;
+                dto.finished = SH_TraceNow();
 
                 /* Write DTO to pipe. */
                 errno = 0;
@@ -159,3 +168,18 @@ int SH_SenderNotifySigchldEvent(SH_Channel * const channel)
 
         return 0;
 }
+
+int SH_SenderNotifySignalEvent(SH_Channel * const channel, int const sig)
+{
+        SH_SignalDTO dto;
+
+        dto.signo = sig;
+
+        errno = 0;
+        if (write(channel->write_fd, &dto, sizeof(dto)) == -1
+            && errno != EAGAIN) {
+                return -1;
+        }
+
+        return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file uring.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Minimal io_uring submission and completion queue pair.
+ *
+ * This is a thin wrapper over the raw io_uring system calls, just large enough
+ * for the shell's event loop to submit a few operations at a time and harvest
+ * their completions, without depending on liburing.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "events/uring.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define SH_URING_PROBE_OPS 256 /**< opcodes covered by the support probe */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Records which of the first 64 opcodes @p ring's kernel supports.
+ *
+ * Kernels from before the probe (5.6) support none of those the shell uses,
+ * so a failed probe leaves the bitmap empty.
+ */
+static void SH_UringProbe(SH_Uring * const ring)
+{
+        struct io_uring_probe *probe;
+        size_t size;
+
+        ring->ops = 0;
+
+        size = sizeof *probe
+               + SH_URING_PROBE_OPS * sizeof(struct io_uring_probe_op);
+        probe = calloc(1, size);
+        if (probe == NULL) {
+                return;
+        }
+
+        if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE,
+                    probe, SH_URING_PROBE_OPS) == 0) {
+                for (unsigned op = 0; op < probe->ops_len && op < 64; op++) {
+                        if (probe->ops[op].flags & IO_URING_OP_SUPPORTED) {
+                                ring->ops |= UINT64_C(1) << op;
+                        }
+                }
+        }
+
+        free(probe);
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * CONSTRUCTORS + DESTRUCTORS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Uring *SH_CreateUring(unsigned const entries)
+{
+        SH_Uring *ring;
+        struct io_uring_params params;
+        char *base;
+        size_t sq_size, cq_size;
+        int fd, err;
+
+        memset(&params, 0, sizeof params);
+
+        errno = 0;
+        fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+        if (fd == -1) {
+                return NULL;
+        }
+
+        /* Older kernels map the queues separately; not worth supporting. */
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+                close(fd);
+                errno = ENOSYS;
+                return NULL;
+        }
+
+        ring = malloc(sizeof *ring);
+        if (ring == NULL) {
+                close(fd);
+                return NULL;
+        }
+        ring->fd = fd;
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes
+                  + params.cq_entries * sizeof(struct io_uring_cqe);
+        ring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+        ring->ring = mmap(NULL, ring->ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (ring->ring == MAP_FAILED) {
+                goto fail_ring;
+        }
+
+        ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (ring->sqes == MAP_FAILED) {
+                goto fail_sqes;
+        }
+
+        base = ring->ring;
+        ring->sq_head = (unsigned *) (base + params.sq_off.head);
+        ring->sq_tail = (unsigned *) (base + params.sq_off.tail);
+        ring->sq_array = (unsigned *) (base + params.sq_off.array);
+        ring->sq_mask = *(unsigned *) (base + params.sq_off.ring_mask);
+        ring->sq_entries = params.sq_entries;
+        ring->cq_head = (unsigned *) (base + params.cq_off.head);
+        ring->cq_tail = (unsigned *) (base + params.cq_off.tail);
+        ring->cqes = (struct io_uring_cqe *) (base + params.cq_off.cqes);
+        ring->cq_mask = *(unsigned *) (base + params.cq_off.ring_mask);
+        ring->queued = 0;
+
+        SH_UringProbe(ring);
+
+        return ring;
+
+fail_sqes:
+        err = errno;
+        munmap(ring->ring, ring->ring_size);
+        errno = err;
+fail_ring:
+        err = errno;
+        close(fd);
+        free(ring);
+        errno = err;
+        return NULL;
+}
+
+void SH_DestroyUring(SH_Uring **ring)
+{
+        if (*ring) {
+                munmap((*ring)->sqes, (*ring)->sqes_size);
+                munmap((*ring)->ring, (*ring)->ring_size);
+                close((*ring)->fd);
+
+                free(*ring);
+                *ring = NULL;
+        }
+}
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+bool SH_UringSupports(SH_Uring const * const ring, unsigned const op)
+{
+        return op < 64 && (ring->ops & (UINT64_C(1) << op));
+}
+
+struct io_uring_sqe *SH_UringGetSqe(SH_Uring * const ring)
+{
+        struct io_uring_sqe *sqe;
+        unsigned head, tail;
+
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        tail = *ring->sq_tail;
+        if (tail - head >= ring->sq_entries) {
+                return NULL;
+        }
+
+        sqe = &ring->sqes[tail & ring->sq_mask];
+        memset(sqe, 0, sizeof *sqe);
+        ring->sq_array[tail & ring->sq_mask] = tail & ring->sq_mask;
+
+        /* The kernel only reads the entry once it is submitted. */
+        __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ring->queued++;
+
+        return sqe;
+}
+
+int SH_UringSubmitAndWait(SH_Uring * const ring, unsigned const wait_nr)
+{
+        unsigned flags;
+        long submitted;
+
+        flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+        errno = 0;
+        submitted = syscall(__NR_io_uring_enter, ring->fd, ring->queued,
+                            wait_nr, flags, NULL, 0);
+        if (submitted == -1) {
+                return -1;
+        }
+        ring->queued -= (unsigned) submitted;
+
+        return (int) submitted;
+}
+
+bool SH_UringNextCqe(SH_Uring * const ring, struct io_uring_cqe * const cqe)
+{
+        unsigned head, tail;
+
+        head = *ring->cq_head;
+        tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+                return false;
+        }
+
+        *cqe = ring->cqes[head & ring->cq_mask];
+        __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+        return true;
+}
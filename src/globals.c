@@ -0,0 +1,64 @@
+/**
+ * @file globals.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Shell global variables.
+ *
+ * Kept apart from the shell's entry point, so that the rest of the shell can
+ * be linked into benchmarks and tests that provide their own @c main.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "error.h"
+#include "events/events.h"
+#include "globals.h"
+#include "job-control/job-control.h"
+
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+volatile int smallsh_errno = 0;
+bool smallsh_line_buffer = false;
+int smallsh_interactive_mode = 0;
+bool smallsh_capturing = false;
+int smallsh_fg_only_mode = 0;
+bool smallsh_init_mode = false;
+volatile sig_atomic_t smallsh_init_signal = 0;
+volatile sig_atomic_t smallsh_fg_pgid = 0;
+SH_JobTable *job_table = NULL;
+int smallsh_shell_terminal = 0;
+int smallsh_shell_pgid = 0;
+uint64_t smallsh_stmt_begin = 0;
+SH_Channel *sigchld_channel = NULL;
+SH_Channel *signal_channel = NULL;
+SH_Receiver *receiver = NULL;
+SH_Sender *sender = NULL;
@@ -0,0 +1,892 @@
+/**
+ * @file bytecode.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For compiling parsed scripts into bytecode, and running it.
+ *
+ * A script's statements are lowered into a flat instruction stream, followed
+ * by a table of the strings it references. The compiled image is
+ * position-independent, so it can be written to a cache file as-is, and later
+ * mapped straight back into memory and run without lexing or parsing the
+ * script again. Cache files are keyed by a hash of the script's contents.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "builtins/builtins.h"
+#include "interpreter/bytecode.h"
+#include "interpreter/parser.h"
+#include "job-control/job-control.h"
+#include "job-control/prepare.h"
+#include "utils/buffer.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Growable, NULL-terminated list of words collected while running a
+ * statement's instructions.
+ */
+typedef struct {
+        size_t n; /**< number of words */
+        size_t cap; /**< number of words allocated, including terminator */
+        char **words; /**< word list */
+} SH_BytecodeWords;
+
+/**
+ * @brief A statement assembled from its instructions, ready to execute.
+ */
+typedef struct {
+        SH_BytecodeInsn const *begin; /**< first instruction of statement */
+        SH_BytecodeInsn const *exec; /**< EXEC instruction */
+        SH_BytecodeWords args; /**< command arguments */
+        SH_BytecodeWords ins; /**< stdin redirections */
+        SH_BytecodeWords outs; /**< output redirections */
+        IORedirType *out_types; /**< type of each output redirection */
+        SH_BytecodeWords owned; /**< expanded words, to free after executing */
+} SH_BytecodeSlot;
+
+/**
+ * @brief Run-time state of a program, with a ready queue of statements
+ * assembled ahead of time.
+ */
+typedef struct {
+        SH_Bytecode const *bc; /**< program being run */
+        SH_BytecodeInsn const *pc; /**< next instruction to assemble */
+        size_t head; /**< slot of next statement to execute */
+        size_t n_ready; /**< number of statements assembled */
+        SH_BytecodeSlot slots[SH_BYTECODE_PREFETCH]; /**< ready queue */
+} SH_BytecodeVM;
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Points @p bc's header, instructions, and string table into its image.
+ */
+static void SH_BytecodeBind(SH_Bytecode * const bc)
+{
+        char const *image = bc->image;
+
+        bc->header = (SH_BytecodeHeader const *) image;
+        bc->insns = (SH_BytecodeInsn const *) &image[sizeof *bc->header];
+        bc->strtab = (char const *) &bc->insns[bc->header->n_insns];
+}
+
+/**
+ * @brief Checks that @p bc's image is well-formed and was compiled from script
+ * contents hashing to @p hash, so that it is safe to run.
+ * @return true if valid, false otherwise
+ */
+static bool SH_BytecodeValidate(SH_Bytecode const * const bc,
+                                uint64_t const hash)
+{
+        SH_BytecodeHeader const *header;
+        SH_BytecodeInsn const *insn;
+        uint64_t expected;
+
+        if (bc->size < sizeof *header) {
+                return false;
+        }
+
+        header = bc->image;
+        if (memcmp(header->magic, SH_BYTECODE_MAGIC, sizeof header->magic) != 0
+            || header->version != SH_BYTECODE_VERSION
+            || header->hash != hash
+            || header->n_insns == 0) {
+                return false;
+        }
+
+        expected = sizeof *header
+                + (uint64_t) header->n_insns * sizeof *insn
+                + header->strtab_size;
+        if (expected != bc->size) {
+                return false;
+        }
+        if (header->strtab_size > 0
+            && ((char const *) bc->image)[bc->size - 1] != '\0') {
+                return false;
+        }
+
+        /* Program must end exactly once, at the end. */
+        insn = (SH_BytecodeInsn const *) &header[1];
+        for (uint32_t i = 0; i < header->n_insns; i++, insn++) {
+                if (insn->op >= OP_COUNT
+                    || (insn->op == OP_END) != (i == header->n_insns - 1)) {
+                        return false;
+                }
+                if (insn->op == OP_REDIR
+                    && (insn->redir > IOREDIR_BOTH
+                        || (insn->redir == IOREDIR_STDIN)
+                           != ((insn->flags & OPFLAGS_STDOUT) == 0))) {
+                        return false;
+                }
+
+                /* Only '2>&1' has no operand. */
+                if (insn->op != OP_END && insn->str >= header->strtab_size
+                    && !(insn->op == OP_REDIR
+                         && insn->redir == IOREDIR_STDERR_TO_STDOUT)) {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+/**
+ * @brief Appends an instruction to @p insns.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeEmit(SH_Buffer * const insns, SH_BytecodeOp const op,
+                           unsigned int const flags, IORedirType const redir,
+                           uint32_t const str)
+{
+        SH_BytecodeInsn insn;
+
+        insn.op = (uint8_t) op;
+        insn.flags = (uint8_t) flags;
+        insn.redir = (uint16_t) redir;
+        insn.str = str;
+
+        return SH_BufferAppend(insns, (char const *) &insn, sizeof insn);
+}
+
+/**
+ * @brief Appends the first @p n bytes of @p str to @p strtab as a
+ * NUL-terminated string.
+ * @param off output param for offset of string in @p strtab
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeAddString(SH_Buffer * const strtab, char const *str,
+                                size_t const n, uint32_t * const off)
+{
+        if (strtab->len + n + 1 > UINT32_MAX) {
+                return -1;
+        }
+        *off = (uint32_t) strtab->len;
+
+        if (SH_BufferAppend(strtab, str, n) == -1
+            || SH_BufferAppend(strtab, "", 1) == -1) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Appends an instruction for word @p word to @p insns, adding the word
+ * to @p strtab.
+ *
+ * A @c NULL @p word, as for '2>&1', is emitted without an operand.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeEmitWord(SH_Buffer * const insns,
+                               SH_Buffer * const strtab,
+                               SH_BytecodeOp const op, unsigned int flags,
+                               IORedirType const redir,
+                               char const * const word)
+{
+        uint32_t off;
+
+        if (word == NULL) {
+                return SH_BytecodeEmit(insns, op, flags, redir, 0);
+        }
+
+        if (SH_BytecodeAddString(strtab, word, strlen(word), &off) == -1) {
+                return -1;
+        }
+
+        /* Words without variables are used as-is at run time. */
+        if (strstr(word, "$(") != NULL) {
+                flags |= OPFLAGS_SUBST;
+        } else if (strchr(word, '$') != NULL) {
+                flags |= OPFLAGS_EXPAND;
+        }
+
+        return SH_BytecodeEmit(insns, op, flags, redir, off);
+}
+
+/**
+ * @brief Lowers a single script statement into instructions.
+ * @param text_off input/output param for string table offset of the last
+ * statement's source line, shared by statements on the same line
+ * @param last_text input/output param for the last statement's source line
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeCompileStatement(SH_Buffer * const insns,
+                                       SH_Buffer * const strtab,
+                                       SH_ScriptStmt const * const sstmt,
+                                       uint32_t * const text_off,
+                                       char const ** const last_text)
+{
+        SH_Statement const *stmt = sstmt->stmt;
+        unsigned int flags;
+
+        for (size_t i = 0; i < stmt->cmd->count; i++) {
+                if (SH_BytecodeEmitWord(insns, strtab, OP_ARG, OPFLAGS_NONE,
+                                        IOREDIR_STDIN,
+                                        stmt->cmd->args[i]) == -1) {
+                        return -1;
+                }
+        }
+        for (size_t i = 0; i < stmt->infile->n; i++) {
+                if (SH_BytecodeEmitWord(insns, strtab, OP_REDIR, OPFLAGS_NONE,
+                                        IOREDIR_STDIN,
+                                        stmt->infile->streams[i]) == -1) {
+                        return -1;
+                }
+        }
+        for (size_t i = 0; i < stmt->outfile->n; i++) {
+                if (SH_BytecodeEmitWord(insns, strtab, OP_REDIR,
+                                        OPFLAGS_STDOUT,
+                                        stmt->outfile->types[i],
+                                        stmt->outfile->streams[i]) == -1) {
+                        return -1;
+                }
+        }
+
+        if (sstmt->text != *last_text) {
+                if (SH_BytecodeAddString(strtab, sstmt->text, sstmt->len,
+                                         text_off) == -1) {
+                        return -1;
+                }
+                *last_text = sstmt->text;
+        }
+
+        flags = OPFLAGS_NONE;
+        if ((stmt->flags & FLAGS_BGCTRL) != 0) {
+                flags |= OPFLAGS_BGCTRL;
+        }
+
+        return SH_BytecodeEmit(insns, OP_EXEC, flags, IOREDIR_STDIN, *text_off);
+}
+
+/**
+ * @brief Appends @p word to @p list, keeping it NULL-terminated.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeWordsPush(SH_BytecodeWords * const list, char *word)
+{
+        char **tmp;
+
+        if (list->n + 1 >= list->cap) {
+                list->cap = list->cap > 0 ? list->cap * 2 : 8;
+                tmp = realloc(list->words, list->cap * sizeof(*tmp));
+                if (tmp == NULL) {
+                        return -1;
+                }
+                list->words = tmp;
+        }
+        list->words[list->n++] = word;
+        list->words[list->n] = NULL;
+
+        return 0;
+}
+
+/**
+ * @brief Frees every word in @p list, and empties it.
+ */
+static void SH_BytecodeWordsFree(SH_BytecodeWords * const list)
+{
+        for (size_t i = 0; i < list->n; i++) {
+                free(list->words[i]);
+        }
+        list->n = 0;
+}
+
+/**
+ * @brief Empties @p slot for reuse, freeing its expanded words.
+ */
+static void SH_BytecodeSlotClear(SH_BytecodeSlot * const slot)
+{
+        SH_BytecodeWordsFree(&slot->owned);
+        slot->args.n = 0;
+        slot->ins.n = 0;
+        slot->outs.n = 0;
+        slot->begin = NULL;
+        slot->exec = NULL;
+}
+
+/**
+ * @brief Empties @p slot and frees its word lists.
+ */
+static void SH_BytecodeSlotFree(SH_BytecodeSlot * const slot)
+{
+        SH_BytecodeSlotClear(slot);
+        free(slot->args.words);
+        free(slot->ins.words);
+        free(slot->outs.words);
+        free(slot->out_types);
+        free(slot->owned.words);
+        memset(slot, 0, sizeof *slot);
+}
+
+/**
+ * @brief Appends output redirection @p word of type @p type to @p slot.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeSlotPushOut(SH_BytecodeSlot * const slot, char *word,
+                                  IORedirType const type)
+{
+        IORedirType *tmp;
+        size_t cap;
+
+        cap = slot->outs.cap;
+        if (SH_BytecodeWordsPush(&slot->outs, word) == -1) {
+                return -1;
+        }
+
+        /* Types are kept as long as words, so they grow together. */
+        if (slot->outs.cap != cap) {
+                tmp = realloc(slot->out_types, slot->outs.cap * sizeof(*tmp));
+                if (tmp == NULL) {
+                        slot->outs.n--;
+                        return -1;
+                }
+                slot->out_types = tmp;
+        }
+        slot->out_types[slot->outs.n - 1] = type;
+
+        return 0;
+}
+
+/**
+ * @brief Expands @p word, and records the result to be freed along with
+ * @p slot.
+ * @return expanded word on success, @c NULL on failure
+ */
+static char *SH_BytecodeSlotExpand(SH_BytecodeSlot * const slot,
+                                   char * const word)
+{
+        char *expanded;
+
+        expanded = SH_ParserExpandWord(word);
+        if (expanded == NULL) {
+                return NULL;
+        }
+        if (SH_BytecodeWordsPush(&slot->owned, expanded) == -1) {
+                free(expanded);
+                return NULL;
+        }
+
+        return expanded;
+}
+
+/**
+ * @brief Assembles the next statement of @p vm's program into the back of its
+ * ready queue.
+ *
+ * Words are expanded, except for command substitutions, which are left for
+ * @c SH_BytecodeSubstitute.
+ * @return 1 if a statement was assembled, 0 at end of program or if the queue
+ * is full, -1 on failure
+ */
+static int SH_BytecodeAssemble(SH_BytecodeVM * const vm)
+{
+        SH_BytecodeSlot *slot;
+        SH_BytecodeInsn const *insn;
+        SH_BytecodeWords *list;
+        char *word;
+
+        if (vm->n_ready == SH_BYTECODE_PREFETCH || vm->pc->op == OP_END) {
+                return 0;
+        }
+
+        slot = &vm->slots[(vm->head + vm->n_ready) % SH_BYTECODE_PREFETCH];
+        slot->begin = vm->pc;
+        for (insn = vm->pc; insn->op == OP_ARG || insn->op == OP_REDIR;
+             insn++) {
+                if (insn->op == OP_REDIR
+                    && insn->redir == IOREDIR_STDERR_TO_STDOUT) {
+                        word = NULL;
+                } else {
+                        word = (char *) &vm->bc->strtab[insn->str];
+                }
+                if ((insn->flags & OPFLAGS_EXPAND) != 0) {
+                        word = SH_BytecodeSlotExpand(slot, word);
+                        if (word == NULL) {
+                                goto error;
+                        }
+                }
+
+                if (insn->op == OP_ARG) {
+                        list = &slot->args;
+                } else if ((insn->flags & OPFLAGS_STDOUT) != 0) {
+                        if (SH_BytecodeSlotPushOut(slot, word,
+                                                   insn->redir) == -1) {
+                                goto error;
+                        }
+                        continue;
+                } else {
+                        list = &slot->ins;
+                }
+                if (SH_BytecodeWordsPush(list, word) == -1) {
+                        goto error;
+                }
+        }
+
+        /* Statement must end by executing a command. */
+        if (insn->op != OP_EXEC || slot->args.n == 0) {
+                goto error;
+        }
+        slot->exec = insn;
+
+        vm->pc = insn + 1;
+        vm->n_ready++;
+
+        return 1;
+
+error:
+        SH_BytecodeSlotClear(slot);
+        return -1;
+}
+
+/**
+ * @brief Expands the command substitutions in @p slot's statement, which is
+ * about to run.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_BytecodeSubstitute(SH_BytecodeSlot * const slot)
+{
+        SH_BytecodeInsn const *insn;
+        SH_BytecodeWords *list;
+        size_t n_args, n_ins, n_outs, *idx;
+        char *word;
+
+        n_args = n_ins = n_outs = 0;
+        for (insn = slot->begin; insn != slot->exec; insn++) {
+                if (insn->op == OP_ARG) {
+                        list = &slot->args;
+                        idx = &n_args;
+                } else if ((insn->flags & OPFLAGS_STDOUT) != 0) {
+                        list = &slot->outs;
+                        idx = &n_outs;
+                } else {
+                        list = &slot->ins;
+                        idx = &n_ins;
+                }
+
+                if ((insn->flags & OPFLAGS_SUBST) != 0) {
+                        word = SH_BytecodeSlotExpand(slot, list->words[*idx]);
+                        if (word == NULL) {
+                                return -1;
+                        }
+                        list->words[*idx] = word;
+                }
+                (*idx)++;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Speculatively prepares the program and input file of @p slot's
+ * statement, where they are already known.
+ */
+static void SH_BytecodePrepare(SH_BytecodeSlot const * const slot)
+{
+        SH_BytecodeInsn const *insn, *in;
+
+        if (SH_IsBuiltin(slot->args.words[0])) {
+                return;
+        }
+
+        if ((slot->begin->flags & OPFLAGS_SUBST) == 0) {
+                SH_PrepareCommand(slot->args.words[0]);
+        }
+
+        /* Only the last input redirection takes effect. */
+        in = NULL;
+        for (insn = slot->begin; insn != slot->exec; insn++) {
+                if (insn->op == OP_REDIR
+                    && (insn->flags & OPFLAGS_STDOUT) == 0) {
+                        in = insn;
+                }
+        }
+        if (in != NULL && (in->flags & OPFLAGS_SUBST) == 0) {
+                SH_PrepareInput(slot->ins.words[slot->ins.n - 1]);
+        }
+}
+
+/**
+ * @brief Fills @p ctx's ready queue while a foreground job runs, and prepares
+ * the statement that will run next.
+ *
+ * Failures are left for the main loop to run into, and report, when it gets
+ * to the statement itself.
+ * @param ctx @c SH_BytecodeVM object
+ */
+static void SH_BytecodePrefetch(void * const ctx)
+{
+        SH_BytecodeVM *vm = ctx;
+
+        while (SH_BytecodeAssemble(vm) == 1)
+                ;
+
+        /* Head of the queue is the statement running now. */
+        if (vm->n_ready > 1) {
+                SH_BytecodePrepare(
+                        &vm->slots[(vm->head + 1) % SH_BYTECODE_PREFETCH]);
+        }
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * CONSTRUCTORS + DESTRUCTORS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Bytecode *SH_CreateBytecode(SH_Script const * const script,
+                               uint64_t const hash)
+{
+        SH_Bytecode *bc;
+        SH_BytecodeHeader header;
+        SH_Buffer *insns, *strtab;
+        char const *last_text;
+        uint32_t text_off;
+        int status;
+
+        insns = SH_CreateBuffer(0);
+        strtab = SH_CreateBuffer(script->size + 1);
+        bc = calloc(1, sizeof *bc);
+        if (insns == NULL || strtab == NULL || bc == NULL) {
+                status = -1;
+                goto done;
+        }
+
+        /* Lower statements. */
+        status = 0;
+        last_text = NULL;
+        text_off = 0;
+        for (size_t i = 0; i < script->n_stmts && status == 0; i++) {
+                status = SH_BytecodeCompileStatement(insns, strtab,
+                                                     &script->stmts[i],
+                                                     &text_off, &last_text);
+        }
+        if (status == 0) {
+                status = SH_BytecodeEmit(insns, OP_END, OPFLAGS_NONE,
+                                         IOREDIR_STDIN, 0);
+        }
+        if (status == -1) {
+                goto done;
+        }
+
+        /* Lay out image: header, then instructions, then strings. */
+        memset(&header, 0, sizeof header);
+        memcpy(header.magic, SH_BYTECODE_MAGIC, sizeof header.magic);
+        header.version = SH_BYTECODE_VERSION;
+        header.hash = hash;
+        header.n_insns = (uint32_t) (insns->len / sizeof(SH_BytecodeInsn));
+        header.strtab_size = (uint32_t) strtab->len;
+
+        bc->size = sizeof header + insns->len + strtab->len;
+        bc->image = malloc(bc->size);
+        if (bc->image == NULL) {
+                status = -1;
+                goto done;
+        }
+        memcpy(bc->image, &header, sizeof header);
+        memcpy((char *) bc->image + sizeof header, insns->data, insns->len);
+        memcpy((char *) bc->image + sizeof header + insns->len, strtab->data,
+               strtab->len);
+        bc->mapped = false;
+        SH_BytecodeBind(bc);
+
+done:
+        SH_DestroyBuffer(&insns);
+        SH_DestroyBuffer(&strtab);
+        if (status == -1) {
+                SH_DestroyBytecode(&bc);
+        }
+
+        return bc;
+}
+
+SH_Bytecode *SH_LoadBytecode(char const * const path, uint64_t const hash)
+{
+        SH_Bytecode *bc;
+        struct stat st;
+        void *image;
+        int fd;
+
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+                return NULL;
+        }
+        if (fstat(fd, &st) == -1 || st.st_size <= 0) {
+                close(fd);
+                return NULL;
+        }
+
+        image = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (image == MAP_FAILED) {
+                return NULL;
+        }
+
+        bc = calloc(1, sizeof *bc);
+        if (bc == NULL) {
+                munmap(image, (size_t) st.st_size);
+                return NULL;
+        }
+        bc->image = image;
+        bc->size = (size_t) st.st_size;
+        bc->mapped = true;
+
+        if (!SH_BytecodeValidate(bc, hash)) {
+                SH_DestroyBytecode(&bc);
+                return NULL;
+        }
+        SH_BytecodeBind(bc);
+
+        return bc;
+}
+
+void SH_DestroyBytecode(SH_Bytecode **bc)
+{
+        if (*bc) {
+                if ((*bc)->mapped) {
+                        munmap((*bc)->image, (*bc)->size);
+                } else {
+                        free((*bc)->image);
+                }
+                (*bc)->image = NULL;
+                (*bc)->size = 0;
+
+                free(*bc);
+                *bc = NULL;
+        }
+}
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+uint64_t SH_BytecodeHash(void const * const data, size_t const n)
+{
+        unsigned char const *bytes = data;
+        uint64_t hash = UINT64_C(14695981039346656037);
+
+        for (size_t i = 0; i < n; i++) {
+                hash ^= bytes[i];
+                hash *= UINT64_C(1099511628211);
+        }
+
+        return hash;
+}
+
+int SH_BytecodeCachePath(uint64_t const hash, char * const path,
+                         size_t const size)
+{
+        char dir[PATH_MAX];
+        char const *env;
+        int n;
+
+        if ((env = getenv("SMALLSH_CACHE_DIR")) != NULL) {
+                if (*env == '\0') {
+                        return -1; /* caching disabled */
+                }
+                n = snprintf(dir, sizeof dir, "%s", env);
+        } else if ((env = getenv("XDG_CACHE_HOME")) != NULL && *env != '\0') {
+                n = snprintf(dir, sizeof dir, "%s/smallsh", env);
+        } else if ((env = getenv("HOME")) != NULL && *env != '\0') {
+                n = snprintf(dir, sizeof dir, "%s/.cache", env);
+                if (n > 0 && (size_t) n < sizeof dir) {
+                        mkdir(dir, 0700);
+                }
+                n = snprintf(dir, sizeof dir, "%s/.cache/smallsh", env);
+        } else {
+                return -1;
+        }
+        if (n < 0 || (size_t) n >= sizeof dir) {
+                return -1;
+        }
+
+        if (mkdir(dir, 0700) == -1 && errno != EEXIST) {
+                return -1;
+        }
+
+        n = snprintf(path, size, "%s/%016" PRIx64 ".shbc", dir, hash);
+        if (n < 0 || (size_t) n >= size) {
+                return -1;
+        }
+
+        return 0;
+}
+
+int SH_BytecodeSave(SH_Bytecode const * const bc, char const * const path)
+{
+        char tmp_path[PATH_MAX];
+        char const *ptr;
+        size_t left;
+        ssize_t n_written;
+        int fd, n;
+
+        n = snprintf(tmp_path, sizeof tmp_path, "%s.XXXXXX", path);
+        if (n < 0 || (size_t) n >= sizeof tmp_path) {
+                return -1;
+        }
+
+        fd = mkostemp(tmp_path, O_CLOEXEC);
+        if (fd == -1) {
+                return -1;
+        }
+
+        ptr = bc->image;
+        left = bc->size;
+        while (left > 0) {
+                n_written = write(fd, ptr, left);
+                if (n_written == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        break;
+                }
+                ptr += n_written;
+                left -= (size_t) n_written;
+        }
+
+        if (close(fd) == -1 || left > 0 || rename(tmp_path, path) == -1) {
+                unlink(tmp_path);
+                return -1;
+        }
+
+        return 0;
+}
+
+int SH_BytecodeRun(SH_Bytecode const * const bc, SH_BytecodeExecFn const exec,
+                   void * const ctx)
+{
+        SH_BytecodeVM vm;
+        SH_BytecodeSlot *slot;
+        StmtCmd cmd;
+        StmtStdin infile;
+        StmtStdout outfile;
+        SH_Statement stmt = { &cmd, &infile, &outfile, FLAGS_NONE };
+        int status;
+
+        memset(&vm, 0, sizeof vm);
+        vm.bc = bc;
+        vm.pc = bc->insns;
+
+        SH_JobControlSetWaitHook(SH_BytecodePrefetch, &vm);
+
+        status = 0;
+        while (status == 0) {
+                /* Nothing was assembled ahead of time, so do it now. */
+                if (vm.n_ready == 0) {
+                        status = SH_BytecodeAssemble(&vm);
+                        if (status != 1) {
+                                break; /* end of program, or error */
+                        }
+                        status = 0;
+                }
+
+                slot = &vm.slots[vm.head];
+                if (SH_BytecodeSubstitute(slot) == -1) {
+                        status = -1;
+                        break;
+                }
+
+                cmd.count = slot->args.n;
+                cmd.args = slot->args.words;
+                infile.n = slot->ins.n;
+                infile.streams = slot->ins.words;
+                outfile.n = slot->outs.n;
+                outfile.streams = slot->outs.words;
+                outfile.types = slot->out_types;
+
+                stmt.flags = FLAGS_NONE;
+                if ((slot->exec->flags & OPFLAGS_BGCTRL) != 0) {
+                        stmt.flags |= FLAGS_BGCTRL;
+                }
+                if (SH_IsBuiltin(cmd.args[0])) {
+                        stmt.flags |= FLAGS_BUILTIN;
+                }
+
+                /* Following statements may be assembled while this runs. */
+                status = exec(&stmt, (char *) &bc->strtab[slot->exec->str],
+                              ctx);
+
+                SH_BytecodeSlotClear(slot);
+                vm.head = (vm.head + 1) % SH_BYTECODE_PREFETCH;
+                vm.n_ready--;
+        }
+
+        SH_JobControlSetWaitHook(NULL, NULL);
+
+        for (size_t i = 0; i < SH_BYTECODE_PREFETCH; i++) {
+                SH_BytecodeSlotFree(&vm.slots[i]);
+        }
+
+        return status;
+}
@@ -45,17 +45,20 @@ size_t SH_LexerGenerateTokens(char * const buf, size_t const max_tok,
 
         iter = SH_CreateStringIterator(buf);
         size_t count = 0; // number of tokens consumed
-        char c1, c2;
+        char c1, c2, c3, c4, c5;
 
         while (SH_StringIteratorHasNext(iter)) {
-                if (count > max_tok) {
+                if (count >= max_tok) {
                         // no more space for tokens
                         break;
                 }
 
-                // peek ahead to next two characters
+                // peek ahead far enough to tell the longest operator apart
                 c1 = SH_StringIteratorPeek(iter, 0);
                 c2 = SH_StringIteratorPeek(iter, 1);
+                c3 = SH_StringIteratorPeek(iter, 2);
+                c4 = SH_StringIteratorPeek(iter, 3);
+                c5 = SH_StringIteratorPeek(iter, 4);
 
                 // tokenize value
                 if (IS_WHITESPACE(c1)) {
@@ -76,6 +79,19 @@ size_t SH_LexerGenerateTokens(char * const buf, size_t const max_tok,
                 } else if (IS_OUTPUT_REDIR_OP(c1, c2)) {
                         // token is an output redirection operator
                         toks[count] = SH_CreateToken(TOK_REDIR_OUTPUT);
+                } else if (IS_APPEND_REDIR_OP(c1, c2, c3)) {
+                        // token is an appending output redirection operator
+                        toks[count] = SH_CreateToken(TOK_REDIR_APPEND);
+                } else if (IS_STDERR_REDIR_OP(c1, c2, c3)) {
+                        // token is an error redirection operator
+                        toks[count] = SH_CreateToken(TOK_REDIR_STDERR);
+                } else if (IS_STDERR_TO_STDOUT_REDIR_OP(c1, c2, c3, c4, c5)) {
+                        // token is an error to output redirection operator
+                        toks[count] =
+                                SH_CreateToken(TOK_REDIR_STDERR_TO_STDOUT);
+                } else if (IS_BOTH_REDIR_OP(c1, c2, c3)) {
+                        // token is an output and error redirection operator
+                        toks[count] = SH_CreateToken(TOK_REDIR_BOTH);
                 } else if (IS_BG_CTRL_OP(c1, c2)) {
                         // token is a background control operator
                         toks[count] = SH_CreateToken(TOK_CTRL_BG);
@@ -91,6 +107,12 @@ consume_word:
                 // consume token
                 SH_TakeToken(toks[count], iter);
                 count++;
+
+                // rest of line is a comment, or belongs to the next line
+                if (toks[count - 1]->type == TOK_CMT
+                    || toks[count - 1]->type == TOK_CTRL_NEWLINE) {
+                        break;
+                }
         }
 
         return count;
@@ -6,15 +6,19 @@
  */
 #include <sys/types.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
 #include <unistd.h>
 #include <stdint.h>
 
 #include "builtins/builtins.h"
+#include "error.h"
 #include "interpreter/lexer.h"
 #include "interpreter/parser.h"
+#include "interpreter/substitution.h"
 #include "interpreter/token-iterator.h"
+#include "trace/trace.h"
 /* *****************************************************************************
  * PRIVATE DEFINITIONS
  *
@@ -45,16 +49,53 @@
  *
  *
  ******************************************************************************/
+/**
+ * @brief Returns the value of word token @p tok for storing in a statement.
+ *
+ * The word is expanded, unless expansion is deferred, in which case the
+ * token's value is handed over as-is.
+ * @param parser @c Parser object
+ * @param tok word token to take value from
+ * @return word string
+ */
+static char *SH_ParserTakeWord(SH_Parser *const parser, SH_Token *const tok)
+{
+        char *word;
+
+        if (!parser->defer_expansion) {
+                return SH_ParserExpandWord(tok->value);
+        }
+
+        word = tok->value;
+        tok->value = NULL;
+        return word;
+}
+
+/**
+ * @brief Records a syntax error near token @p tok.
+ * @param parser @c Parser object
+ * @param tok token the error was found at
+ * @return -1
+ */
+static int SH_ParserSyntaxError(SH_Parser *const parser,
+                                SH_Token const *const tok)
+{
+        parser->error = tok->type == TOK_CTRL_NEWLINE ? "newline" : tok->value;
+        return -1;
+}
+
 /**
  * @brief Parses a command into @p stmt command statement.
+ * @param parser @c Parser object
  * @param stmt @c Statement object to add command to
  * @param iter iterator to extract command tokens from
  * @return 0 on success, -1 on failure
  */
-static int SH_ParserParseCmd(SH_Statement *stmt, SH_TokenIterator * const iter)
+static int SH_ParserParseCmd(SH_Parser *const parser, SH_Statement *stmt,
+                             SH_TokenIterator * const iter)
 {
-        // parse words into statement command
-        size_t buf_size = 1;
+        // parse words into statement command; args holds count + 1 already
+        size_t buf_size = stmt->cmd->count + 1;
 
         while (SH_TokenIteratorHasNext(iter)) {
                 SH_Token *tok1, *tok2;
@@ -86,7 +127,7 @@ static int SH_ParserParseCmd(SH_Statement *stmt, SH_TokenIterator * const iter)
 
                 // take word
                 stmt->cmd->args[stmt->cmd->count++] =
-                        SH_ParserExpandWord(SH_TokenIteratorNext(iter)->value);
+                        SH_ParserTakeWord(parser, SH_TokenIteratorNext(iter));
         }
 
         // resize array to fit exactly argc + 1 elements for later use with exec
@@ -109,35 +150,44 @@ static int SH_ParserParseCmd(SH_Statement *stmt, SH_TokenIterator * const iter)
 }
 
 /**
- * @brief Parses an io redirection command into @p stmt command statement.
- * @param stmt @c Statement object to add io redirection command to
- * @param iter iterator to extract io redirection tokens from
- * @param type type of io redirection to store
+ * @brief Parses an io redirection into @p stmt.
+ * @param parser @c Parser object
+ * @param stmt @c Statement object to add redirection to
+ * @param iter iterator positioned at redirection operator
+ * @param type stream being redirected
  * @return 0 on success, -1 on failure
  */
-static int SH_ParserParseIoRedir(SH_Statement *stmt,
+static int SH_ParserParseIoRedir(SH_Parser *const parser, SH_Statement *stmt,
                                  SH_TokenIterator *const iter,
                                  IORedirType const type)
 {
-        // filename should be a word token
-        SH_Token *tok = SH_TokenIteratorPeek(iter, 1);
-        if (tok->type != TOK_WORD) {
-                return -1; // error
+        SH_Token *wt = NULL;
+
+        // '2>&1' names no file; every other operator is followed by one
+        if (type != IOREDIR_STDERR_TO_STDOUT) {
+                // filename should be a word token
+                SH_Token *tok = SH_TokenIteratorPeek(iter, 1);
+                if (tok->type != TOK_WORD) {
+                        return SH_ParserSyntaxError(parser, tok);
+                }
         }
 
         // skip past redirection operator
         (void) SH_TokenIteratorNext(iter);
 
         // take next word
-        SH_Token *wt = SH_TokenIteratorNext(iter);
+        if (type != IOREDIR_STDERR_TO_STDOUT) {
+                wt = SH_TokenIteratorNext(iter);
+        }
 
         // switch to type stream
         char **tmp;
+        IORedirType *types;
         switch (type) {
                 case IOREDIR_STDIN:
                         // take next word; extract word string into statement stdin
                         stmt->infile->streams[stmt->infile->n++] =
-                                SH_ParserExpandWord(wt->value);
+                                SH_ParserTakeWord(parser, wt);
 
                         // resize strings buf
                         tmp = realloc(stmt->infile->streams,
@@ -150,9 +200,23 @@ static int SH_ParserParseIoRedir(SH_Statement *stmt,
                                 stmt->infile->n] = NULL;
                         break;
                 case IOREDIR_STDOUT:
-                        // take next work; extract word string into statement stdout
+                case IOREDIR_APPEND:
+                case IOREDIR_STDERR:
+                case IOREDIR_STDERR_TO_STDOUT:
+                case IOREDIR_BOTH:
+                        // record type alongside the stream, in order given
+                        types = realloc(stmt->outfile->types,
+                                        (stmt->outfile->n + 1) * sizeof *types);
+                        if (types == NULL) {
+                                return -1; // error
+                        }
+                        stmt->outfile->types = types;
+                        stmt->outfile->types[stmt->outfile->n] = type;
+
+                        // take next word; extract word string into statement stdout
                         stmt->outfile->streams[stmt->outfile->n++] =
-                                SH_ParserExpandWord(wt->value);
+                                wt != NULL ? SH_ParserTakeWord(parser, wt)
+                                           : NULL;
 
                         // resize strings buf
                         tmp = realloc(stmt->outfile->streams,
@@ -172,7 +236,28 @@ static int SH_ParserParseIoRedir(SH_Statement *stmt,
 }
 
 /**
- * @brief Parses tokens into statements.
+ * @brief Maps a redirection operator token type to the redirection it makes.
+ */
+static IORedirType SH_ParserRedirType(SH_TokenType const type)
+{
+        switch (type) {
+                case TOK_REDIR_INPUT:
+                        return IOREDIR_STDIN;
+                case TOK_REDIR_APPEND:
+                        return IOREDIR_APPEND;
+                case TOK_REDIR_STDERR:
+                        return IOREDIR_STDERR;
+                case TOK_REDIR_STDERR_TO_STDOUT:
+                        return IOREDIR_STDERR_TO_STDOUT;
+                case TOK_REDIR_BOTH:
+                        return IOREDIR_BOTH;
+                default:
+                        return IOREDIR_STDOUT;
+        }
+}
+
+/**
+ * @brief Groups the parser's tokens into statements.
  * @param parser @c Parser object
  * @return number of statements created on success, -1 on failure
  */
@@ -185,99 +270,86 @@ static ssize_t SH_ParserParseStmts(SH_Parser *const parser)
 
         // initialize statements array
         size_t buf_size = 1;
-        SH_Statement **stmts = malloc(buf_size * sizeof(SH_Statement));
+        SH_Statement **stmts = malloc(buf_size * sizeof(SH_Statement *));
+        parser->stmts = stmts;
+        parser->n_stmts = 0;
 
         // evaluate tokens from iterator stream
         ssize_t cur = 1;
         ssize_t count = 0; // number of statements consumed
-        while (SH_TokenIteratorHasNext(iter)) {
+        int status = 0;
+        while (status == 0 && SH_TokenIteratorHasNext(iter)) {
                 if ((size_t) count >= buf_size) {
                         buf_size *= 2;
                         SH_Statement **tmp =
-                                realloc(stmts, buf_size * sizeof(SH_Statement));
+                                realloc(stmts, buf_size * sizeof(SH_Statement *));
                         if (tmp == NULL) {
-                                return -1; // error
+                                status = -1; // error
+                                break;
                         }
                         stmts = tmp;
+                        parser->stmts = stmts;
                 }
 
                 SH_Token *tok1 = SH_TokenIteratorPeek(iter, 0);
-#ifdef DEMO
-                SH_Token *tok2 = SH_TokenIteratorPeek(iter, 1);
-#endif
                 switch (tok1->type) {
                         case TOK_CMT:
-                                break; // done
+                                goto parse_fin; // rest of line is a comment
                         case TOK_CTRL_BG:
                         {
-#ifdef DEMO
-                                if (tok2->type == TOK_CTRL_NEWLINE) {
-                                        (void) SH_TokenIteratorNext(iter);
-                                        stmts[count - 1]->flags |= FLAGS_BGCTRL;
+                                // '&' must follow a command
+                                if (count < cur) {
+                                        status = SH_ParserSyntaxError(parser,
+                                                                      tok1);
                                         break;
                                 }
-#endif
-                                if (count == 0) {
-                                        // syntax error
-                                }
                                 (void) SH_TokenIteratorNext(iter);
                                 stmts[count - 1]->flags |= FLAGS_BGCTRL;
                                 cur++;
                                 break;
                         }
-                        case TOK_CTRL_NEWLINE:
-                        {
-                                if (count == 0) {
-                                        // empty line
-                                        break;
-                                }
-                                (void) SH_TokenIteratorNext(iter);
-                                cur++;
-                                break;
-                        }
                         case TOK_REDIR_INPUT:
-                        {
-                                if (stmts[count] == NULL) {
-                                        // syntax error
-                                }
-                                SH_ParserParseIoRedir(stmts[count - 1], iter,
-                                                      IOREDIR_STDIN);
-
-                                break;
-                        }
                         case TOK_REDIR_OUTPUT:
+                        case TOK_REDIR_APPEND:
+                        case TOK_REDIR_STDERR:
+                        case TOK_REDIR_STDERR_TO_STDOUT:
+                        case TOK_REDIR_BOTH:
                         {
-                                if (stmts[count] == NULL) {
-                                        // syntax error
+                                // redirection must follow a command
+                                if (count < cur) {
+                                        status = SH_ParserSyntaxError(parser,
+                                                                      tok1);
+                                        break;
                                 }
-                                SH_ParserParseIoRedir(stmts[count - 1], iter,
-                                                      IOREDIR_STDOUT);
-
+                                status = SH_ParserParseIoRedir(
+                                        parser, stmts[count - 1], iter,
+                                        SH_ParserRedirType(tok1->type));
                                 break;
                         }
                         case TOK_WORD:
                         {
+                                // words after a redirection extend its command
                                 if (count < cur) {
                                         stmts[count++] = SH_CreateStatement();
-                                } else if (stmts[count]->infile->n > 0 ||
-                                           stmts[count]->outfile->n > 0) {
-                                        // syntax error
-                                        break;
+                                        parser->n_stmts = count;
                                 }
-                                SH_ParserParseCmd(stmts[count - 1], iter);
+                                status = SH_ParserParseCmd(parser,
+                                                           stmts[count - 1],
+                                                           iter);
                                 break;
                         }
                         default:
-                                // do cleanup
-                                count = -1;
+                                status = -1;
                                 break;
                 }
         }
 
+parse_fin:
         parser->stmts = stmts;
         parser->n_stmts = count;
-        return count;
+        return status == 0 ? count : -1;
 }
+
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -317,25 +389,23 @@ SH_Parser *SH_CreateParser(void)
                 return NULL;
         }
 
+        parser->n_toks = 0;
+        parser->toks = NULL;
+        parser->n_stmts = 0;
+        parser->stmts = NULL;
+        parser->defer_expansion = false;
+        parser->error = NULL;
+
         return parser;
 }
 
 void SH_DestroyParser(SH_Parser **parser)
 {
-        for (size_t i = 0; i < (*parser)->n_toks; i++) {
-                SH_DestroyToken(&(*parser)->toks[i]);
-        }
+        SH_ParserClear(*parser);
+
         free((*parser)->toks);
-        (*parser)->n_toks = 0;
         (*parser)->toks = NULL;
 
-        for (ssize_t i = 0; i < (*parser)->n_stmts; i++) {
-                SH_DestroyStatement(&(*parser)->stmts[i]);
-        }
-        free((*parser)->stmts);
-        (*parser)->n_stmts = 0;
-        (*parser)->stmts = NULL;
-
         free(*parser);
         *parser = NULL;
 }
@@ -349,10 +419,64 @@ void SH_DestroyParser(SH_Parser **parser)
  *
  *
  ******************************************************************************/
+void SH_ParserClear(SH_Parser *const parser)
+{
+        for (size_t i = 0; i < parser->n_toks; i++) {
+                SH_DestroyToken(&parser->toks[i]);
+        }
+        parser->n_toks = 0;
+
+        for (ssize_t i = 0; i < parser->n_stmts; i++) {
+                SH_DestroyStatement(&parser->stmts[i]);
+        }
+        free(parser->stmts);
+        parser->n_stmts = 0;
+        parser->stmts = NULL;
+
+        parser->error = NULL;
+}
+
+int SH_ParserExpandStatement(SH_Statement *const stmt)
+{
+        char **words[] = {
+                stmt->cmd->args, stmt->infile->streams, stmt->outfile->streams
+        };
+        size_t counts[] = {
+                stmt->cmd->count, stmt->infile->n, stmt->outfile->n
+        };
+        char *word;
+
+        for (size_t i = 0; i < sizeof(words) / sizeof(*words); i++) {
+                for (size_t j = 0; j < counts[i]; j++) {
+                        if (words[i][j] == NULL) {
+                                continue; // '2>&1' names no file
+                        }
+                        word = SH_ParserExpandWord(words[i][j]);
+                        if (word == NULL) {
+                                return -1;
+                        }
+                        free(words[i][j]);
+                        words[i][j] = word;
+                }
+        }
+
+        /* Expansion may have produced, or hidden, a builtin's name. */
+        if (SH_IsBuiltin(stmt->cmd->args[0])) {
+                stmt->flags |= FLAGS_BUILTIN;
+        } else {
+                stmt->flags &= ~FLAGS_BUILTIN;
+        }
+
+        return 0;
+}
+
 char *SH_ParserExpandWord(char * const word)
 {
         char *new_word, *old_ptr, *new_ptr;
         size_t len;
+        uint64_t trace_start;
+
+        trace_start = SH_TRACE_BEGIN();
 
         /*
          * Allocate space for new word string. At a minimum it will be same
@@ -360,6 +484,9 @@ char *SH_ParserExpandWord(char * const word)
          */
         len = strlen(word) + 1;
         new_word = calloc(len, sizeof(char));
+        if (new_word == NULL) {
+                return NULL;
+        }
 
         // track copy and insert positions in respective strings
         old_ptr = &word[0];
@@ -376,6 +503,10 @@ char *SH_ParserExpandWord(char * const word)
                                                                &old_ptr,
                                                                &new_ptr,
                                                                &len);
+                        // on failure, the word was freed with new_ptr in it
+                        if (new_word == NULL) {
+                                return NULL;
+                        }
                 } else {
                         // no expansion needed, so just copy over byte
                         *new_ptr = *old_ptr;
@@ -383,12 +514,15 @@ char *SH_ParserExpandWord(char * const word)
                 }
         }
 
+        SH_TRACE_END(TRACE_EXPAND, 0, trace_start);
+
         return new_word;
 }
 
 char *SH_ParserInsertPid(char * const str, char **ptr, size_t * const len)
 {
         char *result;
+        char pid_str[16];
 
         // get pid and convert to string
 #ifdef TEST
@@ -397,60 +531,61 @@ char *SH_ParserInsertPid(char * const str, char **ptr, size_t * const len)
 #else
         pid_t pid = getpid();
 #endif
-        char *pid_str = calloc(sizeof(intmax_t) + 1, sizeof(char));
-        if (pid_str == NULL) {
-                return NULL;
-        }
-
-        size_t pid_len = snprintf(pid_str, sizeof(intmax_t), "%d", pid);
-        if (pid_len >= sizeof(intmax_t)) {
-                free(pid_str);
+        int pid_len = snprintf(pid_str, sizeof(pid_str), "%d", pid);
+        if (pid_len < 0 || (size_t) pid_len >= sizeof(pid_str)) {
                 return NULL;
         }
 
         // save current index since realloc may change string location
-        ptrdiff_t idx = *ptr - &str[0];
-
-        // update copy size to fit pid
-        size_t new_size = *len + pid_len - 2;
-        result = calloc(new_size, sizeof(char));
-        if (result == NULL) {
-                free(pid_str);
+        size_t idx = (size_t) (*ptr - &str[0]);
+        if (idx >= *len) {
+                free(str);
                 return NULL;
         }
 
-        char *tmp = strncpy(result, str, new_size - 1);
-        if (tmp == NULL) {
+        // grow string in place to fit pid in place of "$$"
+        size_t new_size = *len + pid_len;
+        result = realloc(str, new_size);
+        if (result == NULL) {
+                free(str);
                 return NULL;
         }
 
-        result = tmp;
-        result[new_size - 1] = '\0';
+        // keep unused space zeroed, as with calloc
+        memset(&result[*len], 0, new_size - *len);
 
         // reset copy pointer to point to end of result string
         char *new_ptr = &result[0] + idx;
 
         // extend result string with PID
-        for (size_t i = 0; i < pid_len; i++) {
-                *new_ptr++ = pid_str[i];
-        }
+        memcpy(new_ptr, pid_str, pid_len);
+        new_ptr += pid_len;
 
         *len = new_size;
         *ptr = new_ptr;
 
-        free(pid_str);
-
         return result;
 }
 
 ssize_t SH_ParserParse(SH_Parser *const parser, char *buf)
 {
+        ssize_t n_stmts;
+        uint64_t trace_start;
+
         // parse stream into tokens
-        parser->toks = malloc(MAX_TOKENS * sizeof(SH_Token));
+        trace_start = SH_TRACE_BEGIN();
+        if (parser->toks == NULL) {
+                parser->toks = malloc(MAX_TOKENS * sizeof(SH_Token *));
+        }
         parser->n_toks = SH_LexerGenerateTokens(buf, MAX_TOKENS, parser->toks);
+        SH_TRACE_END(TRACE_LEX, 0, trace_start);
 
         // parse tokens into statements
-        return SH_ParserParseStmts(parser);
+        trace_start = SH_TRACE_BEGIN();
+        n_stmts = SH_ParserParseStmts(parser);
+        SH_TRACE_END(TRACE_PARSE, 0, trace_start);
+
+        return n_stmts;
 }
 
 char *SH_ParserSubstituteVariable(char * const word, char **old_ptr,
@@ -474,7 +609,47 @@ char *SH_ParserSubstituteVariable(char * const word, char **old_ptr,
                         (*old_ptr)++;
                         break;
                 }
+                case '(':
+                {
+                        char *end;
+                        size_t rest;
+                        SH_Buffer buf;
+
+                        // unterminated substitution is copied as-is
+                        end = SH_SubstitutionFindEnd(*old_ptr);
+                        if (end == NULL) {
+                                goto copy_literal;
+                        }
+
+                        // capture output straight into the word being built
+                        buf.data = word;
+                        buf.len = *new_ptr - &word[0];
+                        buf.cap = *len;
+                        if (SH_SubstitutionCapture(*old_ptr + 2,
+                                                   end - (*old_ptr + 2),
+                                                   &buf) == -1) {
+                                print_error_msg("SH_SubstitutionCapture()");
+                        }
+
+                        // leave room for the remainder of the original word
+                        rest = strlen(end + 1);
+                        if (SH_BufferReserve(&buf, rest + 1) == -1) {
+                                free(buf.data);
+                                return NULL;
+                        }
+
+                        // keep unused space zeroed, as with calloc
+                        sub = buf.data;
+                        memset(&sub[buf.len], 0, buf.cap - buf.len);
+                        *new_ptr = &sub[buf.len];
+                        *len = buf.cap;
+
+                        // seek to closing ')'
+                        *old_ptr = end;
+                        break;
+                }
                 default:
+copy_literal:
                 {
                         sub = word;
                         // insert '$' at next available position
@@ -0,0 +1,262 @@
+/**
+ * @file script.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For parsing a script file into statements ahead of execution.
+ *
+ * The script file is mapped into memory, and lexed and parsed line by line in
+ * a single pass over the mapping. Expansion is deferred until each statement
+ * is executed, so that parsing has no side effects, and syntax errors can be
+ * reported before anything runs.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "interpreter/parser.h"
+#include "interpreter/script.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Moves @p parser's statements to the end of @p script's statement
+ * list, leaving the parser with none.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_ScriptTakeStatements(SH_Script * const script,
+                                   SH_Parser * const parser,
+                                   char const * const text, size_t const len,
+                                   size_t const lineno)
+{
+        SH_ScriptStmt *tmp;
+        size_t n;
+
+        n = (size_t) parser->n_stmts;
+        if (script->n_stmts + n > script->cap) {
+                script->cap = script->cap > 0 ? script->cap * 2 : 64;
+                if (script->cap < script->n_stmts + n) {
+                        script->cap = script->n_stmts + n;
+                }
+                tmp = realloc(script->stmts, script->cap * sizeof(*tmp));
+                if (tmp == NULL) {
+                        return -1;
+                }
+                script->stmts = tmp;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+                tmp = &script->stmts[script->n_stmts++];
+                tmp->stmt = parser->stmts[i];
+                tmp->text = text;
+                tmp->len = len;
+                tmp->lineno = lineno;
+        }
+        parser->n_stmts = 0;
+
+        return 0;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * CONSTRUCTORS + DESTRUCTORS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Script *SH_CreateScript(char const * const path)
+{
+        SH_Script *script;
+        struct stat st;
+        int fd;
+
+        errno = 0;
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1 || fstat(fd, &st) == -1) {
+                fprintf(stderr, "-smallsh: %s: %s\n", path, strerror(errno));
+                fflush(stderr);
+                if (fd != -1) {
+                        close(fd);
+                }
+                return NULL;
+        }
+
+        script = calloc(1, sizeof *script);
+        if (script == NULL) {
+                close(fd);
+                return NULL;
+        }
+        script->path = strdup(path);
+        script->size = (size_t) st.st_size;
+
+        /* Empty files cannot be mapped, and have nothing to run anyway. */
+        if (script->size > 0) {
+                errno = 0;
+                script->data = mmap(NULL, script->size, PROT_READ, MAP_PRIVATE,
+                                    fd, 0);
+                if (script->data == MAP_FAILED) {
+                        fprintf(stderr, "-smallsh: %s: %s\n", path,
+                                strerror(errno));
+                        fflush(stderr);
+                        script->data = NULL;
+                        close(fd);
+                        SH_DestroyScript(&script);
+                        return NULL;
+                }
+
+                /* Script is parsed front to back, exactly once. */
+                madvise(script->data, script->size, MADV_SEQUENTIAL);
+        }
+        close(fd);
+
+        return script;
+}
+
+void SH_DestroyScript(SH_Script **script)
+{
+        if (*script) {
+                for (size_t i = 0; i < (*script)->n_stmts; i++) {
+                        SH_DestroyStatement(&(*script)->stmts[i].stmt);
+                }
+                free((*script)->stmts);
+                (*script)->stmts = NULL;
+                (*script)->n_stmts = 0;
+
+                if ((*script)->data != NULL) {
+                        munmap((*script)->data, (*script)->size);
+                        (*script)->data = NULL;
+                }
+                free((*script)->tail);
+                free((*script)->path);
+
+                free(*script);
+                *script = NULL;
+        }
+}
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+ssize_t SH_ScriptParse(SH_Script * const script)
+{
+        SH_Parser *parser;
+        char const *data, *nl;
+        char *line;
+        size_t pos, len, lineno;
+        ssize_t n_errors;
+
+        parser = SH_CreateParser();
+        if (parser == NULL) {
+                return -1;
+        }
+        parser->defer_expansion = true;
+
+        data = script->data;
+        n_errors = 0;
+        for (pos = 0, lineno = 1; pos < script->size; lineno++) {
+                nl = memchr(&data[pos], '\n', script->size - pos);
+                if (nl != NULL && nl < &data[script->size - 1]) {
+                        /* Lexer stops at the newline, so parse in place. */
+                        line = (char *) &data[pos];
+                        len = nl - &data[pos] + 1;
+                } else {
+                        /*
+                         * Final line is copied, since it may lack a newline,
+                         * and the lexer peeks one byte past it, which may
+                         * fall off the end of the mapping.
+                         */
+                        len = script->size - pos - (nl != NULL);
+                        script->tail = malloc(len + 2);
+                        if (script->tail == NULL) {
+                                n_errors = -1;
+                                break;
+                        }
+                        memcpy(script->tail, &data[pos], len);
+                        script->tail[len++] = '\n';
+                        script->tail[len] = '\0';
+                        line = script->tail;
+                }
+                pos += len;
+
+                if (SH_ParserParse(parser, line) == -1) {
+                        if (parser->error == NULL) {
+                                n_errors = -1;
+                                break;
+                        }
+                        fprintf(stderr, "-smallsh: %s: line %zu: syntax error "
+                                        "near unexpected token `%s'\n",
+                                script->path, lineno, parser->error);
+                        n_errors++;
+                } else if (SH_ScriptTakeStatements(script, parser, line, len,
+                                                   lineno) == -1) {
+                        n_errors = -1;
+                        break;
+                }
+                SH_ParserClear(parser);
+        }
+        fflush(stderr);
+
+        SH_DestroyParser(&parser);
+
+        return n_errors;
+}
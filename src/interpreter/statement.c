@@ -8,6 +8,46 @@
 #include <stdio.h>
 
 #include "interpreter/statement.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A statement and its fixed-size sub-statement objects, so that they
+ * can be allocated together.
+ */
+typedef struct {
+        SH_Statement stmt; /**< statement; must come first */
+        StmtCmd cmd; /**< command */
+        StmtStdin infile; /**< stdin file streams */
+        StmtStdout outfile; /**< stdout file streams */
+} StatementBlock;
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -40,25 +80,27 @@
  ******************************************************************************/
 SH_Statement *SH_CreateStatement(void)
 {
-        SH_Statement *stmt = malloc(sizeof(SH_Statement));
+        StatementBlock *block = malloc(sizeof(StatementBlock));
+        SH_Statement *stmt = &block->stmt;
 
         // statement command init
-        stmt->cmd = malloc(sizeof(StmtCmd));
+        stmt->cmd = &block->cmd;
         stmt->cmd->count = 0;
         stmt->cmd->args = malloc(sizeof(char *));
         stmt->cmd->args[0] = NULL;
 
         // statement io redirection: stdin init
-        stmt->infile = malloc(sizeof(StmtStdin));
+        stmt->infile = &block->infile;
         stmt->infile->n = 0;
         stmt->infile->streams = malloc(sizeof(char *));
         stmt->infile->streams[0] = NULL;
 
         // statement io redirection: stdout init
-        stmt->outfile = malloc(sizeof(StmtStdout));
+        stmt->outfile = &block->outfile;
         stmt->outfile->n = 0;
         stmt->outfile->streams = malloc(sizeof(char *));
         stmt->outfile->streams[0] = NULL;
+        stmt->outfile->types = NULL;
 
         // statement flags init
         stmt->flags = 0;
@@ -76,7 +118,6 @@ void SH_DestroyStatement(SH_Statement **stmt)
         free((*stmt)->cmd->args);
         (*stmt)->cmd->count = 0;
         (*stmt)->cmd->args = NULL;
-        free((*stmt)->cmd);
         (*stmt)->cmd = NULL;
 
         // statement io redirection: stdin delete
@@ -87,7 +128,6 @@ void SH_DestroyStatement(SH_Statement **stmt)
         free((*stmt)->infile->streams);
         (*stmt)->infile->n = 0;
         (*stmt)->infile->streams = NULL;
-        free((*stmt)->infile);
         (*stmt)->infile = NULL;
 
         // statement io redirection: stdout delete
@@ -96,15 +136,16 @@ void SH_DestroyStatement(SH_Statement **stmt)
                 (*stmt)->outfile->streams[i] = NULL;
         }
         free((*stmt)->outfile->streams);
+        free((*stmt)->outfile->types);
         (*stmt)->outfile->n = 0;
         (*stmt)->outfile->streams = NULL;
-        free((*stmt)->outfile);
+        (*stmt)->outfile->types = NULL;
         (*stmt)->outfile = NULL;
 
         // statement flags delete
         (*stmt)->flags = FLAGS_NONE;
 
-        // statement delete
+        // statement delete, along with its sub-statement objects
         free(*stmt);
         *stmt = NULL;
 }
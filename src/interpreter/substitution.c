@@ -0,0 +1,429 @@
+/**
+ * @file substitution.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For performing command substitution during word expansion.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "builtins/builtins.h"
+#include "error.h"
+#include "events/events.h"
+#include "globals.h"
+#include "interpreter/parser.h"
+#include "interpreter/substitution.h"
+#include "job-control/job-control.h"
+#include "job-control/notice.h"
+#include "job-control/process.h"
+#include "job-control/rlimits.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static int SH_SubstitutionExec(SH_Statement *stmt, char *cmd);
+
+/**
+ * @brief Runs builtin @p stmt within a forked child, as a subshell would,
+ * then exits it.
+ *
+ * The child's events are detached from the shell's first, so that it neither
+ * takes in the shell's child completions and job output, nor starts its
+ * pending jobs.
+ * @param stmt builtin @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @param mask signal mask to restore once detached
+ */
+static void SH_SubstitutionRunSubshell(SH_Statement *stmt, char *cmd,
+                                       sigset_t const *mask)
+{
+        smallsh_capturing = true;
+        if (SH_EventsDetach() == -1) {
+                perror("SH_EventsDetach");
+                _exit(1);
+        }
+        sigprocmask(SIG_SETMASK, mask, NULL);
+
+        SH_RunBuiltin(stmt, cmd, SH_SubstitutionExec);
+
+        fflush(stdout);
+        fflush(stderr);
+        _exit(smallsh_errno & 0xff);
+}
+
+/**
+ * @brief Forks a child to run @p stmt, with its stdout on @p out_fd.
+ *
+ * Builtins that change the shell run in a subshell, and all other commands
+ * are exec'd. SIGCHLD must be blocked until the child has been collected, so
+ * that the shell's SIGCHLD handler does not reap it first.
+ * @param stmt @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @param out_fd descriptor for the child's stdout, or -1 to keep the shell's
+ * @param mask signal mask the child is to restore
+ * @return child's PID, 0 if its redirections failed, or -1 on failure
+ */
+static pid_t SH_SubstitutionFork(SH_Statement *stmt, char *cmd, int out_fd,
+                                 sigset_t const *mask)
+{
+        pid_t pid;
+        SH_Process proc;
+        SH_Redirs redirs;
+        SH_Limits limits;
+        bool builtin;
+
+        /* Explicit redirections still take precedence over the capture. */
+        builtin = (stmt->flags & FLAGS_BUILTIN) != 0;
+        SH_RedirsInit(&redirs);
+        if (!builtin && SH_RedirsOpen(&redirs, stmt->infile, stmt->outfile,
+                                      false) == -1) {
+                return 0; /* error already reported; output is empty */
+        }
+
+        /* Else the child would write out what is buffered. */
+        fflush(stdout);
+
+        pid = fork();
+        if (pid == 0) {
+                /* Send stdout to the capture; exec closes the original. */
+                errno = 0;
+                if (out_fd != -1 && dup2(out_fd, STDOUT_FILENO) == -1) {
+                        perror("dup2");
+                        _exit(1);
+                }
+
+                if (builtin) {
+                        SH_SubstitutionRunSubshell(stmt, cmd, mask);
+                }
+
+                /* Substituted commands run under the same limits as jobs. */
+                SH_LimitsCurrent(&limits);
+                if (SH_LimitsApply(&limits) == -1) {
+                        perror("setrlimit");
+                        _exit(1);
+                }
+
+                /* Run within the shell's process group, like a subshell. */
+                proc.args = stmt->cmd->args;
+                proc.path = NULL;
+                proc.pid = 0;
+                proc.has_completed = false;
+                proc.status = 0;
+                SH_LaunchProcess(&proc, smallsh_shell_pgid, &redirs, true,
+                                 false);
+
+                /* If we reach this point, an error occurred. */
+                _exit(1);
+        } else if (pid < 0) {
+                perror("fork");
+        }
+
+        SH_RedirsClose(&redirs);
+
+        return pid;
+}
+
+/**
+ * @brief Waits for child @p pid to terminate.
+ */
+static void SH_SubstitutionWait(pid_t const pid)
+{
+        int status;
+
+        errno = 0;
+        while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+                ;
+}
+
+/**
+ * @brief Runs @p stmt with its output on the current stdout, which is
+ * already captured.
+ *
+ * This runs the commands that @c time and @c ulimit are given within a
+ * substitution.
+ * @param stmt @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @return status of the statement
+ */
+static int SH_SubstitutionExec(SH_Statement *stmt, char *cmd)
+{
+        sigset_t mask, old_mask;
+        pid_t pid;
+
+        if ((stmt->flags & FLAGS_BUILTIN) != 0
+            && !SH_BuiltinChangesShell(stmt->cmd->args[0])) {
+                return SH_RunBuiltin(stmt, cmd, SH_SubstitutionExec);
+        }
+
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+        pid = SH_SubstitutionFork(stmt, cmd, -1, &old_mask);
+        if (pid > 0) {
+                SH_SubstitutionWait(pid);
+        }
+
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+        return 0;
+}
+
+/**
+ * @brief Runs builtin @p stmt within the shell process, appending its output
+ * to @p out.
+ *
+ * Stdout is pointed at a memory file while the builtin runs, so that it can
+ * write any amount of output without a reader on the other end. Job notices
+ * still go to the shell's own stdout, and pending jobs wait until the builtin
+ * is done, rather than start with their output captured.
+ * @param stmt builtin @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @param out @c Buffer object to append output to
+ * @return 0 on success, -1 on failure
+ */
+static int SH_SubstitutionRunBuiltin(SH_Statement *stmt, char *cmd,
+                                     SH_Buffer *out)
+{
+        struct stat st;
+        int fd, saved_fd, notice_fd;
+        bool capturing;
+        int result;
+
+        errno = 0;
+        fd = memfd_create("smallsh-substitution", MFD_CLOEXEC);
+        if (fd == -1) {
+                perror("memfd_create");
+                return -1;
+        }
+
+        fflush(stdout);
+        saved_fd = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+        if (saved_fd == -1 || dup2(fd, STDOUT_FILENO) == -1) {
+                perror("dup2");
+                if (saved_fd != -1) {
+                        close(saved_fd);
+                }
+                close(fd);
+                return -1;
+        }
+
+        capturing = smallsh_capturing;
+        smallsh_capturing = true;
+        notice_fd = capturing ? -1 : SH_NoticeSetFd(saved_fd);
+
+        SH_RunBuiltin(stmt, cmd, SH_SubstitutionExec);
+
+        fflush(stdout);
+        dup2(saved_fd, STDOUT_FILENO);
+        close(saved_fd);
+        if (!capturing) {
+                SH_NoticeSetFd(notice_fd);
+        }
+        smallsh_capturing = capturing;
+
+        /* Read the output back in one go. */
+        result = 0;
+        if (fstat(fd, &st) == -1 || lseek(fd, 0, SEEK_SET) == -1
+            || SH_BufferReserve(out, (size_t) st.st_size + 1) == -1
+            || SH_BufferReadFd(out, fd) == -1) {
+                print_error_msg("SH_BufferReadFd()");
+                result = -1;
+        }
+        close(fd);
+
+        if (!capturing) {
+                SH_JobControlLaunchPending();
+        }
+
+        return result;
+}
+
+/**
+ * @brief Runs @p stmt, appending its output to @p out.
+ *
+ * Builtins run within the shell process, except for those that change the
+ * shell, which run in a forked subshell. All other commands are exec'd. Output
+ * of a child process is read from a pipe directly into @p out's spare
+ * capacity.
+ * @param stmt @c Statement object to run
+ * @param cmd command text the statement was parsed from
+ * @param out @c Buffer object to append output to
+ * @return 0 on success, -1 on failure
+ */
+static int SH_SubstitutionRun(SH_Statement *stmt, char *cmd, SH_Buffer *out)
+{
+        int fds[2];
+        int result;
+        pid_t pid;
+        sigset_t mask, old_mask;
+
+        if ((stmt->flags & FLAGS_BUILTIN) != 0
+            && !SH_BuiltinChangesShell(stmt->cmd->args[0])) {
+                return SH_SubstitutionRunBuiltin(stmt, cmd, out);
+        }
+
+        errno = 0;
+        if (pipe2(fds, O_CLOEXEC) == -1) {
+                perror("pipe2");
+                return -1;
+        }
+
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+        pid = SH_SubstitutionFork(stmt, cmd, fds[1], &old_mask);
+        close(fds[1]);
+        if (pid == -1) {
+                close(fds[0]);
+                sigprocmask(SIG_SETMASK, &old_mask, NULL);
+                return -1;
+        }
+
+        /* Drain child output until it closes its end of the pipe. */
+        result = 0;
+        if (SH_BufferReadFd(out, fds[0]) == -1) {
+                print_error_msg("SH_BufferReadFd()");
+                result = -1;
+        }
+        close(fds[0]);
+
+        if (pid > 0) {
+                SH_SubstitutionWait(pid);
+        }
+
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+        return result;
+}
+
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+char *SH_SubstitutionFindEnd(char const * const str)
+{
+        char const *ptr;
+        unsigned depth;
+
+        /* Skip past the opening "$(". */
+        depth = 1;
+        for (ptr = str + 2; *ptr != '\0'; ptr++) {
+                if (ptr[0] == '$' && ptr[1] == '(') {
+                        depth++;
+                        ptr++;
+                } else if (*ptr == ')') {
+                        if (--depth == 0) {
+                                return (char *) ptr;
+                        }
+                }
+        }
+
+        /* Unterminated substitution. */
+        return NULL;
+}
+
+int SH_SubstitutionCapture(char const * const cmd, size_t const n,
+                           SH_Buffer * const out)
+{
+        SH_Parser *parser;
+        SH_Statement *stmt;
+        ssize_t n_stmts;
+        size_t start;
+        char *line;
+        int status;
+
+        /* Parser expects a newline-terminated line. */
+        line = malloc(n + 2);
+        if (line == NULL) {
+                return -1;
+        }
+        memcpy(line, cmd, n);
+        line[n] = '\n';
+        line[n + 1] = '\0';
+
+        parser = SH_CreateParser();
+        n_stmts = SH_ParserParse(parser, line);
+        if (n_stmts <= 0) {
+                SH_DestroyParser(&parser);
+                free(line);
+                return n_stmts == 0 ? 0 : -1;
+        }
+
+        /* As with the shell's main loop, only the first statement runs. */
+        stmt = parser->stmts[0];
+        start = out->len;
+        status = SH_SubstitutionRun(stmt, line, out);
+
+        SH_DestroyParser(&parser);
+        free(line);
+
+        /* Strip trailing newlines from output. */
+        while (out->len > start && out->data[out->len - 1] == '\n') {
+                out->len--;
+        }
+
+        return status;
+}
@@ -6,6 +6,40 @@
  */
 #include "interpreter/token-iterator.h"
 #include "interpreter/token.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Newline token returned when peeking past the end of the stream.
+ */
+static SH_Token TOKEN_ITERATOR_END = { TOK_CTRL_NEWLINE, NULL };
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -73,16 +107,13 @@ void SH_DestroyTokenIterator(SH_TokenIterator **iter)
  ******************************************************************************/
 bool SH_TokenIteratorHasNext(SH_TokenIterator const * const iter)
 {
-        SH_Token tok;
-        bool in_bounds;
-
-        // grab last token to check if it's a newline token
-        tok = *iter->toks[iter->cur];
-
         // cursor can be at most len - 1
-        in_bounds = iter->cur < iter->len;
+        if (iter->cur >= iter->len) {
+                return false;
+        }
 
-        return in_bounds && tok.type != TOK_CTRL_NEWLINE;
+        // check if current token is a newline token
+        return iter->toks[iter->cur]->type != TOK_CTRL_NEWLINE;
 }
 
 SH_Token *SH_TokenIteratorNext(SH_TokenIterator *const iter)
@@ -107,7 +138,7 @@ SH_TokenIteratorPeek(SH_TokenIterator *const iter, unsigned int const offset)
 
         if (pos <= offset) {
                 // newline token acts as null terminator for token array
-                result = SH_CreateToken(TOK_CTRL_NEWLINE);
+                result = &TOKEN_ITERATOR_END;
         } else {
                 result = cur;
         }
@@ -122,6 +122,18 @@ void SH_PrintToken(SH_Token const * const token)
                 case TOK_WORD:
                         printf("WORD:%s", token->value);
                         break;
+                case TOK_REDIR_APPEND:
+                        printf("APPEND_REDIR:%s", token->value);
+                        break;
+                case TOK_REDIR_STDERR:
+                        printf("STDERR_REDIR:%s", token->value);
+                        break;
+                case TOK_REDIR_STDERR_TO_STDOUT:
+                        printf("STDERR_TO_STDOUT_REDIR:%s", token->value);
+                        break;
+                case TOK_REDIR_BOTH:
+                        printf("BOTH_REDIR:%s", token->value);
+                        break;
                 default:
                         break;
         }
@@ -129,26 +141,28 @@ void SH_PrintToken(SH_Token const * const token)
 
 void SH_TakeToken(SH_Token *const token, SH_StringIterator *const iter)
 {
+        char *slice;
+
         switch(token->type) {
                 case TOK_CTRL_BG:
                 case TOK_CMT:
                 case TOK_REDIR_INPUT:
                 case TOK_REDIR_OUTPUT:
                 case TOK_CTRL_NEWLINE:
-                {
-                        char *slice = SH_StringIteratorConsumeChar(iter);
-                        SH_SetTokenValue(token, slice);
-                        free(slice);
+                        slice = SH_StringIteratorConsumeChar(iter);
                         break;
-                }
                 case TOK_WORD:
-                {
-                        char *slice = SH_StringIteratorConsumeWord(iter);
-                        SH_SetTokenValue(token, slice);
-                        free(slice);
+                case TOK_REDIR_APPEND:
+                case TOK_REDIR_STDERR:
+                case TOK_REDIR_STDERR_TO_STDOUT:
+                case TOK_REDIR_BOTH:
+                        slice = SH_StringIteratorConsumeWord(iter);
                         break;
-                }
                 default:
-                        break;
+                        return;
         }
+
+        // slice is already a copy, so hand it over rather than copying again
+        free(token->value);
+        token->value = slice;
 }
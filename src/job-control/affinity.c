@@ -0,0 +1,391 @@
+/**
+ * @file affinity.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief CPU placement of background jobs.
+ *
+ * Background jobs can be pinned to a CPU each, chosen from those running the
+ * fewest jobs, so that long-running jobs keep their caches warm rather than
+ * being moved from core to core.
+ */
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "job-control/affinity.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Where a CPU sits in the machine's topology.
+ */
+typedef struct {
+        int cpu; /**< CPU number */
+        int package; /**< physical package (socket) */
+        int core; /**< core within package */
+        int sibling; /**< rank among the hardware threads of its core */
+        int core_rank; /**< rank of its core within its package */
+} SH_AffinityCPU;
+
+static SH_AffinityPolicy affinity_policy = AFFINITY_OFF; /**< current policy */
+static SH_AffinityCPU affinity_cpus[CPU_SETSIZE]; /**< CPUs in policy order */
+static int affinity_n_cpus = 0; /**< number of CPUs in affinity_cpus */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Reads topology attribute @p name of @p cpu from sysfs.
+ * @return attribute value, or @p cpu if it cannot be read
+ */
+static int SH_AffinityTopology(int const cpu, char const *const name)
+{
+        char path[96];
+        FILE *file;
+        int value;
+
+        snprintf(path, sizeof path,
+                 "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+        file = fopen(path, "r");
+        if (file == NULL) {
+                return cpu;
+        }
+        if (fscanf(file, "%d", &value) != 1) {
+                value = cpu;
+        }
+        fclose(file);
+
+        return value;
+}
+
+/**
+ * @brief Orders CPUs by package, then core, then number.
+ */
+static int SH_AffinityCompareCompact(void const *const a, void const *const b)
+{
+        SH_AffinityCPU const *x = a, *y = b;
+
+        if (x->package != y->package) {
+                return x->package < y->package ? -1 : 1;
+        }
+        if (x->core != y->core) {
+                return x->core < y->core ? -1 : 1;
+        }
+        return x->cpu < y->cpu ? -1 : x->cpu > y->cpu;
+}
+
+/**
+ * @brief Orders CPUs one hardware thread per core at a time, alternating
+ * between packages.
+ */
+static int SH_AffinityCompareSpread(void const *const a, void const *const b)
+{
+        SH_AffinityCPU const *x = a, *y = b;
+
+        if (x->sibling != y->sibling) {
+                return x->sibling < y->sibling ? -1 : 1;
+        }
+        if (x->core_rank != y->core_rank) {
+                return x->core_rank < y->core_rank ? -1 : 1;
+        }
+        return SH_AffinityCompareCompact(a, b);
+}
+
+/**
+ * @brief Lays out the CPUs the shell may run on in the order the current
+ * policy fills them.
+ */
+static void SH_AffinityLayout(void)
+{
+        cpu_set_t allowed;
+        SH_AffinityCPU *cpu, *prev;
+
+        affinity_n_cpus = 0;
+        if (sched_getaffinity(0, sizeof allowed, &allowed) == -1) {
+                return;
+        }
+
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+                if (!CPU_ISSET(i, &allowed)) {
+                        continue;
+                }
+                cpu = &affinity_cpus[affinity_n_cpus++];
+                cpu->cpu = i;
+                cpu->package = SH_AffinityTopology(i, "physical_package_id");
+                cpu->core = SH_AffinityTopology(i, "core_id");
+        }
+
+        /* Rank threads within cores, and cores within packages. */
+        qsort(affinity_cpus, affinity_n_cpus, sizeof affinity_cpus[0],
+              SH_AffinityCompareCompact);
+        for (int i = 0; i < affinity_n_cpus; i++) {
+                cpu = &affinity_cpus[i];
+                prev = i > 0 ? &affinity_cpus[i - 1] : NULL;
+                if (prev == NULL || prev->package != cpu->package) {
+                        cpu->sibling = 0;
+                        cpu->core_rank = 0;
+                } else if (prev->core != cpu->core) {
+                        cpu->sibling = 0;
+                        cpu->core_rank = prev->core_rank + 1;
+                } else {
+                        cpu->sibling = prev->sibling + 1;
+                        cpu->core_rank = prev->core_rank;
+                }
+        }
+
+        if (affinity_policy == AFFINITY_SPREAD) {
+                qsort(affinity_cpus, affinity_n_cpus, sizeof affinity_cpus[0],
+                      SH_AffinityCompareSpread);
+        }
+}
+
+/**
+ * @brief Returns whether or not @p job is a running job placed on a CPU.
+ */
+static bool SH_AffinityIsPlaced(SH_Job const *const job)
+{
+        return job->cpu >= 0 && !job->pending && job->proc->pid > 0
+               && !job->proc->has_completed;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_AffinitySetPolicy(SH_AffinityPolicy const policy)
+{
+        affinity_policy = policy;
+        if (policy != AFFINITY_OFF) {
+                SH_AffinityLayout();
+        }
+}
+
+SH_AffinityPolicy SH_AffinityGetPolicy(void)
+{
+        return affinity_policy;
+}
+
+int SH_AffinityPlace(SH_JobTable const *const table)
+{
+        SH_Job *job;
+        int best, best_load, load;
+
+        if (affinity_policy == AFFINITY_OFF || affinity_n_cpus == 0) {
+                return -1;
+        }
+
+        /* Jobs are few, so count each CPU's afresh rather than track them. */
+        best = -1;
+        best_load = 0;
+        for (int i = 0; i < affinity_n_cpus; i++) {
+                load = 0;
+                job = table->head;
+                while (job != NULL) {
+                        if (SH_AffinityIsPlaced(job)
+                            && job->cpu == affinity_cpus[i].cpu) {
+                                load++;
+                        }
+                        job = job->next;
+                }
+
+                if (best == -1 || load < best_load) {
+                        best = affinity_cpus[i].cpu;
+                        best_load = load;
+                }
+                if (load == 0) {
+                        break;
+                }
+        }
+
+        return best;
+}
+
+void SH_AffinityApply(int const cpu)
+{
+        cpu_set_t cpus;
+
+        if (cpu < 0) {
+                return;
+        }
+
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        sched_setaffinity(0, sizeof cpus, &cpus);
+}
+
+int SH_AffinityPinGroup(pid_t const pgid, cpu_set_t const *const cpus)
+{
+        char path[64];
+        DIR *procs, *tasks;
+        struct dirent *proc, *task;
+        int n_pinned;
+        pid_t pid;
+
+        procs = opendir("/proc");
+        if (procs == NULL) {
+                return -1;
+        }
+
+        /* Threads each have their own affinity, so pin every one. */
+        n_pinned = 0;
+        errno = ESRCH;
+        while ((proc = readdir(procs)) != NULL) {
+                if (!isdigit((unsigned char) proc->d_name[0])) {
+                        continue;
+                }
+                pid = (pid_t) atoi(proc->d_name);
+                if (getpgid(pid) != pgid) {
+                        continue;
+                }
+
+                snprintf(path, sizeof path, "/proc/%d/task", (int) pid);
+                tasks = opendir(path);
+                if (tasks == NULL) {
+                        continue;
+                }
+                while ((task = readdir(tasks)) != NULL) {
+                        if (isdigit((unsigned char) task->d_name[0])
+                            && sched_setaffinity((pid_t) atoi(task->d_name),
+                                                 sizeof *cpus, cpus) == 0) {
+                                n_pinned++;
+                        }
+                }
+                closedir(tasks);
+        }
+        closedir(procs);
+
+        return n_pinned > 0 ? n_pinned : -1;
+}
+
+int SH_AffinityParseList(char const *list, cpu_set_t *const cpus)
+{
+        unsigned long first, last;
+        char *end;
+
+        CPU_ZERO(cpus);
+
+        for (;;) {
+                if (!isdigit((unsigned char) *list)) {
+                        return -1;
+                }
+                first = strtoul(list, &end, 10);
+                last = first;
+                if (*end == '-') {
+                        list = end + 1;
+                        if (!isdigit((unsigned char) *list)) {
+                                return -1;
+                        }
+                        last = strtoul(list, &end, 10);
+                }
+                if (last < first || last >= CPU_SETSIZE) {
+                        return -1;
+                }
+
+                for (unsigned long cpu = first; cpu <= last; cpu++) {
+                        CPU_SET(cpu, cpus);
+                }
+
+                if (*end == '\0') {
+                        return 0;
+                } else if (*end != ',') {
+                        return -1;
+                }
+                list = end + 1;
+        }
+}
+
+int SH_AffinityFormatList(cpu_set_t const *const cpus, char *const buf,
+                          size_t const size)
+{
+        size_t len;
+        int first, n;
+
+        len = 0;
+        if (size > 0) {
+                buf[0] = '\0';
+        }
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (!CPU_ISSET(cpu, cpus)) {
+                        continue;
+                }
+
+                /* Collapse runs of CPUs into ranges. */
+                first = cpu;
+                while (cpu + 1 < CPU_SETSIZE && CPU_ISSET(cpu + 1, cpus)) {
+                        cpu++;
+                }
+
+                n = first == cpu
+                    ? snprintf(buf + len, len < size ? size - len : 0,
+                               "%s%d", len > 0 ? "," : "", first)
+                    : snprintf(buf + len, len < size ? size - len : 0,
+                               "%s%d-%d", len > 0 ? "," : "", first, cpu);
+                len += n > 0 ? (size_t) n : 0;
+        }
+
+        return (int) len;
+}
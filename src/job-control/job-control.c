@@ -11,8 +11,11 @@
  */
 #define _GNU_SOURCE
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdio.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <termios.h>
 #include <unistd.h>
@@ -24,7 +27,57 @@
 #include <string.h>
 #endif
 
+#include "events/events.h"
+#include "job-control/affinity.h"
 #include "job-control/job-control.h"
+#include "job-control/job-log.h"
+#include "job-control/journal.h"
+#include "job-control/notice.h"
+#include "job-control/pressure.h"
+#include "job-control/priority.h"
+#include "job-control/rlimits.h"
+#include "trace/trace.h"
+
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Milliseconds between looks at whether a foreground job has stopped,
+ * while background jobs are looked after.
+ */
+#define SH_JOB_CONTROL_SERVE_INTERVAL 100
+
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static SH_JobControlWaitHook wait_hook = NULL; /**< see SH_JobControlSetWaitHook */
+static void *wait_hook_ctx = NULL; /**< context passed to wait_hook */
+static SH_JobControlTimes fg_times = { 0, 0 }; /**< last foreground job */
+static int fg_status = 0; /**< last foreground job's exit status */
 
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
@@ -58,10 +111,15 @@
  ******************************************************************************/
 static void SH_JobControlWaitForJob(SH_Job *job);
 
+/**
+ * @brief Announces that @p job was started in the background.
+ *
+ * The notice is left for the caller to flush.
+ * @param job background job
+ */
 static void SH_JobControlBGJob(SH_Job *job)
 {
-        fprintf(stdout, "[%d]\t%d\n", job->spec, job->proc->pid);
-        fflush(stdout);
+        SH_NoticeJobStarted(job);
 }
 
 /**
@@ -98,6 +156,104 @@ static void SH_JobControlFGJob(SH_Job *job)
         tcflush(smallsh_shell_terminal, TCIOFLUSH);
 }
 
+/**
+ * @brief Returns whether or not any background job is running or pending, or
+ * has output to drain.
+ */
+static bool SH_JobControlBackgroundBusy(void)
+{
+        return SH_JobLogActive() || SH_JobTableCountRunning(job_table) > 0
+               || SH_JobTableCountPending(job_table) > 0;
+}
+
+/**
+ * @brief Looks after background jobs until process @p pid changes state.
+ *
+ * Background jobs that complete meanwhile are reaped by the SIGCHLD handler;
+ * their completions are taken from its channel here, so that pending jobs are
+ * started in the slots they free, and their logs are drained, so that none of
+ * them blocks on a full pipe. Exits of @p pid are seen through a pidfd as they
+ * happen; stops are looked for every @c SH_JOB_CONTROL_SERVE_INTERVAL
+ * milliseconds. Returns at once if there is nothing in the background to look
+ * after, or pidfds are unsupported.
+ * @param pid foreground process
+ */
+static void SH_JobControlServeBackground(pid_t const pid)
+{
+        struct pollfd fds[3];
+        siginfo_t info;
+        int pidfd, ready;
+
+        if (!SH_JobControlBackgroundBusy()) {
+                return;
+        }
+        pidfd = (int) syscall(SYS_pidfd_open, pid, 0);
+        if (pidfd == -1) {
+                return;
+        }
+
+        fds[0].fd = pidfd;
+        fds[0].events = POLLIN;
+        fds[1].fd = sigchld_channel->read_fd;
+        fds[1].events = POLLIN;
+        fds[2].fd = SH_JobLogFd();
+        fds[2].events = POLLIN;
+
+        while (SH_JobControlBackgroundBusy()) {
+                info.si_pid = 0;
+                if (waitid(P_PID, pid, &info,
+                           WEXITED | WSTOPPED | WNOWAIT | WNOHANG) == -1
+                    || info.si_pid != 0) {
+                        break;
+                }
+
+                ready = poll(fds, 3, SH_JOB_CONTROL_SERVE_INTERVAL);
+                if (ready == -1 && errno != EINTR) {
+                        break;
+                }
+                if (ready > 0 && fds[2].revents != 0) {
+                        SH_JobLogDrain();
+                }
+                if (ready > 0 && fds[1].revents != 0
+                    && SH_ReceiverSigchldCallbackHandler(*sigchld_channel)
+                       == -1) {
+                        break;
+                }
+                SH_JobControlLaunchPending();
+        }
+
+        close(pidfd);
+}
+
+/**
+ * @brief Takes in SIGCHLD events until @p job's process has been reaped.
+ *
+ * The SIGCHLD handler reaps every child, @p job's included, and passes on its
+ * status and resource usage through the SIGCHLD channel.
+ * @param job job whose process has terminated
+ */
+static void SH_JobControlAwaitReaped(SH_Job *job)
+{
+        struct pollfd fd;
+
+        fd.fd = sigchld_channel->read_fd;
+        fd.events = POLLIN;
+        for (;;) {
+                if (SH_ReceiverSigchldCallbackHandler(*sigchld_channel) == -1) {
+                        _exit(1);
+                }
+                if (job->proc->has_completed) {
+                        break;
+                }
+
+                errno = 0;
+                if (poll(&fd, 1, -1) == -1 && errno != EINTR) {
+                        perror("poll");
+                        _exit(1);
+                }
+        }
+}
+
 static void SH_JobControlWaitForJob(SH_Job *job)
 {
         int exit_status;
@@ -106,6 +262,9 @@ static void SH_JobControlWaitForJob(SH_Job *job)
         int opt;
         bool sigtstp_raised, normal_termination;
         int status;
+        uint64_t trace_start, exited;
+
+        trace_start = SH_TRACE_BEGIN();
 
         opt = WEXITED | WSTOPPED | WNOWAIT; /* don't collect child */
         sigtstp_raised = false;
@@ -119,6 +278,8 @@ static void SH_JobControlWaitForJob(SH_Job *job)
          * via its SIGTSTP handler.
          */
         for (;;) {
+                SH_JobControlServeBackground(job->proc->pid);
+
                 errno = 0;
                 child = waitid(P_PID, job->proc->pid, &info, opt);
                 if (child == -1 && errno != ECHILD) {
@@ -127,7 +288,8 @@ static void SH_JobControlWaitForJob(SH_Job *job)
                 }
 
                 /* Child was stopped. */
-                if (info.si_code == CLD_STOPPED) {
+                if (child != -1 && info.si_code == CLD_STOPPED) {
+                        SH_JournalLog(JOURNAL_STOPPED, job, info.si_status);
                         if (info.si_status == SIGTSTP) {
                                 sigtstp_raised = true;
 
@@ -136,36 +298,44 @@ static void SH_JobControlWaitForJob(SH_Job *job)
                                  * resume it, and wait again.
                                  */
                                 errno = 0;
-                                child = waitpid(child, &exit_status, 0);
+                                child = waitpid(job->proc->pid, &exit_status,
+                                                WUNTRACED);
                                 if (child == -1 && errno != ECHILD) {
                                         perror("waitpid");
                                         _exit(1);
                                 }
 
                                 errno = 0;
-                                status = kill(child, SIGCONT);
+                                status = kill(job->proc->pid, SIGCONT);
                                 if (status == -1) {
                                         perror("kill");
                                         _exit(1);
                                 }
+                                SH_JournalLog(JOURNAL_CONTINUED, job, 0);
                         } else {
                                 exit_status = info.si_status;
+                                exited = SH_TraceNow();
                                 break;
                         }
                 }
-                /* Child was terminated normally. */
-                else if (info.si_code == CLD_EXITED) {
-                        exit_status = info.si_status;
-                        normal_termination = true;
-                        break;
-                }
-                /* Child was terminated by signal. */
+                /* Child was terminated, and is reaped by the SIGCHLD handler. */
                 else {
-                        exit_status = info.si_status;
+                        SH_JobControlAwaitReaped(job);
+                        exited = job->proc->finished;
+                        if (WIFEXITED(job->proc->status)) {
+                                exit_status = WEXITSTATUS(job->proc->status);
+                                normal_termination = true;
+                        } else {
+                                exit_status = WTERMSIG(job->proc->status);
+                        }
                         break;
                 }
         }
 
+        /* Note when the child exited, for the time builtin. */
+        fg_times.started = job->proc->started;
+        fg_times.exited = exited;
+
         if (WIFSIGNALED(exit_status) && !normal_termination) {
                 fprintf(stdout, "terminated by signal %d\n", WTERMSIG(exit_status));
                 fflush(stdout);
@@ -192,6 +362,95 @@ static void SH_JobControlWaitForJob(SH_Job *job)
         job->proc->has_completed = true;
         job->proc->status = exit_status;
         smallsh_errno = exit_status;
+        fg_status = normal_termination ? exit_status : 128 + exit_status;
+
+        SH_TRACE_END(TRACE_WAIT, job->proc->pid, trace_start);
+}
+
+/**
+ * @brief Forks a child to run @p job_ in, and puts it into its process group.
+ *
+ * Must be called with SIGCHLD blocked.
+ * @param job_ job to run
+ * @param run_fg whether or not the job will run in the foreground
+ */
+static void SH_JobControlSpawn(SH_Job *job_, bool run_fg)
+{
+        int status;
+        pid_t spawn_pid;
+        uint64_t trace_start, trace_forked;
+        int exec_fds[2];
+        char c;
+
+        /*
+         * When tracing, time the child's setup through a close-on-exec pipe:
+         * its write end is closed once the child execs (or exits).
+         */
+        exec_fds[0] = -1;
+        if (smallsh_trace_enabled && pipe2(exec_fds, O_CLOEXEC) == -1) {
+                exec_fds[0] = -1;
+        }
+
+        /* Place background jobs before forking, so the child can pin itself. */
+        if (!run_fg) {
+                job_->cpu = SH_AffinityPlace(job_table);
+                SH_PressureNoteLaunch();
+        }
+        if (job_->run_bg) {
+                SH_JobLogOpen(job_);
+        }
+
+        trace_start = SH_TRACE_BEGIN();
+        spawn_pid = fork();
+        trace_forked = SH_TRACE_BEGIN();
+        if (spawn_pid == 0) {
+                if (exec_fds[0] != -1) {
+                        close(exec_fds[0]);
+                }
+                SH_AffinityApply(job_->cpu);
+                if (SH_LimitsApply(&job_->limits) == -1) {
+                        perror("setrlimit");
+                        _exit(1);
+                }
+                SH_LaunchProcess(job_->proc, job_->pgid, &job_->redirs,
+                                 run_fg, job_->run_bg);
+
+                /* If we reach this point, an error occurred. */
+                _exit(1);
+        } else if (spawn_pid < 0) {
+                perror("fork");
+                _exit(1);
+        } else {
+                /* Put job into its own group and make it the process leader. */
+                job_->proc->pid = spawn_pid;
+                job_->proc->started = SH_TraceNow();
+                if (job_->log != NULL) {
+                        job_->log->pid = spawn_pid;
+                }
+                if (job_->pgid == 0) {
+                        job_->pgid = spawn_pid;
+                }
+
+                errno = 0;
+                status = setpgid(spawn_pid, job_->pgid);
+                if (status == -1 && errno != EACCES) {
+                        perror("setpgid");
+                        _exit(1);
+                }
+        }
+        SH_TRACE_END(TRACE_SPAWN, spawn_pid, trace_start);
+        SH_JournalLog(JOURNAL_SPAWNED, job_, 0);
+
+        /* Child has its own copies of the redirections. */
+        SH_RedirsClose(&job_->redirs);
+
+        if (exec_fds[0] != -1) {
+                close(exec_fds[1]);
+                while (read(exec_fds[0], &c, 1) == -1 && errno == EINTR)
+                        ;
+                close(exec_fds[0]);
+                SH_TRACE_END(TRACE_EXEC, spawn_pid, trace_forked);
+        }
 }
 
 /* *****************************************************************************
@@ -226,40 +485,46 @@ static void SH_JobControlWaitForJob(SH_Job *job)
  ******************************************************************************/
 int SH_JobControlLaunchJob(SH_Job **job, bool run_fg)
 {
-        int status;
         SH_Job *job_;
-        pid_t spawn_pid;
+        sigset_t mask, old_mask;
 
         job_ = *job;
 
-        spawn_pid = fork();
-        if (spawn_pid == 0) {
-                SH_LaunchProcess(job_->proc, job_->pgid,
-                                 job_->infile,
-                                 job_->outfile, run_fg);
-
-                /* If we reach this point, an error occurred. */
-                _exit(1);
-        } else if (spawn_pid < 0) {
-                perror("fork");
-                _exit(1);
-        } else {
-                /* Put job into its own group and make it the process leader. */
-                job_->proc->pid = spawn_pid;
-                if (job_->pgid == 0) {
-                        job_->pgid = spawn_pid;
-                }
-
-                errno = 0;
-                status = setpgid(spawn_pid, job_->pgid);
-                if (status == -1 && errno != EACCES) {
-                        perror("setpgid");
-                        _exit(1);
+        /*
+         * Under a running job cap, or pressure thresholds, queue background
+         * jobs behind any already pending, and start as many of them as fit.
+         */
+        if (!run_fg && (job_table->max_running > 0 || SH_PressureEnabled())) {
+                job_->pending = true;
+                SH_JobControlLaunchPending();
+                if (job_->pending) {
+                        SH_NoticeJobPending(job_);
                 }
+                SH_NoticeFlush(NULL, 0);
+                return 0;
         }
 
+        /* Hold off SIGCHLD until the job is set up, and known by its PID. */
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+        SH_JobControlSpawn(job_, run_fg);
+
         /* Foreground job. */
         if (run_fg) {
+                /* Signals the shell is sent in init mode now go to the job. */
+                smallsh_fg_pgid = job_->pgid;
+                sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+                /* Leave it the CPUs that heavy background jobs are using. */
+                SH_PriorityPauseBackground(job_table);
+
+                /* Get ahead on other work while the job runs. */
+                if (wait_hook != NULL) {
+                        wait_hook(wait_hook_ctx);
+                }
+
                 if (smallsh_interactive_mode) {
                         /*
                          * Give job control over foreground if we are in
@@ -270,11 +535,70 @@ int SH_JobControlLaunchJob(SH_Job **job, bool run_fg)
                         /* Otherwise, just wait for job to complete. */
                         SH_JobControlWaitForJob(job_);
                 }
+
+                smallsh_fg_pgid = 0;
+
+                SH_PriorityResumeBackground(job_table);
         }
         /* Background job. */
         else {
+                sigprocmask(SIG_SETMASK, &old_mask, NULL);
                 SH_JobControlBGJob(job_);
+                SH_NoticeFlush(NULL, 0);
         }
 
         return 0;
 }
+
+void SH_JobControlSpawnJob(SH_Job *const job)
+{
+        sigset_t mask, old_mask;
+
+        /* As with background jobs, the SIGCHLD handler reaps the child. */
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+        SH_JobControlSpawn(job, false);
+
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+void SH_JobControlLaunchPending(void)
+{
+        SH_Job *job;
+
+        /* Jobs started now would write into a command substitution. */
+        if (smallsh_capturing) {
+                return;
+        }
+
+        while ((job = SH_JobTableNextPending(job_table)) != NULL) {
+                /* Under pressure, still keep one job going. */
+                if (SH_JobTableCountRunning(job_table) > 0
+                    && !SH_PressureAllowLaunch()) {
+                        break;
+                }
+
+                job->pending = false;
+                SH_JobControlSpawnJob(job);
+                SH_JobControlBGJob(job);
+        }
+}
+
+SH_JobControlTimes SH_JobControlLastForeground(void)
+{
+        return fg_times;
+}
+
+int SH_JobControlLastStatus(void)
+{
+        return fg_status;
+}
+
+void SH_JobControlSetWaitHook(SH_JobControlWaitHook const hook,
+                              void * const ctx)
+{
+        wait_hook = hook;
+        wait_hook_ctx = ctx;
+}
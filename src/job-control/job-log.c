@@ -0,0 +1,412 @@
+/**
+ * @file job-log.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief In-memory logs of background job output.
+ *
+ * Background jobs have their output thrown away unless redirected, so a job
+ * that fails leaves nothing behind to look at. With logs enabled, output they
+ * would have thrown away goes through a pipe instead, into a ring buffer of a
+ * fixed size per job, for @c joblog to show the tail of. Nothing is written to
+ * disk.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "job-control/job-log.h"
+#include "job-control/redirect.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define JOB_LOG_MAX_READS 16 /**< reads per log per drain, to bound a drain */
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static size_t job_log_size = 0; /**< bytes kept per log, 0 for no logs */
+static SH_JobLog *job_log_head = NULL; /**< logs, newest first */
+static int job_log_epoll = -1; /**< epoll instance over open pipes */
+static size_t job_log_n_open = 0; /**< number of logs with pipes open */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Closes @p log's pipe, once every writer is gone, or it is freed.
+ */
+static void SH_JobLogClosePipe(SH_JobLog *const log)
+{
+        if (log->fd == -1) {
+                return;
+        }
+
+        /* Closing the last reference drops it from the epoll set too. */
+        close(log->fd);
+        log->fd = -1;
+        job_log_n_open--;
+}
+
+/**
+ * @brief Frees @p log, and closes its pipe.
+ */
+static void SH_JobLogFree(SH_JobLog *const log)
+{
+        SH_JobLogClosePipe(log);
+        free(log->buf);
+        free(log->command);
+        free(log);
+}
+
+/**
+ * @brief Reads whatever output is ready from @p log's pipe into its ring.
+ */
+static void SH_JobLogRead(SH_JobLog *const log)
+{
+        size_t pos;
+        ssize_t n;
+        char c;
+
+        /* Many jobs write nothing, so only allocate once output arrives. */
+        if (log->buf == NULL) {
+                n = read(log->fd, &c, 1);
+                if (n == -1 && (errno == EAGAIN || errno == EINTR)) {
+                        return;
+                }
+                log->buf = n == 1 ? malloc(log->size) : NULL;
+                if (log->buf == NULL) {
+                        SH_JobLogClosePipe(log);
+                        return;
+                }
+                log->buf[0] = c;
+                log->written = 1;
+        }
+
+        for (int i = 0; i < JOB_LOG_MAX_READS; i++) {
+                pos = (size_t) (log->written % log->size);
+                n = read(log->fd, log->buf + pos, log->size - pos);
+                if (n > 0) {
+                        log->written += (uint64_t) n;
+                        continue;
+                } else if (n == -1 && errno == EINTR) {
+                        continue;
+                } else if (n == -1 && errno == EAGAIN) {
+                        return;
+                }
+
+                /* End of file: every process writing to it is gone. */
+                SH_JobLogClosePipe(log);
+                return;
+        }
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+int SH_JobLogInit(void)
+{
+        job_log_epoll = epoll_create1(EPOLL_CLOEXEC);
+
+        return job_log_epoll;
+}
+
+void SH_JobLogCleanup(void)
+{
+        SH_JobLog *next;
+
+        while (job_log_head != NULL) {
+                next = job_log_head->next;
+                SH_JobLogFree(job_log_head);
+                job_log_head = next;
+        }
+
+        if (job_log_epoll != -1) {
+                close(job_log_epoll);
+                job_log_epoll = -1;
+        }
+}
+
+void SH_JobLogDetach(void)
+{
+        int fd;
+
+        /* The shell keeps its own copies of the pipes. */
+        for (SH_JobLog *log = job_log_head; log != NULL; log = log->next) {
+                SH_JobLogClosePipe(log);
+        }
+
+        /* The epoll instance is shared too; put an empty one in its place. */
+        if (job_log_epoll != -1) {
+                fd = epoll_create1(EPOLL_CLOEXEC);
+                if (fd != -1) {
+                        dup3(fd, job_log_epoll, O_CLOEXEC);
+                        close(fd);
+                }
+        }
+}
+
+void SH_JobLogSetSize(size_t const size)
+{
+        job_log_size = size;
+}
+
+size_t SH_JobLogGetSize(void)
+{
+        return job_log_size;
+}
+
+int SH_JobLogFd(void)
+{
+        return job_log_epoll;
+}
+
+bool SH_JobLogActive(void)
+{
+        return job_log_n_open > 0;
+}
+
+void SH_JobLogOpen(SH_Job *const job)
+{
+        struct epoll_event event;
+        SH_JobLog *log;
+        int fds[2];
+
+        if (job_log_size == 0 || job_log_epoll == -1) {
+                return;
+        }
+
+        log = malloc(sizeof *log);
+        if (log == NULL) {
+                return;
+        }
+        log->command = strdup(job->command);
+        if (log->command == NULL || pipe2(fds, O_CLOEXEC) == -1) {
+                free(log->command);
+                free(log);
+                return;
+        }
+
+        /* Only output that would be thrown away is captured. */
+        if (SH_RedirsCapture(&job->redirs, fds[1]) == -1) {
+                close(fds[0]);
+                close(fds[1]);
+                free(log->command);
+                free(log);
+                return;
+        }
+
+        /*
+         * Leave room in the pipe for as much as the log keeps, so that a job
+         * can go on writing while the shell is busy elsewhere.
+         */
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        if (fcntl(fds[0], F_GETPIPE_SZ) < (int) job_log_size) {
+                fcntl(fds[0], F_SETPIPE_SZ, (int) job_log_size);
+        }
+
+        event.events = EPOLLIN;
+        event.data.ptr = log;
+        epoll_ctl(job_log_epoll, EPOLL_CTL_ADD, fds[0], &event);
+
+        log->buf = NULL;
+        log->size = job_log_size;
+        log->written = 0;
+        log->fd = fds[0];
+        log->spec = job->spec;
+        log->pid = 0;
+        log->finished = false;
+        log->next = job_log_head;
+        job_log_head = log;
+        job_log_n_open++;
+
+        job->log = log;
+}
+
+void SH_JobLogRelease(SH_Job *const job)
+{
+        SH_JobLog *log, *prev;
+        size_t n_finished;
+
+        if (job->log == NULL) {
+                return;
+        }
+        job->log->finished = true;
+        job->log = NULL;
+
+        /* Drop the oldest logs of destroyed jobs past the number kept. */
+        n_finished = 0;
+        prev = NULL;
+        log = job_log_head;
+        while (log != NULL) {
+                if (log->finished && ++n_finished > SH_JOB_LOG_KEEP) {
+                        if (prev == NULL) {
+                                job_log_head = log->next;
+                        } else {
+                                prev->next = log->next;
+                        }
+                        SH_JobLogFree(log);
+                        log = prev == NULL ? job_log_head : prev->next;
+                        continue;
+                }
+                prev = log;
+                log = log->next;
+        }
+}
+
+void SH_JobLogDrain(void)
+{
+        SH_JobLog *log = job_log_head;
+
+        while (log != NULL) {
+                if (log->fd != -1) {
+                        SH_JobLogRead(log);
+                }
+                log = log->next;
+        }
+}
+
+SH_JobLog *SH_JobLogFind(char const *spec)
+{
+        SH_JobLog *log;
+        unsigned long n;
+        char *end;
+        bool is_spec;
+
+        is_spec = spec[0] == '%';
+        if (is_spec) {
+                spec++;
+        }
+
+        errno = 0;
+        n = strtoul(spec, &end, 10);
+        if (spec[0] < '0' || spec[0] > '9' || *end != '\0' || errno != 0) {
+                return NULL;
+        }
+
+        /* Job specs are reused, so the newest log with one wins. */
+        log = job_log_head;
+        while (log != NULL) {
+                if (is_spec ? log->spec == n
+                            : log->pid == (pid_t) n && n > 0) {
+                        return log;
+                }
+                log = log->next;
+        }
+
+        return NULL;
+}
+
+SH_JobLog *SH_JobLogFirst(void)
+{
+        return job_log_head;
+}
+
+void SH_JobLogPrint(SH_JobLog const *const log, FILE *const stream)
+{
+        size_t pos, len, skip;
+        char const *nl;
+
+        if (log->buf == NULL) {
+                return;
+        }
+
+        if (log->written <= log->size) {
+                fwrite(log->buf, 1, (size_t) log->written, stream);
+                return;
+        }
+
+        /* The oldest byte kept follows the newest. */
+        pos = (size_t) (log->written % log->size);
+        len = log->size - pos;
+
+        /* Skip the partial line it starts, unless that line is all there is. */
+        skip = 0;
+        nl = memchr(log->buf + pos, '\n', len);
+        if (nl != NULL) {
+                skip = (size_t) (nl + 1 - (log->buf + pos));
+        } else {
+                nl = memchr(log->buf, '\n', pos);
+                if (nl != NULL) {
+                        skip = len + (size_t) (nl + 1 - log->buf);
+                }
+        }
+        if (skip == log->size) {
+                skip = 0;
+        }
+
+        if (skip < len) {
+                fwrite(log->buf + pos + skip, 1, len - skip, stream);
+                fwrite(log->buf, 1, pos, stream);
+        } else {
+                fwrite(log->buf + (skip - len), 1, pos - (skip - len), stream);
+        }
+}
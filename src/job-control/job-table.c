@@ -8,11 +8,96 @@
  * https://www.gnu.org/software/libc/manual/html_node/Data-Structures.html
  */
 #define _GNU_SOURCE
+#include <errno.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "job-control/job-table.h"
+#include "job-control/journal.h"
+#include "job-control/notice.h"
+
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Checks whether @p job is a background job that is running.
+ */
+static bool SH_JobTableIsRunning(SH_Job const *const job)
+{
+        return job->run_bg && !job->pending && job->proc->pid > 0
+               && !job->proc->has_completed;
+}
+
+/**
+ * @brief Lists @p job and the jobs after it, oldest first.
+ *
+ * Jobs are linked newest first, so those after @p job are printed before it.
+ */
+static void SH_JobTableListJob(SH_Job const *const job,
+                               unsigned const last_spec_01,
+                               unsigned const last_spec_02, bool const usage)
+{
+        char buf[128];
+
+        if (job == NULL) {
+                return;
+        }
+        SH_JobTableListJob(job->next, last_spec_01, last_spec_02, usage);
+
+        if (!job->run_bg || (!job->pending && !SH_JobTableIsRunning(job))) {
+                return;
+        }
+
+        fprintf(stdout, "[%d]", job->spec);
+        if (job->spec == last_spec_01) {
+                fprintf(stdout, "+");
+        } else if (job->spec == last_spec_02) {
+                fprintf(stdout, "-");
+        }
+
+        /* Pending jobs have no process yet. */
+        if (job->pending) {
+                fprintf(stdout, "\t\tPending");
+        } else {
+                fprintf(stdout, "\t%d\tRunning", job->proc->pid);
+                if (usage) {
+                        SH_ProcessSampleUsage(job->proc);
+                        SH_ProcessFormatUsage(job->proc, buf, sizeof buf);
+                        fprintf(stdout, "\t\t%s", buf);
+                }
+        }
+
+        fprintf(stdout, "\t\t%s\n", job->command);
+}
 
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
@@ -56,6 +141,8 @@ SH_JobTable *SH_CreateJobTable(void)
 
         /* Init table data. */
         table->n_jobs = 0;
+        table->max_running = 0;
+        table->exit_timeout = SH_JOB_TABLE_EXIT_TIMEOUT;
         table->head = NULL;
 
         return table;
@@ -100,6 +187,70 @@ void SH_JobTableAddJob(SH_JobTable *table, SH_Job *job)
                 table->head = job;
         }
         table->n_jobs++;
+
+        SH_JournalLog(JOURNAL_CREATED, job, 0);
+}
+
+void SH_JobTableRemoveJob(SH_JobTable *table, SH_Job *job)
+{
+        SH_Job **link = &table->head;
+
+        /* Find link pointing at job, and unlink it. */
+        while (*link != NULL && *link != job) {
+                link = &(*link)->next;
+        }
+        if (*link == NULL) {
+                return;
+        }
+        *link = job->next;
+        table->n_jobs--;
+
+        SH_DestroyJob(job);
+}
+
+size_t SH_JobTableCountRunning(SH_JobTable const *table)
+{
+        size_t n_running = 0;
+
+        for (SH_Job *job = table->head; job != NULL; job = job->next) {
+                if (SH_JobTableIsRunning(job)) {
+                        n_running++;
+                }
+        }
+
+        return n_running;
+}
+
+size_t SH_JobTableCountPending(SH_JobTable const *table)
+{
+        size_t n_pending = 0;
+
+        for (SH_Job *job = table->head; job != NULL; job = job->next) {
+                if (job->pending) {
+                        n_pending++;
+                }
+        }
+
+        return n_pending;
+}
+
+SH_Job *SH_JobTableNextPending(SH_JobTable const *table)
+{
+        SH_Job *next = NULL;
+
+        /* Jobs are linked newest first, so the last pending one is oldest. */
+        for (SH_Job *job = table->head; job != NULL; job = job->next) {
+                if (job->pending) {
+                        next = job;
+                }
+        }
+
+        if (next != NULL && table->max_running > 0
+            && SH_JobTableCountRunning(table) >= table->max_running) {
+                return NULL;
+        }
+
+        return next;
 }
 
 void SH_JobTableCleanJobs(SH_JobTable *table)
@@ -107,6 +258,7 @@ void SH_JobTableCleanJobs(SH_JobTable *table)
         /* Track last and second last jobs for display options. */
         unsigned last_spec_01 = 0;
         unsigned last_spec_02 = 0;
+        char marker;
 
         SH_Job *pre = NULL;
         SH_Job *cur = table->head;
@@ -122,27 +274,14 @@ void SH_JobTableCleanJobs(SH_JobTable *table)
                 if (cur->proc->has_completed) {
                         /* Background job completed; notify user. */
                         if (cur->run_bg) {
-                                /* Print job info. */
-                                fprintf(stdout, "[%d]", cur->spec);
                                 if (cur->spec == last_spec_01) {
-                                        fprintf(stdout, "+");
+                                        marker = '+';
                                 } else if (cur->spec == last_spec_02) {
-                                        fprintf(stdout, "-");
-                                }
-
-                                fprintf(stdout, "\t%d", cur->proc->pid);
-
-                                fprintf(stdout, "\tDone");
-
-                                if (cur->proc->status == 0) {
-                                        fprintf(stdout, "\t\texit value 0");
+                                        marker = '-';
                                 } else {
-                                        fprintf(stdout, "\t\tterminated by signal %d",
-                                                cur->proc->status);
+                                        marker = 0;
                                 }
-
-                                fprintf(stdout, "\t\t%s\n", cur->command);
-                                fflush(stdout);
+                                SH_NoticeJobDone(cur, marker);
                         }
 
                         /* Remove job and free its memory. */
@@ -190,17 +329,69 @@ SH_Job *SH_JobTableFindJob(const SH_JobTable *table, pid_t job_pgid)
         return NULL;
 }
 
-void SH_JobTableKillAllJobs(SH_JobTable *table)
+SH_Job *SH_JobTableFindSpec(SH_JobTable const *table, char const *spec)
+{
+        SH_Job *job;
+        unsigned long n;
+        char *end;
+        bool is_spec;
+
+        is_spec = spec[0] == '%';
+        if (is_spec) {
+                spec++;
+        }
+
+        errno = 0;
+        n = strtoul(spec, &end, 10);
+        if (spec[0] < '0' || spec[0] > '9' || *end != '\0' || errno != 0) {
+                return NULL;
+        }
+
+        /* Search all entries for job with matching spec, or process. */
+        job = table->head;
+        while (job != NULL) {
+                if (is_spec ? job->spec == n
+                            : job->proc->pid == (pid_t) n && n > 0) {
+                        return job;
+                }
+                job = job->next;
+        }
+
+        /* Job not found. */
+        return NULL;
+}
+
+size_t SH_JobTableSignalJobs(SH_JobTable const *table, int const sig)
 {
+        size_t n_groups = 0;
         SH_Job *job = table->head;
 
         while (job != NULL) {
-                pid_t pid = job->proc->pid;
-                kill(pid, SIGTERM);
+                /* Pending jobs were never started. */
+                if (job->pgid > 0 && kill(-job->pgid, sig) == 0) {
+                        n_groups++;
+                }
                 job = job->next;
         }
 
-        SH_JobTableCleanJobs(table);
+        return n_groups;
+}
+
+void SH_JobTableListJobs(SH_JobTable const *table, bool const usage)
+{
+        unsigned last_spec_01 = 0;
+        unsigned last_spec_02 = 0;
+
+        /* Mark last and second last jobs for print display. */
+        if (table->head != NULL) {
+                last_spec_01 = table->head->spec;
+                if (table->head->next != NULL) {
+                        last_spec_02 = table->head->next->spec;
+                }
+        }
+
+        SH_JobTableListJob(table->head, last_spec_01, last_spec_02, usage);
+        fflush(stdout);
 }
 
 void SH_JobTablePrintJobs(const SH_JobTable *table)
@@ -209,23 +400,27 @@ void SH_JobTablePrintJobs(const SH_JobTable *table)
         while (job != NULL) {
                 printf("JOB:\n"
                        "\tpgid=%d\n"
-                       "\tstdin=%s\n"
-                       "\tstdout=%s\n"
+                       "\tstdin=%d\n"
+                       "\tstdout=%d\n"
+                       "\tstderr=%d\n"
                        "\tspec=%d\n"
                        "\tPROC:\n"
                        "\t\targv[0]=%s\n"
                        "\t\tpid=%d\n"
                        "\t\tcompleted=%d\n"
                        "\t\tstatus=%d\n",
-                       job->pgid, job->infile,
-                       job->outfile, job->spec, job->proc->args[0],
+                       job->pgid, job->redirs.fds[STDIN_FILENO],
+                       job->redirs.fds[STDOUT_FILENO],
+                       job->redirs.fds[STDERR_FILENO], job->spec,
+                       job->proc->args[0],
                        job->proc->pid, job->proc->has_completed,
                        job->proc->status);
                 job = job->next;
         }
 }
 
-int SH_JobTableUpdateJob(const SH_JobTable *table, pid_t pid, int status)
+int SH_JobTableUpdateJob(const SH_JobTable *table, pid_t pid, int status,
+                         struct rusage const *usage, uint64_t finished)
 {
         /* Find job with matching PID. */
         SH_Job *job = table->head;
@@ -242,8 +437,8 @@ int SH_JobTableUpdateJob(const SH_JobTable *table, pid_t pid, int status)
         }
 
         /* Update job status. */
-        job->proc->status = status;
-        job->proc->has_completed = true;
+        SH_ProcessComplete(job->proc, status, usage, finished);
+        SH_JournalLog(JOURNAL_REAPED, job, status);
 
         return 0;
 }
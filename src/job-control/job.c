@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "job-control/job.h"
+#include "job-control/job-log.h"
 
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
@@ -44,8 +45,7 @@
  *
  *
  ******************************************************************************/
-SH_Job *SH_CreateJob(char *command, SH_Process *proc, char *infile,
-                     char *outfile, bool run_bg)
+SH_Job *SH_CreateJob(char *command, SH_Process *proc, bool run_bg)
 {
         SH_Job *job;
 
@@ -66,36 +66,19 @@ SH_Job *SH_CreateJob(char *command, SH_Process *proc, char *infile,
         job->proc = proc;
         job->pgid = 0;
         job->run_bg = run_bg;
+        job->pending = false;
+        job->paused = false;
+        job->cpu = -1;
+        job->log = NULL;
+
+        /* Limits are fixed now, even if the job is only started later. */
+        SH_LimitsCurrent(&job->limits);
 
         /* Next job is null (for use with job table). */
         job->next = NULL;
 
-        /* Copy input/output file names. */
-        /* Case 1: Filename is a string. */
-        if (infile != NULL) {
-                job->infile = strdup(infile);
-                if (job->infile == NULL) {
-                        fprintf(stderr, "strdup\n");
-                        exit(1);
-                }
-        }
-        /* Case 2: Filename is null. */
-        else {
-                job->infile = NULL;
-        }
-
-        /* Case 1: Filename is a string. */
-        if (outfile != NULL) {
-                job->outfile = strdup(outfile);
-                if (job->outfile == NULL) {
-                        fprintf(stderr, "strdup\n");
-                        exit(1);
-                }
-        }
-        /* Case 2: Filename is null. */
-        else {
-                job->outfile = NULL;
-        }
+        /* Redirections are opened separately, by the shell. */
+        SH_RedirsInit(&job->redirs);
 
         return job;
 }
@@ -112,14 +95,16 @@ void SH_DestroyJob(SH_Job *job)
         /* Clear variables. */
         job->pgid = 0;
         job->run_bg = false;
+        job->pending = false;
+        job->paused = false;
+        job->cpu = -1;
         job->next = NULL;
 
-        /* Free input/output file names. */
-        free(job->infile);
-        job->infile = NULL;
+        /* Its log outlives it, for a while. */
+        SH_JobLogRelease(job);
 
-        free(job->outfile);
-        job->outfile = NULL;
+        /* Close redirections, if job was never launched. */
+        SH_RedirsClose(&job->redirs);
 
         free(job);
 }
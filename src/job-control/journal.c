@@ -0,0 +1,267 @@
+/**
+ * @file journal.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For logging job lifecycle events to a binary file, for post-mortem
+ * analysis.
+ *
+ * The journal is a file of fixed-size records, used as a ring: once it is
+ * full, the oldest records are overwritten. It is mapped into memory, so that
+ * logging an event costs one copy, and no system call, and what was logged
+ * survives the shell crashing. Sessions that share a journal file append to
+ * it in turn.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "job-control/journal.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static SH_JournalHeader *journal = NULL; /**< mapped journal, or NULL */
+static SH_JournalRecord *journal_records = NULL; /**< records after header */
+static size_t journal_size = 0; /**< size of the mapping */
+static int32_t journal_session = 0; /**< shell's PID */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Returns the size of a journal file holding @p capacity records.
+ */
+static size_t SH_JournalFileSize(uint64_t const capacity)
+{
+        return sizeof(SH_JournalHeader)
+               + (size_t) capacity * sizeof(SH_JournalRecord);
+}
+
+/**
+ * @brief Checks whether an existing file of @p size bytes, starting with
+ * @p header, is a journal that can be appended to.
+ */
+static bool SH_JournalIsValid(SH_JournalHeader const *const header,
+                              off_t const size)
+{
+        return memcmp(header->magic, SH_JOURNAL_MAGIC,
+                      sizeof header->magic) == 0
+               && header->version == SH_JOURNAL_VERSION
+               && header->record_size == sizeof(SH_JournalRecord)
+               && header->capacity > 0
+               && (off_t) SH_JournalFileSize(header->capacity) == size;
+}
+
+/**
+ * @brief Returns the realtime clock minus the monotonic clock, so that event
+ * times can be shown as dates.
+ */
+static int64_t SH_JournalClockOffset(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+
+        return (int64_t) ts.tv_sec * 1000000000LL + (int64_t) ts.tv_nsec
+               - (int64_t) SH_TraceNow();
+}
+
+/**
+ * @brief Converts @p tv to microseconds.
+ */
+static int64_t SH_JournalMicros(struct timeval const *const tv)
+{
+        return (int64_t) tv->tv_sec * 1000000 + (int64_t) tv->tv_usec;
+}
+
+/**
+ * @brief Reports a failure to open the journal at @p path.
+ */
+static void SH_JournalFail(char const *const path)
+{
+        fprintf(stderr, "-smallsh: journal: %s: %s\n", path, strerror(errno));
+        fflush(stderr);
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_JournalInit(void)
+{
+        char const *path;
+        SH_JournalHeader header;
+        struct stat st;
+        bool valid;
+        void *map;
+        int fd;
+
+        path = getenv("SMALLSH_JOURNAL");
+        if (path == NULL || *path == '\0') {
+                return;
+        }
+
+        errno = 0;
+        fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd == -1 || fstat(fd, &st) == -1) {
+                SH_JournalFail(path);
+                if (fd != -1) {
+                        close(fd);
+                }
+                return;
+        }
+
+        /* Append to an existing journal, or start a new one. */
+        valid = pread(fd, &header, sizeof header, 0) == sizeof header
+                && SH_JournalIsValid(&header, st.st_size);
+        if (!valid) {
+                memset(&header, 0, sizeof header);
+                memcpy(header.magic, SH_JOURNAL_MAGIC, sizeof header.magic);
+                header.version = SH_JOURNAL_VERSION;
+                header.record_size = sizeof(SH_JournalRecord);
+                header.capacity = SH_JOURNAL_RECORDS;
+
+                errno = 0;
+                if (ftruncate(fd, 0) == -1
+                    || ftruncate(fd, (off_t) SH_JournalFileSize(
+                                header.capacity)) == -1) {
+                        SH_JournalFail(path);
+                        close(fd);
+                        return;
+                }
+        }
+
+        journal_size = SH_JournalFileSize(header.capacity);
+        errno = 0;
+        map = mmap(NULL, journal_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                   0);
+        close(fd);
+        if (map == MAP_FAILED) {
+                SH_JournalFail(path);
+                return;
+        }
+
+        journal = map;
+        journal_records = (SH_JournalRecord *) (journal + 1);
+        if (!valid) {
+                memcpy(journal, &header, sizeof header);
+        }
+        journal->clock_offset = SH_JournalClockOffset();
+        journal_session = (int32_t) getpid();
+}
+
+void SH_JournalLog(SH_JournalEvent const event, SH_Job const *const job,
+                   int const status)
+{
+        SH_JournalRecord record;
+        SH_Process const *proc;
+
+        if (journal == NULL) {
+                return;
+        }
+        proc = job->proc;
+
+        memset(&record, 0, sizeof record);
+        record.time = SH_TraceNow();
+        record.session = journal_session;
+        record.pid = (int32_t) proc->pid;
+        record.pgid = (int32_t) job->pgid;
+        record.status = status;
+        record.event = (uint16_t) event;
+        record.background = job->run_bg;
+        record.spec = job->spec;
+        /* Commands fill the field, unterminated, when they are too long. */
+        memcpy(record.command, job->command,
+               strnlen(job->command, sizeof record.command));
+
+        /* Reaped processes carry the time and usage they were reaped with. */
+        if (event == JOURNAL_REAPED) {
+                record.time = proc->finished;
+                record.utime_us = SH_JournalMicros(&proc->usage.ru_utime);
+                record.stime_us = SH_JournalMicros(&proc->usage.ru_stime);
+                record.maxrss_kb = proc->usage.ru_maxrss;
+                record.nvcsw = proc->usage.ru_nvcsw;
+                record.nivcsw = proc->usage.ru_nivcsw;
+        }
+
+        /* Claim a slot, even if other sessions are logging to the journal. */
+        record.seq = __atomic_fetch_add(&journal->head, 1, __ATOMIC_RELAXED);
+        memcpy(&journal_records[record.seq % journal->capacity], &record,
+               sizeof record);
+}
+
+void SH_JournalShutdown(void)
+{
+        if (journal == NULL) {
+                return;
+        }
+
+        munmap(journal, journal_size);
+        journal = NULL;
+        journal_records = NULL;
+}
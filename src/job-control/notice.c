@@ -0,0 +1,333 @@
+/**
+ * @file notice.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Renders job notices, such as completed background jobs, for the
+ * user.
+ *
+ * Notices are formatted into a single buffer, and written out together with
+ * the next prompt in one system call, so that reporting on many jobs at once
+ * does not cost a write for each line of each of them.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "job-control/notice.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static char notice_buf[SH_NOTICE_BUF_SIZE]; /**< notices not yet written */
+static size_t notice_len = 0; /**< bytes used in notice_buf */
+static SH_NoticeFormat notice_format = NOTICE_TEXT; /**< see SH_NoticeSetFormat */
+static int notice_fd = STDOUT_FILENO; /**< see SH_NoticeSetFd */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Writes all of @p iov to @c notice_fd, resuming after short writes.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_NoticeWrite(struct iovec *iov, int iovcnt)
+{
+        ssize_t n;
+
+        while (iovcnt > 0) {
+                n = writev(notice_fd, iov, iovcnt);
+                if (n == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                }
+
+                /* Skip past whatever was written. */
+                while (iovcnt > 0 && (size_t) n >= iov->iov_len) {
+                        n -= (ssize_t) iov->iov_len;
+                        iov++;
+                        iovcnt--;
+                }
+                if (iovcnt > 0) {
+                        iov->iov_base = (char *) iov->iov_base + n;
+                        iov->iov_len -= (size_t) n;
+                }
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Appends formatted text to the notice buffer, writing the buffer out
+ * first if it is too full to hold it.
+ *
+ * Formatted text is kept short, well under @c SH_NOTICE_BUF_SIZE; commands
+ * are appended with @c SH_NoticeAppendCommand.
+ */
+static void SH_NoticeAppend(char const *fmt, ...)
+{
+        va_list args;
+        int n;
+
+        va_start(args, fmt);
+        n = vsnprintf(notice_buf + notice_len, sizeof notice_buf - notice_len,
+                      fmt, args);
+        va_end(args);
+        if (n < 0) {
+                return;
+        }
+
+        if ((size_t) n >= sizeof notice_buf - notice_len) {
+                SH_NoticeFlush(NULL, 0);
+
+                va_start(args, fmt);
+                n = vsnprintf(notice_buf, sizeof notice_buf, fmt, args);
+                va_end(args);
+                if (n < 0) {
+                        return;
+                }
+                if ((size_t) n >= sizeof notice_buf) {
+                        n = sizeof notice_buf - 1;
+                }
+        }
+        notice_len += (size_t) n;
+}
+
+/**
+ * @brief Appends a single character to the notice buffer.
+ */
+static void SH_NoticeAppendChar(char const c)
+{
+        if (notice_len == sizeof notice_buf) {
+                SH_NoticeFlush(NULL, 0);
+        }
+        notice_buf[notice_len++] = c;
+}
+
+/**
+ * @brief Appends @p command to the notice buffer, as a JSON string in JSON
+ * mode, and as is otherwise.
+ */
+static void SH_NoticeAppendCommand(char const *command)
+{
+        unsigned char c;
+
+        if (notice_format == NOTICE_TEXT) {
+                for (; *command != '\0'; command++) {
+                        SH_NoticeAppendChar(*command);
+                }
+                return;
+        }
+
+        SH_NoticeAppendChar('"');
+        for (; *command != '\0'; command++) {
+                c = (unsigned char) *command;
+
+                /* The command's own line ending is not part of it. */
+                if (c == '\n' && command[1] == '\0') {
+                        break;
+                }
+
+                if (c == '"' || c == '\\') {
+                        SH_NoticeAppendChar('\\');
+                        SH_NoticeAppendChar((char) c);
+                } else if (c < 0x20) {
+                        SH_NoticeAppend("\\u%04x", c);
+                } else {
+                        SH_NoticeAppendChar((char) c);
+                }
+        }
+        SH_NoticeAppendChar('"');
+}
+
+/**
+ * @brief Returns the seconds in @p tv.
+ */
+static double SH_NoticeSeconds(struct timeval const *tv)
+{
+        return (double) tv->tv_sec + (double) tv->tv_usec / 1e6;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_NoticeSetFormat(SH_NoticeFormat const format)
+{
+        notice_format = format;
+}
+
+SH_NoticeFormat SH_NoticeGetFormat(void)
+{
+        return notice_format;
+}
+
+int SH_NoticeSetFd(int const fd)
+{
+        int old;
+
+        old = notice_fd;
+        notice_fd = fd;
+
+        return old;
+}
+
+void SH_NoticeJobStarted(SH_Job const *const job)
+{
+        if (notice_format == NOTICE_TEXT) {
+                SH_NoticeAppend("[%u]\t%d\n", job->spec, (int) job->proc->pid);
+                return;
+        }
+
+        SH_NoticeAppend("{\"event\":\"started\",\"job\":%u,\"pid\":%d,"
+                        "\"command\":", job->spec, (int) job->proc->pid);
+        SH_NoticeAppendCommand(job->command);
+        SH_NoticeAppend("}\n");
+}
+
+void SH_NoticeJobPending(SH_Job const *const job)
+{
+        if (notice_format == NOTICE_TEXT) {
+                SH_NoticeAppend("[%u]\tpending\n", job->spec);
+                return;
+        }
+
+        SH_NoticeAppend("{\"event\":\"pending\",\"job\":%u,\"command\":",
+                        job->spec);
+        SH_NoticeAppendCommand(job->command);
+        SH_NoticeAppend("}\n");
+}
+
+void SH_NoticeJobDone(SH_Job const *const job, char const marker)
+{
+        SH_Process const *proc = job->proc;
+        char usage[128];
+        int status;
+
+        status = proc->status;
+
+        if (notice_format == NOTICE_TEXT) {
+                SH_ProcessFormatUsage(proc, usage, sizeof usage);
+                SH_NoticeAppend("[%u]%s\t%d\tDone", job->spec,
+                                marker == '+' ? "+" : marker == '-' ? "-" : "",
+                                (int) proc->pid);
+                if (status == 0) {
+                        SH_NoticeAppend("\t\texit value 0");
+                } else {
+                        SH_NoticeAppend("\t\tterminated by signal %d", status);
+                }
+                SH_NoticeAppend("\t\t%s\t\t", usage);
+                SH_NoticeAppendCommand(job->command);
+                SH_NoticeAppend("\n");
+                return;
+        }
+
+        SH_NoticeAppend("{\"event\":\"done\",\"job\":%u,\"pid\":%d,",
+                        job->spec, (int) proc->pid);
+        if (WIFSIGNALED(status)) {
+                SH_NoticeAppend("\"signal\":%d,", WTERMSIG(status));
+        } else {
+                SH_NoticeAppend("\"exit\":%d,", WEXITSTATUS(status));
+        }
+        SH_NoticeAppend("\"real\":%.6f,\"user\":%.6f,\"sys\":%.6f,"
+                        "\"maxrss_kb\":%ld,\"nvcsw\":%ld,\"nivcsw\":%ld,"
+                        "\"command\":",
+                        (double) SH_ProcessWallTime(proc) / 1e9,
+                        SH_NoticeSeconds(&proc->usage.ru_utime),
+                        SH_NoticeSeconds(&proc->usage.ru_stime),
+                        proc->usage.ru_maxrss, proc->usage.ru_nvcsw,
+                        proc->usage.ru_nivcsw);
+        SH_NoticeAppendCommand(job->command);
+        SH_NoticeAppend("}\n");
+}
+
+int SH_NoticeFlush(char const *const prompt, size_t const len)
+{
+        struct iovec iov[2];
+        int iovcnt;
+        int status;
+
+        iovcnt = 0;
+        if (notice_len > 0) {
+                iov[iovcnt].iov_base = notice_buf;
+                iov[iovcnt].iov_len = notice_len;
+                iovcnt++;
+        }
+        if (prompt != NULL && len > 0) {
+                iov[iovcnt].iov_base = (char *) prompt;
+                iov[iovcnt].iov_len = len;
+                iovcnt++;
+        }
+        if (iovcnt == 0) {
+                return 0;
+        }
+
+        fflush(stdout);
+        status = SH_NoticeWrite(iov, iovcnt);
+        notice_len = 0;
+
+        return status;
+}
@@ -0,0 +1,429 @@
+/**
+ * @file prepare.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Speculative preparation of commands before they are launched.
+ *
+ * While a foreground job runs, the shell can get ahead on the setup of the
+ * commands likely to follow it: resolving their programs on PATH, warming the
+ * page cache for their binaries, and opening their input redirection files.
+ * Launching a prepared command then skips that work. Everything prepared is
+ * checked against the shell's current state before use, and discarded if the
+ * working directory, PATH, or the files involved have since changed.
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "builtins/builtins.h"
+#include "job-control/prepare.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A command seen by the shell, and what has been prepared for it.
+ */
+typedef struct {
+        char *name; /**< command name, as typed */
+        char *path; /**< resolved program path, or NULL if not prepared */
+        size_t hits; /**< number of times command was run */
+} SH_PrepareCmd;
+
+/**
+ * @brief An input redirection file opened ahead of its command.
+ */
+typedef struct {
+        char *file; /**< input filename, as typed */
+        int fd; /**< descriptor open on file */
+} SH_PrepareFile;
+
+static SH_PrepareCmd prepare_cmds[SH_PREPARE_CACHE_SIZE]; /**< commands seen */
+static size_t prepare_n_cmds = 0; /**< number of commands seen */
+static SH_PrepareFile prepare_inputs[SH_PREPARE_INPUTS]; /**< open inputs */
+static size_t prepare_n_inputs = 0; /**< number of open inputs */
+static char *prepare_path_env = NULL; /**< PATH commands were resolved on */
+
+/**
+ * @brief Search path used when PATH is unset, as with execvp.
+ */
+static char const * const PREPARE_DEFAULT_PATH = "/bin:/usr/bin";
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Drops every resolved path if PATH has changed since they were
+ * resolved.
+ *
+ * If the new PATH cannot be kept, resolution stays off until it can, and
+ * commands are left to execvp.
+ * @return true if commands can be resolved on the current PATH
+ */
+static bool SH_PrepareCheckPath(void)
+{
+        char const *path_env;
+
+        path_env = getenv("PATH");
+        if (path_env == NULL) {
+                path_env = PREPARE_DEFAULT_PATH;
+        }
+        if (prepare_path_env != NULL && strcmp(prepare_path_env, path_env) == 0) {
+                return true;
+        }
+
+        for (size_t i = 0; i < prepare_n_cmds; i++) {
+                free(prepare_cmds[i].path);
+                prepare_cmds[i].path = NULL;
+        }
+
+        free(prepare_path_env);
+        prepare_path_env = strdup(path_env);
+
+        return prepare_path_env != NULL;
+}
+
+/**
+ * @brief Finds the entry for command @p name, creating one if @p create is
+ * set.
+ *
+ * When the table is full, the least frequently run command is evicted.
+ * @return command entry, or @c NULL if not found
+ */
+static SH_PrepareCmd *SH_PrepareFind(char const * const name, bool const create)
+{
+        SH_PrepareCmd *cmd;
+        char *copy;
+
+        for (size_t i = 0; i < prepare_n_cmds; i++) {
+                if (strcmp(prepare_cmds[i].name, name) == 0) {
+                        return &prepare_cmds[i];
+                }
+        }
+        if (!create || (copy = strdup(name)) == NULL) {
+                return NULL;
+        }
+
+        if (prepare_n_cmds < SH_PREPARE_CACHE_SIZE) {
+                cmd = &prepare_cmds[prepare_n_cmds++];
+        } else {
+                cmd = &prepare_cmds[0];
+                for (size_t i = 1; i < prepare_n_cmds; i++) {
+                        if (prepare_cmds[i].hits < cmd->hits) {
+                                cmd = &prepare_cmds[i];
+                        }
+                }
+                free(cmd->name);
+                free(cmd->path);
+        }
+        cmd->name = copy;
+        cmd->path = NULL;
+        cmd->hits = 0;
+
+        return cmd;
+}
+
+/**
+ * @brief Checks that @p path is a regular file that we may execute.
+ */
+static bool SH_PrepareIsExecutable(char const * const path)
+{
+        struct stat st;
+
+        return stat(path, &st) == 0 && S_ISREG(st.st_mode)
+                && access(path, X_OK) == 0;
+}
+
+/**
+ * @brief Searches PATH for command @p name, the same way execvp does.
+ * @return resolved path, or @c NULL if not found
+ */
+static char *SH_PrepareResolve(char const * const name)
+{
+        char buf[PATH_MAX];
+        char const *dir, *end;
+        int len, n;
+
+        if (strchr(name, '/') != NULL) {
+                return SH_PrepareIsExecutable(name) ? strdup(name) : NULL;
+        }
+
+        for (dir = prepare_path_env; ; dir = end + 1) {
+                end = strchrnul(dir, ':');
+
+                /* An empty entry means the working directory. */
+                len = (int) (end - dir);
+                if (len == 0) {
+                        n = snprintf(buf, sizeof buf, "./%s", name);
+                } else {
+                        n = snprintf(buf, sizeof buf, "%.*s/%s", len, dir,
+                                     name);
+                }
+                if (n > 0 && (size_t) n < sizeof buf
+                    && SH_PrepareIsExecutable(buf)) {
+                        return strdup(buf);
+                }
+
+                if (*end == '\0') {
+                        return NULL;
+                }
+        }
+}
+
+/**
+ * @brief Asks the kernel to start reading @p fd's file into the page cache.
+ */
+static void SH_PrepareWarm(int const fd)
+{
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+}
+
+/**
+ * @brief Removes the input at index @p i from the open inputs.
+ * @return descriptor that was held for the input
+ */
+static int SH_PrepareRemoveInput(size_t const i)
+{
+        int fd;
+
+        fd = prepare_inputs[i].fd;
+        free(prepare_inputs[i].file);
+
+        prepare_n_inputs--;
+        memmove(&prepare_inputs[i], &prepare_inputs[i + 1],
+                (prepare_n_inputs - i) * sizeof *prepare_inputs);
+
+        return fd;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_PrepareCommand(char const * const name)
+{
+        SH_PrepareCmd *cmd;
+        int fd;
+
+        if (SH_IsBuiltin(name)) {
+                return;
+        }
+
+        if (!SH_PrepareCheckPath()) {
+                return;
+        }
+
+        cmd = SH_PrepareFind(name, true);
+        if (cmd == NULL || cmd->path != NULL) {
+                return; /* already prepared */
+        }
+
+        cmd->path = SH_PrepareResolve(name);
+        if (cmd->path == NULL) {
+                return;
+        }
+
+        fd = open(cmd->path, O_RDONLY | O_CLOEXEC);
+        if (fd != -1) {
+                SH_PrepareWarm(fd);
+                close(fd);
+        }
+}
+
+void SH_PrepareLikely(void)
+{
+        SH_PrepareCmd *best;
+
+        for (size_t n = 0; n < SH_PREPARE_LIKELY; n++) {
+                /* Commands run only once so far are not worth guessing on. */
+                best = NULL;
+                for (size_t i = 0; i < prepare_n_cmds; i++) {
+                        if (prepare_cmds[i].path == NULL
+                            && prepare_cmds[i].hits > 1
+                            && (best == NULL
+                                || prepare_cmds[i].hits > best->hits)) {
+                                best = &prepare_cmds[i];
+                        }
+                }
+                if (best == NULL) {
+                        break;
+                }
+
+                SH_PrepareCommand(best->name);
+                if (best->path == NULL) {
+                        break; /* not found; leave it for next time */
+                }
+        }
+}
+
+void SH_PrepareRecord(char const * const name)
+{
+        SH_PrepareCmd *cmd;
+
+        if (SH_IsBuiltin(name)) {
+                return;
+        }
+
+        cmd = SH_PrepareFind(name, true);
+        if (cmd != NULL) {
+                cmd->hits++;
+        }
+}
+
+char const *SH_PrepareLookup(char const * const name)
+{
+        SH_PrepareCmd *cmd;
+
+        if (prepare_path_env == NULL) {
+                return NULL; /* nothing prepared yet */
+        }
+
+        if (!SH_PrepareCheckPath()) {
+                return NULL;
+        }
+
+        cmd = SH_PrepareFind(name, false);
+
+        return cmd != NULL ? cmd->path : NULL;
+}
+
+void SH_PrepareInput(char const * const file)
+{
+        struct stat st;
+        int fd;
+
+        for (size_t i = 0; i < prepare_n_inputs; i++) {
+                if (strcmp(prepare_inputs[i].file, file) == 0) {
+                        return; /* already open */
+                }
+        }
+
+        /* FIFOs and devices may block or react to being opened. */
+        if (stat(file, &st) == -1 || !S_ISREG(st.st_mode)) {
+                return;
+        }
+
+        fd = open(file, O_RDONLY | O_CLOEXEC | O_NONBLOCK | O_NOCTTY);
+        if (fd == -1) {
+                return;
+        }
+        if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)
+            || fcntl(fd, F_SETFL, 0) == -1) {
+                close(fd);
+                return;
+        }
+        SH_PrepareWarm(fd);
+
+        /* Make room by dropping the oldest input. */
+        if (prepare_n_inputs == SH_PREPARE_INPUTS) {
+                close(SH_PrepareRemoveInput(0));
+        }
+
+        prepare_inputs[prepare_n_inputs].file = strdup(file);
+        if (prepare_inputs[prepare_n_inputs].file == NULL) {
+                close(fd);
+                return;
+        }
+        prepare_inputs[prepare_n_inputs++].fd = fd;
+}
+
+int SH_PrepareTakeInput(char const * const file)
+{
+        struct stat by_name, by_fd;
+        int fd;
+
+        for (size_t i = 0; i < prepare_n_inputs; i++) {
+                if (strcmp(prepare_inputs[i].file, file) != 0) {
+                        continue;
+                }
+
+                fd = SH_PrepareRemoveInput(i);
+
+                /* File may have been replaced or removed since. */
+                if (stat(file, &by_name) == -1 || fstat(fd, &by_fd) == -1
+                    || by_name.st_dev != by_fd.st_dev
+                    || by_name.st_ino != by_fd.st_ino) {
+                        close(fd);
+                        return -1;
+                }
+
+                return fd;
+        }
+
+        return -1;
+}
+
+void SH_PrepareInvalidate(void)
+{
+        for (size_t i = 0; i < prepare_n_cmds; i++) {
+                free(prepare_cmds[i].path);
+                prepare_cmds[i].path = NULL;
+        }
+
+        while (prepare_n_inputs > 0) {
+                close(SH_PrepareRemoveInput(prepare_n_inputs - 1));
+        }
+}
@@ -0,0 +1,263 @@
+/**
+ * @file pressure.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Holding back background jobs while the machine is under pressure.
+ *
+ * A fixed cap on running jobs cannot tell an idle machine from a saturated
+ * one. With pressure thresholds set, background jobs are only started while
+ * the kernel's pressure stall information (or, without it, the load average)
+ * stays under them, and are otherwise left pending, to be looked at again
+ * every @c SH_PRESSURE_INTERVAL.
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "job-control/pressure.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define PRESSURE_UNOPENED (-2) /**< file not opened yet */
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Files pressure is read from, by index into @c pressure_fds.
+ */
+enum {
+        PRESSURE_CPU, /**< CPU pressure stall information */
+        PRESSURE_IO, /**< I/O pressure stall information */
+        PRESSURE_MEMORY, /**< memory pressure stall information */
+        PRESSURE_LOADAVG, /**< load averages */
+        PRESSURE_N_FILES, /**< number of files */
+};
+
+/**
+ * @brief Paths of the files pressure is read from.
+ */
+static char const *const PRESSURE_FILES[] = {
+        [PRESSURE_CPU] = "/proc/pressure/cpu",
+        [PRESSURE_IO] = "/proc/pressure/io",
+        [PRESSURE_MEMORY] = "/proc/pressure/memory",
+        [PRESSURE_LOADAVG] = "/proc/loadavg",
+};
+
+static SH_Pressure pressure_max = { 0, 0, 0, 0 }; /**< thresholds */
+
+/**
+ * @brief Descriptors of @c PRESSURE_FILES, kept open and re-read from the
+ * start, or -1 if unavailable.
+ */
+static int pressure_fds[PRESSURE_N_FILES] = {
+        PRESSURE_UNOPENED, PRESSURE_UNOPENED,
+        PRESSURE_UNOPENED, PRESSURE_UNOPENED,
+};
+
+static uint64_t pressure_window = 0; /**< when the current interval began */
+static long pressure_launched = 0; /**< jobs started in current interval */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Starts a new interval, with no jobs started in it yet, if the
+ * current one is over.
+ */
+static void SH_PressureRollWindow(void)
+{
+        uint64_t now;
+
+        now = SH_TraceNow();
+        if (now - pressure_window >= SH_PRESSURE_INTERVAL) {
+                pressure_window = now;
+                pressure_launched = 0;
+        }
+}
+
+/**
+ * @brief Reads file @p file from the start into @p buf.
+ * @return 0 on success, -1 if the file is unavailable
+ */
+static int SH_PressureRead(int const file, char *const buf, size_t const size)
+{
+        ssize_t n;
+
+        if (pressure_fds[file] == PRESSURE_UNOPENED) {
+                pressure_fds[file] = open(PRESSURE_FILES[file],
+                                          O_RDONLY | O_CLOEXEC);
+        }
+        if (pressure_fds[file] == -1) {
+                return -1;
+        }
+
+        n = pread(pressure_fds[file], buf, size - 1, 0);
+        if (n <= 0) {
+                return -1;
+        }
+        buf[n] = '\0';
+
+        return 0;
+}
+
+/**
+ * @brief Returns whether or not the share of time some task stalled on
+ * resource @p file, over the last 10 seconds, exceeds @p max percent.
+ *
+ * Pressure stall information that cannot be read is taken to be under.
+ */
+static bool SH_PressureStalled(int const file, double const max)
+{
+        char buf[256];
+        char const *avg;
+
+        if (max <= 0 || SH_PressureRead(file, buf, sizeof buf) == -1) {
+                return false;
+        }
+
+        /* some avg10=1.23 avg60=... */
+        avg = strstr(buf, "some avg10=");
+        if (avg == NULL) {
+                return false;
+        }
+
+        return strtod(avg + strlen("some avg10="), NULL) > max;
+}
+
+/**
+ * @brief Returns whether or not the 1-minute load average per online CPU
+ * exceeds @p max.
+ */
+static bool SH_PressureLoaded(double const max)
+{
+        char buf[128];
+        long n_cpus;
+
+        if (max <= 0 || SH_PressureRead(PRESSURE_LOADAVG, buf,
+                                        sizeof buf) == -1) {
+                return false;
+        }
+
+        n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (n_cpus < 1) {
+                n_cpus = 1;
+        }
+
+        return strtod(buf, NULL) / (double) n_cpus > max;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Pressure SH_PressureGet(void)
+{
+        return pressure_max;
+}
+
+void SH_PressureSet(SH_Pressure const *const pressure)
+{
+        pressure_max = *pressure;
+}
+
+bool SH_PressureEnabled(void)
+{
+        return pressure_max.cpu > 0 || pressure_max.io > 0
+               || pressure_max.memory > 0 || pressure_max.load > 0;
+}
+
+bool SH_PressureAllowLaunch(void)
+{
+        long n_cpus;
+
+        if (!SH_PressureEnabled()) {
+                return true;
+        }
+
+        SH_PressureRollWindow();
+        n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (pressure_launched >= (n_cpus > 1 ? n_cpus : 1)) {
+                return false;
+        }
+
+        return !SH_PressureStalled(PRESSURE_CPU, pressure_max.cpu)
+               && !SH_PressureStalled(PRESSURE_IO, pressure_max.io)
+               && !SH_PressureStalled(PRESSURE_MEMORY, pressure_max.memory)
+               && !SH_PressureLoaded(pressure_max.load);
+}
+
+void SH_PressureNoteLaunch(void)
+{
+        if (SH_PressureEnabled()) {
+                SH_PressureRollWindow();
+                pressure_launched++;
+        }
+}
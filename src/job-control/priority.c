@@ -0,0 +1,204 @@
+/**
+ * @file priority.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Scheduling policy for background jobs.
+ *
+ * Background jobs run at a lower CPU and I/O priority than the foreground
+ * command the user is waiting on, so that interactive latency holds up even
+ * when the machine is saturated with batch work. Optionally, background jobs
+ * that keep a CPU busy are stopped outright while a foreground job runs.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <linux/ioprio.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "job-control/priority.h"
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define SH_PRIORITY_IO_LOWEST 7 /**< lowest level within an I/O class */
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static SH_Priority priority_bg = {
+        10, PRIORITY_IO_BEST_EFFORT, PRIORITY_SCHED_OTHER, false
+}; /**< policy background jobs are started under */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Returns whether or not @p job is a running background job that has
+ * kept at least @c SH_PRIORITY_HEAVY_CPU percent of a CPU busy.
+ */
+static bool SH_PriorityIsHeavy(SH_Job *const job)
+{
+        struct rusage const *usage;
+        uint64_t wall, cpu;
+
+        if (!job->run_bg || job->pending || job->proc->pid <= 0
+            || job->proc->has_completed) {
+                return false;
+        }
+
+        if (SH_ProcessSampleUsage(job->proc) == -1) {
+                return false;
+        }
+
+        usage = &job->proc->usage;
+        cpu = (uint64_t) (usage->ru_utime.tv_sec + usage->ru_stime.tv_sec)
+              * 1000000
+              + (uint64_t) (usage->ru_utime.tv_usec + usage->ru_stime.tv_usec);
+        wall = (SH_TraceNow() - job->proc->started) / 1000;
+
+        return wall > 0 && cpu * 100 >= wall * SH_PRIORITY_HEAVY_CPU;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Priority SH_PriorityGet(void)
+{
+        return priority_bg;
+}
+
+void SH_PrioritySet(SH_Priority const *const priority)
+{
+        priority_bg = *priority;
+}
+
+void SH_PriorityApply(void)
+{
+        struct sched_param param;
+        int nice, io_class, io_level;
+
+        if (priority_bg.nice > 0) {
+                errno = 0;
+                nice = getpriority(PRIO_PROCESS, 0);
+                if (errno == 0) {
+                        nice += priority_bg.nice;
+                        if (nice > SH_PRIORITY_MAX_NICE) {
+                                nice = SH_PRIORITY_MAX_NICE;
+                        }
+                        setpriority(PRIO_PROCESS, 0, nice);
+                }
+        }
+
+        if (priority_bg.io != PRIORITY_IO_NONE) {
+                io_class = priority_bg.io == PRIORITY_IO_IDLE
+                           ? IOPRIO_CLASS_IDLE : IOPRIO_CLASS_BE;
+                io_level = priority_bg.io == PRIORITY_IO_IDLE
+                           ? 0 : SH_PRIORITY_IO_LOWEST;
+                syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0,
+                        IOPRIO_PRIO_VALUE(io_class, io_level));
+        }
+
+        /* Niceness still orders SCHED_BATCH processes among themselves. */
+        if (priority_bg.sched != PRIORITY_SCHED_OTHER) {
+                param.sched_priority = 0;
+                sched_setscheduler(0, priority_bg.sched == PRIORITY_SCHED_IDLE
+                                      ? SCHED_IDLE : SCHED_BATCH, &param);
+        }
+}
+
+void SH_PriorityPauseBackground(SH_JobTable *const table)
+{
+        SH_Job *job = table->head;
+
+        if (!priority_bg.stop_heavy) {
+                return;
+        }
+
+        while (job != NULL) {
+                if (SH_PriorityIsHeavy(job) && kill(-job->pgid, SIGSTOP) == 0) {
+                        job->paused = true;
+                }
+                job = job->next;
+        }
+}
+
+void SH_PriorityResumeBackground(SH_JobTable *const table)
+{
+        SH_Job *job = table->head;
+
+        while (job != NULL) {
+                if (job->paused) {
+                        kill(-job->pgid, SIGCONT);
+                        job->paused = false;
+                }
+                job = job->next;
+        }
+}
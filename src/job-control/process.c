@@ -17,6 +17,8 @@
 #include <unistd.h>
 
 #include "job-control/process.h"
+#include "job-control/priority.h"
+#include "trace/trace.h"
 #include "signals/installer.h"
 #include "globals.h"
 #include "error.h"
@@ -56,12 +58,18 @@
  *
  * Wrapper around exec* call that executes new program with @p argv
  * as its arguments, and displays error on failure.
+ * @param path program resolved ahead of time, or @c NULL
  * @param argv arguments to pass to exec* function
  */
-static void SH_ExecProcess(char **argv)
+static void SH_ExecProcess(char const *path, char **argv)
 {
         int status;
 
+        /* Should the resolved program have gone away, search PATH anew. */
+        if (path != NULL) {
+                execv(path, argv);
+        }
+
         errno = 0;
         status = execvp(argv[0], argv);
         if (status == -1) {
@@ -71,6 +79,25 @@ static void SH_ExecProcess(char **argv)
         }
 }
 
+/**
+ * @brief Converts @p tv to seconds.
+ */
+static double SH_ProcessSeconds(struct timeval const *tv)
+{
+        return (double) tv->tv_sec + (double) tv->tv_usec / 1e6;
+}
+
+/**
+ * @brief Converts @p ticks of the kernel's clock to a @c timeval.
+ */
+static void SH_ProcessTicks(struct timeval *const tv, unsigned long ticks,
+                            long const hz)
+{
+        tv->tv_sec = (time_t) (ticks / (unsigned long) hz);
+        tv->tv_usec = (suseconds_t) (ticks % (unsigned long) hz
+                                     * 1000000 / (unsigned long) hz);
+}
+
 /**
  * @brief Creates new process group and assigns current process as the leader.
  * @param pgid new process group
@@ -87,111 +114,6 @@ static void SH_SetProcessGroup(pid_t *pgid)
         setpgid(pid, *pgid);
 }
 
-/**
- * @brief Opens IO streams for process.
- *
- * STDIN, STDOUT redirected to new streams.
- * @param infile filename to redirect STDIN to
- * @param outfile filename to redirect STDOUT to
- * @param foreground whether or not the process will run in foreground
- */
-static int SH_SetProcessIOStreams(char *infile, char *outfile, bool foreground)
-{
-        int status, stdin_flags, stdout_flags, mode;
-        char *default_io;
-        int fds[2];
-
-        default_io = "/dev/null";
-
-        stdin_flags = O_RDONLY;
-
-        /* Create file for stdout stream if it doesn't exit. */
-        stdout_flags = O_WRONLY | O_CREAT | O_TRUNC;
-
-        /* -rw-rw---- */
-        mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP;
-
-        /*
-         * Redirect to default stream if process will run in background, and
-         * the user failed to specify any input/output redirections.
-         */
-        if (infile == NULL && !foreground) {
-                infile = default_io;
-        }
-
-        if (outfile == NULL && !foreground) {
-                outfile = default_io;
-        }
-
-        /*
-         * At this point, infile/outfile can only be null if the process will
-         * run in foreground and the user did not specify any redirections for
-         * the respective streams.
-         */
-
-        /* Set the standard input stream of the new process. */
-        if (infile != NULL) {
-                /* Attempt to open input stream. */
-                errno = 0;
-                fds[0] = open(infile, stdin_flags, mode);
-                if (fds[0] == -1) {
-                        smallsh_errno = 1;
-                        fprintf(stderr, "-smallsh: %s: %s\n", infile, strerror(errno));
-                        fflush(stderr);
-                        return -1;
-                }
-
-                /* Duplicate STDIN if stream is not already pointing to STDIN. */
-                if (fds[0] != STDIN_FILENO) {
-                        errno = 0;
-                        status = dup2(fds[0], STDIN_FILENO);
-                        if (status == -1) {
-                                perror("dup2");
-                                _exit(1);
-                        }
-
-                        errno = 0;
-                        status = close(fds[0]);
-                        if (status == -1) {
-                                perror("close");
-                                _exit(1);
-                        }
-                }
-        }
-
-        /* Set the standard output stream of the new process. */
-        if (outfile != NULL) {
-                /* Attempt to open input stream. */
-                errno = 0;
-                fds[1] = open(outfile, stdout_flags, mode);
-                if (fds[1] == -1) {
-                        smallsh_errno = 1;
-                        fprintf(stderr, "-smallsh: %s: %s\n", outfile, strerror(errno));
-                        fflush(stderr);
-                        return -1;
-                }
-
-                /* Duplicate STDOUT if stream is not already pointing to STDOUT. */
-                if (fds[1] != STDOUT_FILENO) {
-                        errno = 0;
-                        status = dup2(fds[1], STDOUT_FILENO);
-                        if (status == -1) {
-                                perror("dup2");
-                                _exit(1);
-                        }
-
-                        errno = 0;
-                        status = close(fds[1]);
-                        if (status == -1) {
-                                perror("close");
-                                _exit(1);
-                        }
-                }
-        }
-
-        return 0;
-}
-
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -253,9 +175,13 @@ SH_Process *SH_CreateProcess(size_t n_args, char **args)
         proc->args[n_args] = NULL;
 
         /* Initialize remaining variables. */
+        proc->path = NULL;
         proc->pid = 0;
         proc->has_completed = false;
         proc->status = 0;
+        memset(&proc->usage, 0, sizeof proc->usage);
+        proc->started = 0;
+        proc->finished = 0;
 
         return proc;
 }
@@ -269,6 +195,8 @@ void SH_DestroyProcess(SH_Process *proc)
         }
         free(proc->args);
         proc->args = NULL;
+        free(proc->path);
+        proc->path = NULL;
 
         /* Reset remaining variables. */
         proc->pid = 0;
@@ -288,8 +216,96 @@ void SH_DestroyProcess(SH_Process *proc)
  *
  *
  ******************************************************************************/
-void SH_LaunchProcess(SH_Process *proc, pid_t pgid, char *infile, char *outfile,
-                      bool foreground)
+void SH_ProcessComplete(SH_Process *const proc, int const status,
+                        struct rusage const *const usage,
+                        uint64_t const finished)
+{
+        proc->status = status;
+        proc->has_completed = true;
+        proc->finished = finished;
+        if (usage != NULL) {
+                proc->usage = *usage;
+        }
+}
+
+int SH_ProcessSampleUsage(SH_Process *const proc)
+{
+        char path[64], line[256];
+        unsigned long utime, stime;
+        long hz;
+        char *fields;
+        FILE *file;
+
+        hz = sysconf(_SC_CLK_TCK);
+        if (proc->pid <= 0 || hz <= 0) {
+                return -1;
+        }
+
+        /* CPU times, in clock ticks, are fields 14 and 15 of stat. */
+        snprintf(path, sizeof path, "/proc/%d/stat", (int) proc->pid);
+        file = fopen(path, "r");
+        if (file == NULL) {
+                return -1;
+        }
+        fields = fgets(line, sizeof line, file);
+        fclose(file);
+
+        /* The command name may hold spaces, so skip past its closing paren. */
+        if (fields != NULL) {
+                fields = strrchr(line, ')');
+        }
+        if (fields == NULL
+            || sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u "
+                                  "%*u %lu %lu", &utime, &stime) != 2) {
+                return -1;
+        }
+        SH_ProcessTicks(&proc->usage.ru_utime, utime, hz);
+        SH_ProcessTicks(&proc->usage.ru_stime, stime, hz);
+
+        /* Peak RSS and context switches are in status. */
+        snprintf(path, sizeof path, "/proc/%d/status", (int) proc->pid);
+        file = fopen(path, "r");
+        if (file == NULL) {
+                return -1;
+        }
+        while (fgets(line, sizeof line, file) != NULL) {
+                sscanf(line, "VmHWM: %ld", &proc->usage.ru_maxrss);
+                sscanf(line, "voluntary_ctxt_switches: %ld",
+                       &proc->usage.ru_nvcsw);
+                sscanf(line, "nonvoluntary_ctxt_switches: %ld",
+                       &proc->usage.ru_nivcsw);
+        }
+        fclose(file);
+
+        return 0;
+}
+
+uint64_t SH_ProcessWallTime(SH_Process const *const proc)
+{
+        uint64_t end;
+
+        end = proc->has_completed ? proc->finished : SH_TraceNow();
+        if (end < proc->started) {
+                end = proc->started;
+        }
+
+        return end - proc->started;
+}
+
+int SH_ProcessFormatUsage(SH_Process const *const proc, char *const buf,
+                          size_t const size)
+{
+        return snprintf(buf, size, "real %.3fs user %.3fs sys %.3fs "
+                                   "maxrss %ldK csw %ld/%ld",
+                        (double) SH_ProcessWallTime(proc) / 1e9,
+                        SH_ProcessSeconds(&proc->usage.ru_utime),
+                        SH_ProcessSeconds(&proc->usage.ru_stime),
+                        proc->usage.ru_maxrss, proc->usage.ru_nvcsw,
+                        proc->usage.ru_nivcsw);
+}
+
+void SH_LaunchProcess(SH_Process *proc, pid_t pgid, SH_Redirs const *redirs,
+                      bool foreground, bool background)
 {
         int status;
 
@@ -312,11 +328,16 @@ void SH_LaunchProcess(SH_Process *proc, pid_t pgid, char *infile, char *outfile,
 
         SH_InstallerInstallChildProcessSignals(foreground);
 
+        /* Yield to the foreground command the user is waiting on. */
+        if (background) {
+                SH_PriorityApply();
+        }
+
         smallsh_errno = 0;
-        status = SH_SetProcessIOStreams(infile, outfile, foreground);
+        status = SH_RedirsApply(redirs);
         if (status == -1) {
                 return;
         }
 
-        SH_ExecProcess(proc->args);
+        SH_ExecProcess(proc->path, proc->args);
 }
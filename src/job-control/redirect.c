@@ -0,0 +1,384 @@
+/**
+ * @file redirect.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For opening a command's io redirections, and installing them.
+ *
+ * Redirection files are opened by the shell itself, before the command is
+ * forked, so that a missing or unwritable file is reported without paying for
+ * a fork, and the child is left with nothing to do but install the opened
+ * descriptors over its standard streams and exec.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "job-control/prepare.h"
+#include "job-control/redirect.h"
+#include "error.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static int redirect_devnull = -1; /**< shared /dev/null descriptor */
+
+/**
+ * @brief Device background commands read from and write to by default.
+ */
+static char const * const REDIRECT_DEVNULL = "/dev/null";
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Moves @p fd above the standard streams, so that installing one
+ * redirection can never clobber another.
+ * @return descriptor numbered 3 or above, or -1 on failure
+ */
+static int SH_RedirectRaise(int const fd)
+{
+        int raised;
+
+        if (fd == -1 || fd > STDERR_FILENO) {
+                return fd;
+        }
+
+        raised = fcntl(fd, F_DUPFD_CLOEXEC, STDERR_FILENO + 1);
+        close(fd);
+
+        return raised;
+}
+
+/**
+ * @brief Opens @p file with @p flags.
+ * @return close-on-exec descriptor numbered 3 or above, or -1 on failure
+ */
+static int SH_RedirectOpenFile(char const * const file, int const flags)
+{
+        /* -rw-rw---- */
+        mode_t const mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP;
+
+        return SH_RedirectRaise(open(file, flags | O_CLOEXEC, mode));
+}
+
+/**
+ * @brief Returns the shared /dev/null descriptor, opening it if needed.
+ * @return descriptor, or -1 on failure
+ */
+static int SH_RedirectDevNull(void)
+{
+        if (redirect_devnull == -1) {
+                redirect_devnull = SH_RedirectOpenFile(REDIRECT_DEVNULL,
+                                                       O_RDWR);
+        }
+
+        return redirect_devnull;
+}
+
+/**
+ * @brief Redirects standard stream @p stream to @p fd, replacing any earlier
+ * redirection of it.
+ */
+static void SH_RedirectSet(SH_Redirs *const redirs, int const stream,
+                           int const fd)
+{
+        if (redirs->fds[stream] >= 0
+            && redirs->fds[stream] != redirect_devnull) {
+                close(redirs->fds[stream]);
+        }
+        redirs->fds[stream] = fd;
+}
+
+/**
+ * @brief Reports a failure to open redirection @p file, and closes everything
+ * opened so far.
+ * @return -1
+ */
+static int SH_RedirectFail(SH_Redirs *const redirs, char const * const file)
+{
+        smallsh_errno = 1;
+        fprintf(stderr, "-smallsh: %s: %s\n", file, strerror(errno));
+        fflush(stderr);
+
+        SH_RedirsClose(redirs);
+
+        return -1;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_RedirsInit(SH_Redirs *const redirs)
+{
+        redirs->fds[STDIN_FILENO] = -1;
+        redirs->fds[STDOUT_FILENO] = -1;
+        redirs->fds[STDERR_FILENO] = -1;
+}
+
+int SH_RedirsOpen(SH_Redirs *const redirs, StmtStdin const *const in,
+                  StmtStdout const *const out, bool const background)
+{
+        char const *file;
+        int fd;
+
+        SH_RedirsInit(redirs);
+
+        for (size_t i = 0; i < in->n; i++) {
+                file = in->streams[i];
+
+                /* Use the descriptor opened while the last job ran, if any. */
+                errno = 0;
+                fd = SH_RedirectRaise(SH_PrepareTakeInput(file));
+                if (fd == -1) {
+                        fd = SH_RedirectOpenFile(file, O_RDONLY);
+                }
+                if (fd == -1) {
+                        return SH_RedirectFail(redirs, file);
+                }
+                SH_RedirectSet(redirs, STDIN_FILENO, fd);
+        }
+
+        for (size_t i = 0; i < out->n; i++) {
+                file = out->streams[i];
+
+                errno = 0;
+                switch (out->types[i]) {
+                        case IOREDIR_STDOUT:
+                        case IOREDIR_BOTH:
+                        case IOREDIR_STDERR:
+                                fd = SH_RedirectOpenFile(
+                                        file, O_WRONLY | O_CREAT | O_TRUNC);
+                                break;
+                        case IOREDIR_APPEND:
+                                fd = SH_RedirectOpenFile(
+                                        file, O_WRONLY | O_CREAT | O_APPEND);
+                                break;
+                        case IOREDIR_STDERR_TO_STDOUT:
+                                /*
+                                 * Unless stdout was redirected, follow it in
+                                 * the child, where it may not be the shell's.
+                                 */
+                                if (redirs->fds[STDOUT_FILENO] < 0) {
+                                        SH_RedirectSet(redirs, STDERR_FILENO,
+                                                       SH_REDIRS_STDOUT);
+                                        continue;
+                                }
+                                file = "dup";
+                                fd = fcntl(redirs->fds[STDOUT_FILENO],
+                                           F_DUPFD_CLOEXEC, STDERR_FILENO + 1);
+                                break;
+                        default:
+                                errno = EINVAL;
+                                fd = -1;
+                                break;
+                }
+                if (fd == -1) {
+                        return SH_RedirectFail(redirs, file);
+                }
+
+                switch (out->types[i]) {
+                        case IOREDIR_STDERR:
+                        case IOREDIR_STDERR_TO_STDOUT:
+                                SH_RedirectSet(redirs, STDERR_FILENO, fd);
+                                break;
+                        case IOREDIR_BOTH:
+                                SH_RedirectSet(redirs, STDOUT_FILENO, fd);
+                                fd = fcntl(fd, F_DUPFD_CLOEXEC,
+                                           STDERR_FILENO + 1);
+                                if (fd == -1) {
+                                        return SH_RedirectFail(redirs, "dup");
+                                }
+                                SH_RedirectSet(redirs, STDERR_FILENO, fd);
+                                break;
+                        default:
+                                SH_RedirectSet(redirs, STDOUT_FILENO, fd);
+                                break;
+                }
+        }
+
+        /*
+         * Redirect to default stream if process will run in background, and
+         * the user failed to specify any input/output redirections.
+         */
+        if (background) {
+                if (SH_RedirsNull(redirs, STDIN_FILENO) == -1
+                    || SH_RedirsNull(redirs, STDOUT_FILENO) == -1) {
+                        return SH_RedirectFail(redirs, REDIRECT_DEVNULL);
+                }
+        }
+
+        return 0;
+}
+
+int SH_RedirsNull(SH_Redirs *const redirs, int const stream)
+{
+        int fd;
+
+        if (redirs->fds[stream] != -1) {
+                return 0;
+        }
+
+        errno = 0;
+        fd = SH_RedirectDevNull();
+        if (fd == -1) {
+                return -1;
+        }
+        redirs->fds[stream] = fd;
+
+        return 0;
+}
+
+int SH_RedirsInherit(SH_Redirs *const redirs, SH_Redirs const *const from)
+{
+        int fd;
+
+        for (int stream = STDIN_FILENO; stream <= STDERR_FILENO; stream++) {
+                fd = from->fds[stream];
+                if (redirs->fds[stream] != -1 || fd == -1) {
+                        continue;
+                }
+
+                /* The shared /dev/null, and markers, need no copy. */
+                if (fd >= 0 && fd != redirect_devnull) {
+                        fd = fcntl(fd, F_DUPFD_CLOEXEC, STDERR_FILENO + 1);
+                        if (fd == -1) {
+                                return -1;
+                        }
+                }
+                redirs->fds[stream] = fd;
+        }
+
+        return 0;
+}
+
+int SH_RedirsCapture(SH_Redirs *const redirs, int const fd)
+{
+        bool out, err;
+        int dup;
+
+        out = redirect_devnull != -1
+              && redirs->fds[STDOUT_FILENO] == redirect_devnull;
+        err = redirs->fds[STDERR_FILENO] == -1;
+
+        if (out) {
+                /* A stderr following stdout would follow the one inherited. */
+                if (err) {
+                        dup = fcntl(fd, F_DUPFD_CLOEXEC, STDERR_FILENO + 1);
+                        if (dup == -1) {
+                                return -1;
+                        }
+                        SH_RedirectSet(redirs, STDERR_FILENO, dup);
+                }
+                SH_RedirectSet(redirs, STDOUT_FILENO, fd);
+        } else if (err) {
+                SH_RedirectSet(redirs, STDERR_FILENO, fd);
+        } else {
+                return -1;
+        }
+
+        return 0;
+}
+
+int SH_RedirsApply(SH_Redirs const *const redirs)
+{
+        int stdout_fd, fd;
+
+        /* Keep hold of stdout as it is now, should stderr need to follow it. */
+        stdout_fd = -1;
+        if (redirs->fds[STDERR_FILENO] == SH_REDIRS_STDOUT) {
+                stdout_fd = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC,
+                                  STDERR_FILENO + 1);
+                if (stdout_fd == -1) {
+                        perror("fcntl");
+                        return -1;
+                }
+        }
+
+        for (int stream = STDIN_FILENO; stream <= STDERR_FILENO; stream++) {
+                fd = redirs->fds[stream];
+                if (fd == SH_REDIRS_STDOUT) {
+                        fd = stdout_fd;
+                }
+                if (fd < 0) {
+                        continue;
+                }
+
+                /* Originals are close-on-exec; dup2 clears it on the copy. */
+                errno = 0;
+                if (dup2(fd, stream) == -1) {
+                        perror("dup2");
+                        return -1;
+                }
+        }
+
+        return 0;
+}
+
+void SH_RedirsClose(SH_Redirs *const redirs)
+{
+        for (int stream = STDIN_FILENO; stream <= STDERR_FILENO; stream++) {
+                SH_RedirectSet(redirs, stream, -1);
+        }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file rlimits.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Resource limits applied to jobs as they are spawned.
+ *
+ * Limits set with @c ulimit are kept by the shell, rather than applied to it,
+ * so that a memory cap meant for jobs cannot starve the shell itself. Each job
+ * takes a copy of them when created, and applies it in its child before exec.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <unistd.h>
+
+#include "job-control/rlimits.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static SH_Limits limits_shell = { .set = 0 }; /**< limits set by ulimit */
+static SH_Limits const *limits_command = NULL; /**< per-command overrides */
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_LimitsInit(SH_Limits *const limits)
+{
+        limits->set = 0;
+}
+
+SH_Limits *SH_LimitsShell(void)
+{
+        return &limits_shell;
+}
+
+void SH_LimitsSetCommand(SH_Limits const *const limits)
+{
+        limits_command = limits;
+}
+
+void SH_LimitsCurrent(SH_Limits *const limits)
+{
+        *limits = limits_command != NULL ? *limits_command : limits_shell;
+}
+
+int SH_LimitsGet(SH_Limits const *const limits, int const resource,
+                 struct rlimit *const value)
+{
+        if (resource < 0 || resource >= RLIM_NLIMITS) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        if ((limits->set & (1u << resource)) != 0) {
+                *value = limits->values[resource];
+                return 0;
+        }
+
+        return getrlimit(resource, value);
+}
+
+int SH_LimitsSet(SH_Limits *const limits, int const resource,
+                 struct rlimit const *const value)
+{
+        struct rlimit shell;
+
+        if (resource < 0 || resource >= RLIM_NLIMITS
+            || value->rlim_cur > value->rlim_max
+            || getrlimit(resource, &shell) == -1) {
+                errno = EINVAL;
+                return -1;
+        }
+
+        /* Raising a hard limit takes CAP_SYS_RESOURCE; assume only root. */
+        if (value->rlim_max > shell.rlim_max && geteuid() != 0) {
+                errno = EPERM;
+                return -1;
+        }
+
+        limits->values[resource] = *value;
+        limits->set |= 1u << resource;
+
+        return 0;
+}
+
+int SH_LimitsApply(SH_Limits const *const limits)
+{
+        for (int resource = 0; resource < RLIM_NLIMITS; resource++) {
+                if ((limits->set & (1u << resource)) != 0
+                    && setrlimit(resource, &limits->values[resource]) == -1) {
+                        return -1;
+                }
+        }
+
+        return 0;
+}
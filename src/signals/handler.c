@@ -13,6 +13,7 @@
 
 #include "signals/handler.h"
 #include "events/events.h"
+#include "globals.h"
 
 /* *****************************************************************************
  * PRIVATE DEFINITIONS
@@ -114,7 +115,7 @@ static void handler_switch_disable_fg_only_mode(void)
  *
  *
  ******************************************************************************/
-sig_atomic_t smallsh_fg_only_mode_flag = 0;
+volatile sig_atomic_t smallsh_fg_only_mode_flag = 0;
 
 /* *****************************************************************************
  * FUNCTIONS
@@ -166,6 +167,29 @@ void SH_HandlerHandleSigchld(int sig)
         errno = saved_errno;
 }
 
+void SH_HandlerForwardSignal(int sig)
+{
+        int status, saved_errno;
+        pid_t pgid;
+
+        saved_errno = errno;
+
+        pgid = smallsh_fg_pgid;
+        if (pgid > 0) {
+                kill(-pgid, sig);
+        }
+        smallsh_init_signal = sig;
+
+        status = SH_SenderNotifySignalEvent(signal_channel, sig);
+        if (status == -1) {
+                fprintf(stderr, "SH_SenderNotifySignalEvent()");
+                fflush(stderr);
+                _exit(1);
+        }
+
+        errno = saved_errno;
+}
+
 void SH_HandlerSwitchEnableFgOnlyMode(void)
 {
         struct sigaction sa;
@@ -52,6 +52,18 @@
 void SH_InstallerInstallChildProcessSignals(bool foreground)
 {
         sighandler_t sig_status;
+        sigset_t mask;
+        int status;
+
+        /* Shell blocks SIGCHLD while launching; don't pass that on to exec. */
+        errno = 0;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        status = sigprocmask(SIG_UNBLOCK, &mask, NULL);
+        if (status == -1) {
+                perror("sigprocmask");
+                _exit(1);
+        }
 
         /* Allow SIGINT to terminate this process. */
         errno = 0;
@@ -164,3 +176,28 @@ void SH_InstallerInstallSigtstpHandler(void)
 {
         SH_HandlerSwitchEnableFgOnlyMode();
 }
+
+void SH_InstallerInstallForwardSignals(void)
+{
+        static int const signals[] = { SIGTERM, SIGINT, SIGHUP };
+        struct sigaction sa;
+        int status;
+
+        /* Handle one forwarded signal at a time. */
+        memset(&sa, 0, sizeof(sa));
+        sigemptyset(&sa.sa_mask);
+        for (size_t i = 0; i < sizeof signals / sizeof signals[0]; i++) {
+                sigaddset(&sa.sa_mask, signals[i]);
+        }
+        sa.sa_flags = SA_RESTART;
+        sa.sa_handler = SH_HandlerForwardSignal;
+
+        for (size_t i = 0; i < sizeof signals / sizeof signals[0]; i++) {
+                errno = 0;
+                status = sigaction(signals[i], &sa, NULL);
+                if (status == -1) {
+                        perror("sigaction");
+                        _exit(1);
+                }
+        }
+}
@@ -9,10 +9,12 @@
  */
 #define _GNU_SOURCE
 #include <errno.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/prctl.h>
 #include <unistd.h>
 
 #include "builtins/builtins.h"
@@ -20,8 +22,17 @@
 #include "events/events.h"
 #include "globals.h"
 #include "job-control/job-control.h"
+#include "job-control/journal.h"
+#include "job-control/notice.h"
+#include "job-control/prepare.h"
+#include "job-control/redirect.h"
+#include "interpreter/bytecode.h"
 #include "interpreter/parser.h"
+#include "interpreter/script.h"
 #include "signals/installer.h"
+#include "trace/trace.h"
+#include "utils/alloc-stats.h"
+#include "utils/line-reader.h"
 
 /* *****************************************************************************
  * PRIVATE DEFINITIONS
@@ -54,56 +65,23 @@
  *
  ******************************************************************************/
 /**
- * @brief Evaluate a command entered by the user.
- * @param cmd command to evaluate
+ * @brief Execute a parsed statement.
+ * @param stmt @c Statement object to execute
+ * @param cmd command text the statement was parsed from
  * @return 0 or 1 on success, -1 on failure
  */
-static int smallsh_eval(char *cmd)
+static int smallsh_exec(SH_Statement *stmt, char *cmd)
 {
         int status_;
-        SH_Parser *parser;
-        ssize_t n_stmts;
-        SH_Statement *stmt;
         SH_Process *proc;
-        StmtStdin *st_in;
-        StmtStdout *st_out;
-        char *infile, *outfile, *cmd_name;
-        size_t n_in, n_out;
+        SH_Redirs redirs;
+        char const *path;
         bool foreground;
         SH_Job *job;
 
-        /* Parse command into statements for evaluation. */
-        parser = SH_CreateParser();
-
-        n_stmts = SH_ParserParse(parser, cmd);
-        if (n_stmts == -1) {
-                SH_DestroyParser(&parser);
-                return -1; /* error */
-        } else if (n_stmts == 0) {
-                SH_DestroyParser(&parser);
-                smallsh_line_buffer = true;
-                return 0; /* no statements parsed */
-        }
-
-        /* Can have multiple statements, but we only want first one. */
-        stmt = parser->stmts[0];
-
         /* Statement is not a builtin. */
         if ((stmt->flags & FLAGS_BUILTIN) == 0) {
-                /* Create process object. */
-                proc = SH_CreateProcess(stmt->cmd->count, stmt->cmd->args);
-
-                st_in = stmt->infile;
-                st_out = stmt->outfile;
-                n_in = st_in->n;
-                n_out = st_out->n;
-                if (n_in > 0) {
-                        infile = st_in->streams[n_in - 1];
-                } else {
-                        infile = NULL;
-                }
-                if (n_out > 0) {
-                        outfile = st_out->streams[n_out - 1];
+                if (stmt->outfile->n > 0) {
                         smallsh_line_buffer = true;
                 } else {
                         if (!smallsh_interactive_mode) {
@@ -114,7 +92,6 @@ static int smallsh_eval(char *cmd)
                                 }
 #endif
                         }
-                        outfile = NULL;
                 }
 
                 if ((stmt->flags & FLAGS_BGCTRL) == 0 || smallsh_fg_only_mode) {
@@ -128,15 +105,33 @@ static int smallsh_eval(char *cmd)
                         /* Some fun magic to make output pretty for test script. */
                         if (smallsh_fg_only_mode) {
                                 if ((stmt->flags & FLAGS_BGCTRL) != 0) {
-                                        if (outfile == NULL) {
+                                        if (stmt->outfile->n == 0) {
                                                 smallsh_line_buffer = true;
                                         }
                                 }
                         }
 #endif
                 }
+
+                /* Open redirections up front; a failure costs no fork. */
+                if (SH_RedirsOpen(&redirs, stmt->infile, stmt->outfile,
+                                  !foreground) == -1) {
+                        return 0;
+                }
+
+                /* Create process object. */
+                proc = SH_CreateProcess(stmt->cmd->count, stmt->cmd->args);
+
+                /* Use whatever was prepared while the last job ran. */
+                SH_PrepareRecord(stmt->cmd->args[0]);
+                path = SH_PrepareLookup(stmt->cmd->args[0]);
+                if (path != NULL) {
+                        proc->path = strdup(path);
+                }
+
                 /* Create job object. */
-                job = SH_CreateJob(cmd, proc, infile, outfile, !foreground);
+                job = SH_CreateJob(cmd, proc, !foreground);
+                job->redirs = redirs;
 
                 /* Add job to job table. */
                 SH_JobTableAddJob(job_table, job);
@@ -146,27 +141,57 @@ static int smallsh_eval(char *cmd)
         }
         /* Statement is a builtin. */
         else {
-                /* Determine builtin name and run it. */
-                cmd_name = stmt->cmd->args[0];
-                if (strcmp("exit", cmd_name) == 0) {
-                        status_ = 1;
-                        smallsh_line_buffer = true;
-                } else if (strcmp("cd", cmd_name) == 0) {
-                        char *dirname = stmt->cmd->args[1];
-                        SH_cd(dirname);
-                        status_ = 0;
-                        smallsh_line_buffer = true;
-                } else if (strcmp("status", cmd_name) == 0) {
-                        SH_status();
-                        status_ = 0;
-                } else {
-                        /* Error */
-                        status_ = -1;
+                status_ = SH_RunBuiltin(stmt, cmd, smallsh_exec);
+        }
+
+        return status_;
+}
+
+/**
+ * @brief Evaluate a command entered by the user.
+ * @param cmd command to evaluate
+ * @return 0 or 1 on success, -1 on failure
+ */
+static int smallsh_eval(char *cmd)
+{
+        int status_;
+        SH_Parser *parser;
+        ssize_t n_stmts;
+        uint64_t trace_start;
+
+        trace_start = SH_TRACE_BEGIN();
+        smallsh_stmt_begin = SH_TraceNow();
+
+        /* Parse command into statements for evaluation. */
+        parser = SH_CreateParser();
+
+        n_stmts = SH_ParserParse(parser, cmd);
+        if (n_stmts == -1) {
+                if (parser->error == NULL) {
+                        SH_DestroyParser(&parser);
+                        return -1; /* error */
                 }
+
+                /* Syntax errors are reported, but are not fatal. */
+                fprintf(stderr, "-smallsh: syntax error near unexpected "
+                                "token `%s'\n", parser->error);
+                fflush(stderr);
+                n_stmts = 0;
+        }
+        if (n_stmts == 0) {
+                SH_DestroyParser(&parser);
+                smallsh_line_buffer = true;
+                SH_TRACE_END(TRACE_EVAL, 0, trace_start);
+                return 0; /* no statements parsed */
         }
 
+        /* Can have multiple statements, but we only want first one. */
+        status_ = smallsh_exec(parser->stmts[0], cmd);
+
         SH_DestroyParser(&parser);
 
+        SH_TRACE_END(TRACE_EVAL, 0, trace_start);
+
         return status_;
 }
 
@@ -198,8 +223,9 @@ static void smallsh_inspect_fg_only_mode_flag(void)
  *
  * Do not proceed until this is the case (but make an exception for the
  * test script in this case).
+ * @param script_mode whether shell is running a script file
  */
-static void smallsh_init(void)
+static void smallsh_init(bool script_mode)
 {
         int status_;
 
@@ -207,10 +233,12 @@ static void smallsh_init(void)
          * See if we are running interactively.
          *
          * When running from a test script, STDIN will not be a tty, and thus
-         * we will not be in interactive mode.
+         * we will not be in interactive mode. Nor are we when running a
+         * script file, regardless of where STDIN points.
          */
         smallsh_shell_terminal = STDIN_FILENO;
-        smallsh_interactive_mode = isatty(smallsh_shell_terminal);
+        smallsh_interactive_mode = !script_mode
+                && isatty(smallsh_shell_terminal);
 
         if (smallsh_interactive_mode) {
                 smallsh_shell_pgid = getpgrp();
@@ -224,6 +252,16 @@ static void smallsh_init(void)
         /* Ignore interactive and job-control signals. */
         SH_InstallerInstallJobControlSignals();
 
+        /* As a container's init, adopt orphans and pass signals on to jobs. */
+        if (smallsh_init_mode) {
+                errno = 0;
+                status_ = prctl(PR_SET_CHILD_SUBREAPER, 1);
+                if (status_ == -1) {
+                        perror("prctl");
+                }
+                SH_InstallerInstallForwardSignals();
+        }
+
         /* Put ourselves in our own process group. */
         smallsh_shell_pgid = getpid();
 
@@ -250,26 +288,30 @@ static void smallsh_init(void)
 
 /**
  * @brief Prompt user for command and read input to @p cmd.
- * @param cmd command to store input in
- * @return number of characters read
+ *
+ * The prompt is only shown in interactive mode; batch input such as a heredoc
+ * is read without one.
+ * @param reader @c LineReader object to read input from
+ * @param cmd output param for command, valid until the next call
+ * @return number of characters read, 0 at end of input, or -1 on failure
  */
-static ssize_t smallsh_read_input(char **cmd)
+static ssize_t smallsh_read_input(SH_LineReader *reader, char **cmd)
 {
         ssize_t n_read;
-        size_t len;
+        uint64_t trace_start;
 
-        /* Prompt user for command. */
-        if (write(STDOUT_FILENO, ": ", 2) == -1) {
+        /* Prompt user for command, after any pending job notices. */
+        if (SH_NoticeFlush(smallsh_interactive_mode ? ": " : NULL, 2) == -1) {
                 print_error_msg("write");
                 _exit(1);
         }
 
         /* Read input command from user. */
-        len = 0;
-        errno = 0;
-        n_read = getline(cmd, &len, stdin);
-        if (n_read == -1 && errno != 0) {
-                print_error_msg("getline()");
+        trace_start = SH_TRACE_BEGIN();
+        n_read = SH_LineReaderNext(reader, cmd);
+        SH_TRACE_END(TRACE_READ, 0, trace_start);
+        if (n_read == -1) {
+                print_error_msg("SH_LineReaderNext()");
                 return -1;
         }
 #ifdef TEST_SCRIPT_ECHO_COMMANDS
@@ -280,6 +322,254 @@ static ssize_t smallsh_read_input(char **cmd)
         return n_read;
 }
 
+/**
+ * @brief Performs bookkeeping after a command has been evaluated.
+ * @param status_ status returned by evaluation
+ * @param exit_status output param for shell's exit status
+ * @return 0 to keep running, otherwise 1 and @p exit_status is set
+ */
+static int smallsh_finish_command(int status_, int *exit_status)
+{
+        if (status_ == -1) {
+                *exit_status = EXIT_FAILURE;
+                return 1;
+        } else if (status_ == 1) {
+                *exit_status = EXIT_SUCCESS;
+                return 1;
+        }
+
+        if (!smallsh_interactive_mode) {
+#ifdef TEST_SCRIPT
+                /* Add an extra newline to make output pretty. */
+                if (smallsh_line_buffer) {
+                        write(STDOUT_FILENO, "\n", 1);
+                }
+                smallsh_line_buffer = false;
+#endif
+        }
+
+        /* In init mode, a forwarded signal ends the shell along with its job. */
+        if (smallsh_init_signal != 0) {
+                *exit_status = EXIT_SUCCESS;
+                return 1;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Prepares likely next commands while a foreground job runs.
+ * @param ctx unused
+ */
+static void smallsh_prepare_likely(void *ctx)
+{
+        (void) ctx;
+        SH_PrepareLikely();
+}
+
+/**
+ * @brief Read commands from STDIN and evaluate them until end of input or
+ * exit.
+ * @return shell's exit status
+ */
+static int smallsh_run_stdin(void)
+{
+        ssize_t n_read;
+        char *cmd;
+        int status_, exit_status;
+        SH_LineReader *reader;
+
+        /* Commands are read in chunks into a single reusable buffer. */
+        reader = SH_CreateLineReader(STDIN_FILENO, 0);
+        if (reader == NULL) {
+                print_error_msg("SH_CreateLineReader()");
+                _exit(1);
+        }
+
+        /* Keep reaping, and starting pending jobs, while awaiting input. */
+        SH_LineReaderSetRead(reader, SH_ReadEvents);
+
+        /* Next command is unknown, so guess from the most frequent ones. */
+        SH_JobControlSetWaitHook(smallsh_prepare_likely, NULL);
+
+        /* Run event loop forever until shell termination. */
+        do {
+                /* Notify user about new job-control events. */
+                status_ = SH_NotifyEvents();
+                if (status_ == -1) {
+                        print_error_msg("SH_NotifyEvents()");
+                        exit_status = EXIT_FAILURE;
+                        break;
+                }
+
+                /* Read command from user. */
+                n_read = smallsh_read_input(reader, &cmd);
+                if (n_read == -1) {
+                        print_error_msg("smallsh_read_input()");
+                        exit_status = EXIT_FAILURE;
+                        break;
+                } else if (n_read == 0) {
+                        /* End of input acts as exit. */
+                        exit_status = EXIT_SUCCESS;
+                        break;
+                }
+
+                /*
+                 * Check if SIGTSTP triggered fg-only mode on/off and update
+                 * shell's state accordingly.
+                 */
+                smallsh_inspect_fg_only_mode_flag();
+
+                /* Evaluate command. */
+                if (smallsh_alloc_stats_enabled) {
+                        SH_AllocStatsReset();
+                }
+                status_ = smallsh_eval(cmd);
+                if (smallsh_alloc_stats_enabled) {
+                        SH_AllocStatsReport(stderr, cmd);
+                }
+        } while (smallsh_finish_command(status_, &exit_status) == 0);
+
+        SH_JobControlSetWaitHook(NULL, NULL);
+        SH_DestroyLineReader(&reader);
+
+        return exit_status;
+}
+
+/**
+ * @brief Executes a statement of a compiled script.
+ * @param stmt @c Statement object to execute
+ * @param cmd source line the statement was compiled from
+ * @param ctx output param for shell's exit status
+ * @return 0 to keep running, 1 to stop
+ */
+static int smallsh_exec_script_stmt(SH_Statement *stmt, char *cmd, void *ctx)
+{
+        int status_;
+
+        /* Notify user about new job-control events. */
+        status_ = SH_NotifyEvents();
+        if (status_ == -1) {
+                print_error_msg("SH_NotifyEvents()");
+                *(int *) ctx = EXIT_FAILURE;
+                return 1;
+        }
+
+        if (SH_NoticeFlush(NULL, 0) == -1) {
+                print_error_msg("write");
+                *(int *) ctx = EXIT_FAILURE;
+                return 1;
+        }
+
+        smallsh_inspect_fg_only_mode_flag();
+
+        /* Script statements were parsed up front. */
+        smallsh_stmt_begin = SH_TraceNow();
+        status_ = smallsh_exec(stmt, cmd);
+
+        /* Counts cover expansion of this statement through to its execution. */
+        if (smallsh_alloc_stats_enabled) {
+                SH_AllocStatsReport(stderr, cmd);
+                SH_AllocStatsReset();
+        }
+
+        return smallsh_finish_command(status_, (int *) ctx);
+}
+
+/**
+ * @brief Compiles the script @p script, caching the result in @p cache_path.
+ * @param script @c Script object to compile
+ * @param hash hash of script contents
+ * @param cache_path file to cache compiled script in, or @c NULL
+ * @param bc output param for compiled script
+ * @return 0 on success, 2 on syntax errors, -1 on failure
+ */
+static int smallsh_compile_script(SH_Script *script, uint64_t hash,
+                                  char const *cache_path, SH_Bytecode **bc)
+{
+        ssize_t n_errors;
+
+        n_errors = SH_ScriptParse(script);
+        if (n_errors == -1) {
+                print_error_msg("SH_ScriptParse()");
+                return -1;
+        } else if (n_errors > 0) {
+                return 2;
+        }
+
+        *bc = SH_CreateBytecode(script, hash);
+        if (*bc == NULL) {
+                print_error_msg("SH_CreateBytecode()");
+                return -1;
+        }
+
+        /* Caching is best-effort; the script runs either way. */
+        if (cache_path != NULL) {
+                SH_BytecodeSave(*bc, cache_path);
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Run the script file at @p path until its end or exit.
+ *
+ * The whole script is parsed and compiled before any of it runs, so a script
+ * containing a syntax error anywhere does nothing but report it. Compiled
+ * scripts are cached by content, so running an unchanged script again skips
+ * lexing and parsing entirely. Each statement is expanded just before it
+ * executes, so that substitutions observe the effects of the statements
+ * preceding them.
+ * @param path script file to run
+ * @return shell's exit status
+ */
+static int smallsh_run_script(char const *path)
+{
+        SH_Script *script;
+        SH_Bytecode *bc;
+        char cache_path[PATH_MAX];
+        bool cached;
+        uint64_t hash;
+        int status_, exit_status;
+
+        script = SH_CreateScript(path);
+        if (script == NULL) {
+                return 127;
+        }
+
+        hash = SH_BytecodeHash(script->data, script->size);
+        cached = SH_BytecodeCachePath(hash, cache_path,
+                                      sizeof cache_path) == 0;
+
+        bc = cached ? SH_LoadBytecode(cache_path, hash) : NULL;
+        if (bc == NULL) {
+                status_ = smallsh_compile_script(script, hash,
+                                                 cached ? cache_path : NULL,
+                                                 &bc);
+                if (status_ != 0) {
+                        SH_DestroyScript(&script);
+                        return status_ == 2 ? 2 : EXIT_FAILURE;
+                }
+        }
+
+        /* Compiled script is self-contained. */
+        SH_DestroyScript(&script);
+
+        exit_status = EXIT_SUCCESS;
+        if (smallsh_alloc_stats_enabled) {
+                SH_AllocStatsReset();
+        }
+        status_ = SH_BytecodeRun(bc, smallsh_exec_script_stmt, &exit_status);
+        if (status_ == -1) {
+                print_error_msg("SH_BytecodeRun()");
+                exit_status = EXIT_FAILURE;
+        }
+
+        SH_DestroyBytecode(&bc);
+
+        return exit_status;
+}
+
 /* *****************************************************************************
  * PUBLIC DEFINITIONS
  *
@@ -300,26 +590,6 @@ static ssize_t smallsh_read_input(char **cmd)
  *
  *
  ******************************************************************************/
-/* *****************************************************************************
- * OBJECTS
- *
- *
- *
- *
- *
- *
- *
- ******************************************************************************/
-volatile int smallsh_errno = 0;
-bool smallsh_line_buffer = false;
-int smallsh_interactive_mode = 0;
-int smallsh_fg_only_mode = 0;
-SH_JobTable *job_table = NULL;
-int smallsh_shell_terminal = 0;
-int smallsh_shell_pgid = 0;
-SH_Channel *sigchld_channel = NULL;
-SH_Receiver *receiver = NULL;
-SH_Sender *sender = NULL;
 /* *****************************************************************************
  * FUNCTIONS
  *
@@ -332,13 +602,24 @@ SH_Sender *sender = NULL;
  ******************************************************************************/
 /**
  * @brief Run shell's main event loop until terminated.
+ *
+ * Commands are read from STDIN, unless a script file is given as the first
+ * argument.
+ *
+ * With @c --init before it, the shell acts as a container's init process: it
+ * reaps orphaned processes, forwards SIGTERM, SIGINT and SIGHUP to its jobs,
+ * then exits, and exits with the status of the last foreground job.
  */
-int main(void)
+int main(int argc, char *argv[])
 {
-        ssize_t n_read;
-        char *cmd;
         int status_;
 
+        if (argc > 1 && strcmp(argv[1], "--init") == 0) {
+                smallsh_init_mode = true;
+                argc--;
+                argv++;
+        }
+
         /* Setup event listener to catch signal events and related data. */
         status_ = SH_InitEvents();
         if (status_ == -1) {
@@ -346,59 +627,29 @@ int main(void)
                 _exit(1);
         }
 
-        smallsh_init();
-
-        job_table = SH_CreateJobTable();
+        smallsh_init(argc > 1);
 
-        /* Run event loop forever until shell termination. */
-        do {
-                /* Notify user about new job-control events. */
-                status_ = SH_NotifyEvents();
-                if (status_ == -1) {
-                        print_error_msg("SH_NotifyEvents()");
-                        status_ = EXIT_FAILURE;
-                        break;
-                }
+        /* Enable command tracing if requested via the environment. */
+        SH_TraceInit();
 
-                /* Read command from user. */
-                cmd = NULL;
-                n_read = smallsh_read_input(&cmd);
-                if (n_read == -1) {
-                        print_error_msg("smallsh_read_input()");
-                        status_ = EXIT_FAILURE;
-                        break;
-                }
+        /* Enable per-command allocation counts if requested, likewise. */
+        SH_AllocStatsInit();
 
-                /*
-                 * Check if SIGTSTP triggered fg-only mode on/off and update
-                 * shell's state accordingly.
-                 */
-                smallsh_inspect_fg_only_mode_flag();
+        /* Log job lifecycle events if requested, likewise. */
+        SH_JournalInit();
 
-                /* Evaluate command. */
-                status_ = smallsh_eval(cmd);
-                if (status_ == -1) {
-                        free(cmd);
-                        status_ = EXIT_FAILURE;
-                        break;
-                } else if (status_ == 1) {
-                        free(cmd);
-                        status_ = EXIT_SUCCESS;
-                        break;
-                }
+        job_table = SH_CreateJobTable();
 
-                if (!smallsh_interactive_mode) {
-#ifdef TEST_SCRIPT
-                        /* Add an extra newline to make output pretty. */
-                        if (smallsh_line_buffer) {
-                                write(STDOUT_FILENO, "\n", 1);
-                        }
-                        smallsh_line_buffer = false;
-#endif
-                }
+        if (argc > 1) {
+                status_ = smallsh_run_script(argv[1]);
+        } else {
+                status_ = smallsh_run_stdin();
+        }
 
-                free(cmd);
-        } while (1);
+        /* Exit codes follow the main job, as an init process's should. */
+        if (smallsh_init_mode && status_ == EXIT_SUCCESS) {
+                status_ = SH_JobControlLastStatus();
+        }
 
         SH_exit(status_);
 }
@@ -0,0 +1,220 @@
+/**
+ * @file trace.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For recording per-phase command latencies.
+ *
+ * Timestamps are recorded into a fixed-size in-memory ring, which can later be
+ * exported in the Chrome trace-event format (viewable in chrome://tracing or
+ * Perfetto). When tracing is disabled, each trace point costs a single branch.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trace/trace.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Translates trace phases into their event names.
+ */
+static const char * const TRACE_PHASES[] = {
+        [TRACE_EVAL] = "eval",
+        [TRACE_READ] = "read",
+        [TRACE_LEX] = "lex",
+        [TRACE_PARSE] = "parse",
+        [TRACE_EXPAND] = "expand",
+        [TRACE_SPAWN] = "spawn",
+        [TRACE_EXEC] = "exec",
+        [TRACE_WAIT] = "wait",
+        [TRACE_REAP] = "reap",
+        [TRACE_NOTIFY] = "notify",
+};
+
+static SH_TraceEvent trace_ring[SH_TRACE_RING_SIZE]; /**< recorded events */
+static size_t trace_head = 0; /**< index of next event to overwrite */
+static size_t trace_count = 0; /**< number of events recorded */
+static char const *trace_path = NULL; /**< file to write trace to on exit */
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+bool smallsh_trace_enabled = false;
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_TraceClear(void)
+{
+        trace_head = 0;
+        trace_count = 0;
+}
+
+int SH_TraceDump(FILE * const stream)
+{
+        SH_TraceEvent const *ev;
+        size_t first;
+        pid_t pid, tid;
+
+        pid = getpid();
+
+        /* Oldest event sits at the head once the ring has wrapped. */
+        first = trace_count < SH_TRACE_RING_SIZE ? 0 : trace_head;
+
+        fprintf(stream, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        for (size_t i = 0; i < trace_count; i++) {
+                ev = &trace_ring[(first + i) % SH_TRACE_RING_SIZE];
+
+                /* Exec setup happens within the child, so give it its own row. */
+                tid = ev->phase == TRACE_EXEC ? ev->pid : pid;
+                fprintf(stream,
+                        "%s\n{\"name\":\"%s\",\"cat\":\"smallsh\",\"ph\":\"X\","
+                        "\"pid\":%d,\"tid\":%d,\"ts\":%llu.%03llu,"
+                        "\"dur\":%llu.%03llu,\"args\":{\"child\":%d}}",
+                        i == 0 ? "" : ",",
+                        TRACE_PHASES[ev->phase], pid, tid,
+                        (unsigned long long) (ev->start / 1000),
+                        (unsigned long long) (ev->start % 1000),
+                        (unsigned long long) ((ev->end - ev->start) / 1000),
+                        (unsigned long long) ((ev->end - ev->start) % 1000),
+                        ev->pid);
+        }
+        fprintf(stream, "\n]}\n");
+
+        if (fflush(stream) == EOF || ferror(stream)) {
+                return -1;
+        }
+
+        return 0;
+}
+
+int SH_TraceDumpFile(char const * const path)
+{
+        FILE *stream;
+        int status;
+
+        errno = 0;
+        stream = fopen(path, "w");
+        if (stream == NULL) {
+                fprintf(stderr, "-smallsh: trace: %s: %s\n", path,
+                        strerror(errno));
+                fflush(stderr);
+                return -1;
+        }
+
+        status = SH_TraceDump(stream);
+        if (fclose(stream) == EOF) {
+                status = -1;
+        }
+
+        return status;
+}
+
+void SH_TraceInit(void)
+{
+        char const *path;
+
+        path = getenv("SMALLSH_TRACE");
+        if (path == NULL || *path == '\0') {
+                return;
+        }
+
+        trace_path = path;
+        smallsh_trace_enabled = true;
+}
+
+uint64_t SH_TraceNow(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+void SH_TraceRecord(SH_TracePhase const phase, pid_t const pid,
+                    uint64_t const start, uint64_t const end)
+{
+        SH_TraceEvent *ev;
+
+        ev = &trace_ring[trace_head];
+        ev->phase = phase;
+        ev->pid = pid;
+        ev->start = start;
+        ev->end = end;
+
+        trace_head = (trace_head + 1) % SH_TRACE_RING_SIZE;
+        if (trace_count < SH_TRACE_RING_SIZE) {
+                trace_count++;
+        }
+}
+
+void SH_TraceShutdown(void)
+{
+        if (trace_path != NULL && trace_count > 0) {
+                SH_TraceDumpFile(trace_path);
+        }
+}
@@ -0,0 +1,201 @@
+/**
+ * @file alloc-stats.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief For counting heap allocations made while evaluating commands.
+ *
+ * When the shell is built with the @c SMALLSH_ALLOC_STATS CMake option, calls
+ * to malloc, calloc, realloc, strdup, strndup and free made by the shell's own
+ * code are interposed at link time (@c -Wl,--wrap) and counted. Allocations
+ * made internally by libc, such as by getline, are not counted.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/alloc-stats.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static SH_AllocStats alloc_stats = { 0, 0, 0 }; /**< counts since reset */
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+bool smallsh_alloc_stats_enabled = false;
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#ifdef SMALLSH_ALLOC_STATS
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(char const *str);
+char *__real_strndup(char const *str, size_t n);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t const size)
+{
+        alloc_stats.n_allocs++;
+        alloc_stats.n_bytes += size;
+
+        return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t const n, size_t const size)
+{
+        alloc_stats.n_allocs++;
+        alloc_stats.n_bytes += n * size;
+
+        return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void * const ptr, size_t const size)
+{
+        /* Resizing counts as both, so that allocs minus frees stays live. */
+        alloc_stats.n_allocs++;
+        alloc_stats.n_bytes += size;
+        if (ptr != NULL) {
+                alloc_stats.n_frees++;
+        }
+
+        return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(char const * const str)
+{
+        alloc_stats.n_allocs++;
+        alloc_stats.n_bytes += strlen(str) + 1;
+
+        return __real_strdup(str);
+}
+
+char *__wrap_strndup(char const * const str, size_t const n)
+{
+        alloc_stats.n_allocs++;
+        alloc_stats.n_bytes += strnlen(str, n) + 1;
+
+        return __real_strndup(str, n);
+}
+
+void __wrap_free(void * const ptr)
+{
+        if (ptr != NULL) {
+                alloc_stats.n_frees++;
+        }
+
+        __real_free(ptr);
+}
+#endif
+
+bool SH_AllocStatsAvailable(void)
+{
+#ifdef SMALLSH_ALLOC_STATS
+        return true;
+#else
+        return false;
+#endif
+}
+
+void SH_AllocStatsGet(SH_AllocStats * const stats)
+{
+        *stats = alloc_stats;
+}
+
+void SH_AllocStatsInit(void)
+{
+        char const *value;
+
+        value = getenv("SMALLSH_ALLOC_STATS");
+        if (value == NULL || *value == '\0' || strcmp(value, "0") == 0) {
+                return;
+        }
+
+        if (!SH_AllocStatsAvailable()) {
+                fprintf(stderr, "-smallsh: SMALLSH_ALLOC_STATS: shell was "
+                                "built without allocation accounting\n");
+                fflush(stderr);
+                return;
+        }
+
+        smallsh_alloc_stats_enabled = true;
+}
+
+void SH_AllocStatsReport(FILE * const stream, char const * const cmd)
+{
+        int len;
+
+        /* Drop command's trailing newline. */
+        len = (int) strcspn(cmd, "\n");
+        fprintf(stream, "alloc: allocs=%zu frees=%zu bytes=%zu cmd=%.*s\n",
+                alloc_stats.n_allocs, alloc_stats.n_frees,
+                alloc_stats.n_bytes, len, cmd);
+        fflush(stream);
+}
+
+void SH_AllocStatsReset(void)
+{
+        alloc_stats.n_allocs = 0;
+        alloc_stats.n_frees = 0;
+        alloc_stats.n_bytes = 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file buffer.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Growable byte buffer.
+ *
+ * This is a utility module for accumulating bytes of unknown length, such as
+ * the output of a child process. Data can be read from a file descriptor
+ * straight into the buffer's spare capacity, so that no intermediate copies
+ * are needed.
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils/buffer.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#define SH_BUFFER_MIN_CAP 64
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * CONSTRUCTORS + DESTRUCTORS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_Buffer *SH_CreateBuffer(size_t const cap)
+{
+        SH_Buffer *buf;
+
+        buf = malloc(sizeof *buf);
+        if (buf == NULL) {
+                return NULL;
+        }
+
+        buf->len = 0;
+        buf->cap = cap > 0 ? cap : SH_BUFFER_MIN_CAP;
+        buf->data = malloc(buf->cap);
+        if (buf->data == NULL) {
+                free(buf);
+                return NULL;
+        }
+
+        return buf;
+}
+
+void SH_DestroyBuffer(SH_Buffer **buf)
+{
+        if (*buf) {
+                free((*buf)->data);
+                (*buf)->data = NULL;
+                (*buf)->len = 0;
+                (*buf)->cap = 0;
+
+                free(*buf);
+                *buf = NULL;
+        }
+}
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+int SH_BufferAppend(SH_Buffer * const buf, char const *data, size_t const n)
+{
+        if (SH_BufferReserve(buf, n) == -1) {
+                return -1;
+        }
+
+        memcpy(buf->data + buf->len, data, n);
+        buf->len += n;
+
+        return 0;
+}
+
+ssize_t SH_BufferReadFd(SH_Buffer * const buf, int const fd)
+{
+        ssize_t n_read, total;
+
+        total = 0;
+        for (;;) {
+                /* Grow by doubling once the spare capacity is used up. */
+                if (buf->len == buf->cap) {
+                        if (SH_BufferReserve(buf, buf->cap) == -1) {
+                                return -1;
+                        }
+                }
+
+                errno = 0;
+                n_read = read(fd, buf->data + buf->len, buf->cap - buf->len);
+                if (n_read == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                } else if (n_read == 0) {
+                        break; /* EOF */
+                }
+
+                buf->len += n_read;
+                total += n_read;
+        }
+
+        return total;
+}
+
+int SH_BufferReserve(SH_Buffer * const buf, size_t const n)
+{
+        size_t cap;
+        char *tmp;
+
+        if (buf->cap - buf->len >= n) {
+                return 0;
+        }
+
+        cap = buf->cap > 0 ? buf->cap : SH_BUFFER_MIN_CAP;
+        while (cap - buf->len < n) {
+                cap *= 2;
+        }
+
+        tmp = realloc(buf->data, cap);
+        if (tmp == NULL) {
+                return -1;
+        }
+        buf->data = tmp;
+        buf->cap = cap;
+
+        return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file line-reader.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Buffered reader for newline-terminated input lines.
+ *
+ * This is a utility module for reading commands from a file descriptor. Input
+ * is read in large chunks into a single reusable buffer, and each line is
+ * handed out as a view into that buffer, so that reading a line costs no
+ * allocations and, for batch input, rarely a system call.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils/line-reader.h"
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Terminates the line ending just before @p end, returning its view.
+ *
+ * The byte at @p end belongs to the next line, so it is saved and restored on
+ * the following call.
+ */
+static ssize_t SH_LineReaderTake(SH_LineReader * const reader,
+                                 size_t const end, char ** const line)
+{
+        SH_Buffer *buf = reader->buf;
+        size_t len;
+
+        *line = &buf->data[reader->start];
+        len = end - reader->start;
+
+        reader->held_at = end;
+        reader->held = buf->data[end];
+        buf->data[end] = '\0';
+
+        reader->start = end;
+        reader->scan = end;
+
+        return (ssize_t) len;
+}
+
+/**
+ * @brief Makes room for more input, moving unconsumed bytes to the front of
+ * the buffer, or growing it if the current line fills it.
+ * @return 0 on success, -1 on failure
+ */
+static int SH_LineReaderCompact(SH_LineReader * const reader)
+{
+        SH_Buffer *buf = reader->buf;
+        size_t n;
+
+        if (reader->start > 0) {
+                n = buf->len - reader->start;
+                memmove(buf->data, &buf->data[reader->start], n);
+                buf->len = n;
+                reader->scan -= reader->start;
+                reader->start = 0;
+        }
+
+        /* Always leave room for a newline and NUL after the last line. */
+        if (buf->cap - buf->len < 2) {
+                return SH_BufferReserve(buf, buf->cap);
+        }
+
+        return 0;
+}
+/* *****************************************************************************
+ * PUBLIC DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * CONSTRUCTORS + DESTRUCTORS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+SH_LineReader *SH_CreateLineReader(int const fd, size_t const cap)
+{
+        SH_LineReader *reader;
+
+        reader = malloc(sizeof *reader);
+        if (reader == NULL) {
+                return NULL;
+        }
+
+        reader->buf = SH_CreateBuffer(cap > 0 ? cap : SH_LINE_READER_CHUNK);
+        if (reader->buf == NULL) {
+                free(reader);
+                return NULL;
+        }
+
+        reader->fd = fd;
+        reader->read_fn = read;
+        reader->start = 0;
+        reader->scan = 0;
+        reader->held_at = 0;
+        reader->held = reader->buf->data[0] = '\0';
+        reader->eof = false;
+
+        return reader;
+}
+
+void SH_DestroyLineReader(SH_LineReader **reader)
+{
+        if (*reader) {
+                SH_DestroyBuffer(&(*reader)->buf);
+
+                free(*reader);
+                *reader = NULL;
+        }
+}
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+void SH_LineReaderSetRead(SH_LineReader * const reader,
+                          SH_LineReaderReadFn const read_fn)
+{
+        reader->read_fn = read_fn;
+}
+
+ssize_t SH_LineReaderNext(SH_LineReader * const reader, char ** const line)
+{
+        SH_Buffer *buf = reader->buf;
+        char *nl;
+        ssize_t n_read;
+
+        /* Give back the byte borrowed to terminate the previous line. */
+        buf->data[reader->held_at] = reader->held;
+
+        for (;;) {
+                /* Hand out the next complete line, if one is buffered. */
+                nl = memchr(&buf->data[reader->scan], '\n',
+                            buf->len - reader->scan);
+                if (nl != NULL) {
+                        return SH_LineReaderTake(reader,
+                                                 nl - buf->data + 1, line);
+                }
+                reader->scan = buf->len;
+
+                if (SH_LineReaderCompact(reader) == -1) {
+                        return -1;
+                }
+
+                if (reader->eof) {
+                        if (reader->start == buf->len) {
+                                return 0;
+                        }
+
+                        /* Final line is missing its newline. */
+                        buf->data[buf->len++] = '\n';
+                        return SH_LineReaderTake(reader, buf->len, line);
+                }
+
+                /* Leave a byte spare for the final line's terminator. */
+                errno = 0;
+                n_read = reader->read_fn(reader->fd, &buf->data[buf->len],
+                                         buf->cap - buf->len - 1);
+                if (n_read == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                } else if (n_read == 0) {
+                        reader->eof = true;
+                }
+
+                buf->len += n_read > 0 ? n_read : 0;
+        }
+}
@@ -56,17 +56,34 @@ char *SH_StringIteratorConsumeChar(SH_StringIterator *const iter)
 char *SH_StringIteratorConsumeWord(SH_StringIterator *const iter)
 {
         // grab word
-        char *start = SH_StringIteratorNext(iter);
+        char *start = iter->cur;
         char *slice;
         char c;
+        unsigned depth = 0; // command substitution nesting level
         while (SH_StringIteratorHasNext(iter)) {
                 c = SH_StringIteratorPeek(iter, 0);
                 switch (c) {
                         // stop at terminal character
                         case ' ':
                         case '\t':
+                                if (depth > 0) {
+                                        break;
+                                }
+                                goto seek_fin;
                         case '\n':
                                 goto seek_fin;
+                        // keep "$(...)" together as part of the word
+                        case '$':
+                                if (SH_StringIteratorPeek(iter, 1) == '(') {
+                                        SH_StringIteratorNext(iter);
+                                        depth++;
+                                }
+                                break;
+                        case ')':
+                                if (depth > 0) {
+                                        depth--;
+                                }
+                                break;
                         default:
                                 break;
                 }
@@ -167,7 +184,8 @@ SH_StringIterator *SH_CreateStringIterator(char *str)
                 return NULL;
         }
 
-        iter->string = strdup(str);
+        /* Iterate over caller's string in place; slices are copied out. */
+        iter->string = str;
         iter->cur = &iter->string[0];
 
         return iter;
@@ -176,7 +194,6 @@ SH_StringIterator *SH_CreateStringIterator(char *str)
 void SH_DestroyStringIterator(SH_StringIterator **iter)
 {
         if (*iter) {
-                free((*iter)->string);
                 (*iter)->string = NULL;
                 (*iter)->cur = NULL;
 
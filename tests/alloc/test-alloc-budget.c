@@ -0,0 +1,138 @@
+/**
+ * @file test-alloc-budget.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Heap allocation budgets for evaluating representative commands.
+ *
+ * Each test runs a command line through the same allocation path as
+ * @c smallsh_eval, short of forking: parsing and expansion, then process and
+ * job creation for non-builtins. The number of allocations must not exceed the
+ * command's budget, and every allocation must be freed afterwards.
+ *
+ * Budgets should only ever be lowered. Requires a build with the
+ * @c SMALLSH_ALLOC_STATS option.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include "interpreter/parser.h"
+#include "job-control/job.h"
+#include "job-control/process.h"
+#include "utils/alloc-stats.h"
+
+/**
+ * @brief Evaluates @p line as far as the shell does before forking, returning
+ * the heap operation counts it incurred.
+ */
+static SH_AllocStats alloc_budget_eval(char const *line)
+{
+        SH_AllocStats stats;
+        SH_Parser *parser;
+        SH_Statement *stmt;
+        SH_Process *proc;
+        SH_Job *job;
+        char *cmd;
+        ssize_t n_stmts;
+
+        // command is read into the line reader's buffer, outside the budget
+        cmd = strdup(line);
+
+        SH_AllocStatsReset();
+
+        parser = SH_CreateParser();
+        n_stmts = SH_ParserParse(parser, cmd);
+        if (n_stmts > 0 && (parser->stmts[0]->flags & FLAGS_BUILTIN) == 0) {
+                stmt = parser->stmts[0];
+
+                proc = SH_CreateProcess(stmt->cmd->count, stmt->cmd->args);
+                job = SH_CreateJob(cmd, proc,
+                                   (stmt->flags & FLAGS_BGCTRL) != 0);
+                SH_DestroyJob(job);
+        }
+        SH_DestroyParser(&parser);
+
+        SH_AllocStatsGet(&stats);
+
+        free(cmd);
+
+        return stats;
+}
+
+static void alloc_budget_check(char const *line, size_t budget)
+{
+        SH_AllocStats stats;
+
+        stats = alloc_budget_eval(line);
+
+        assert_in_range(stats.n_allocs, 1, budget);
+        assert_int_equal(stats.n_allocs, stats.n_frees);
+}
+
+static void alloc_budget_test_emptyLine(void **state)
+{
+        (void) state;
+        alloc_budget_check("\n", 7);
+}
+
+static void alloc_budget_test_comment(void **state)
+{
+        (void) state;
+        alloc_budget_check("# this is a comment\n", 7);
+}
+
+static void alloc_budget_test_builtin(void **state)
+{
+        (void) state;
+        alloc_budget_check("status\n", 15);
+}
+
+static void alloc_budget_test_builtinWithArg(void **state)
+{
+        (void) state;
+        alloc_budget_check("cd /tmp\n", 19);
+}
+
+static void alloc_budget_test_commandWithRedirection(void **state)
+{
+        (void) state;
+        alloc_budget_check("ls -l > out\n", 33);
+}
+
+static void alloc_budget_test_backgroundWithRedirections(void **state)
+{
+        (void) state;
+        alloc_budget_check("cat < in > out &\n", 37);
+}
+
+static void alloc_budget_test_pidExpansion(void **state)
+{
+        (void) state;
+        alloc_budget_check("echo $$ pid-$$.txt\n", 32);
+}
+
+int main(void)
+{
+        const struct CMUnitTest tests[] = {
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_emptyLine, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_comment, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_builtin, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_builtinWithArg, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_commandWithRedirection, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_backgroundWithRedirections, NULL, NULL),
+                cmocka_unit_test_setup_teardown(
+                        alloc_budget_test_pidExpansion, NULL, NULL),
+        };
+
+        return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,621 @@
+/**
+ * @file smallsh-bench.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief End-to-end benchmark suite for the shell.
+ *
+ * Drives a smallsh process through pipes and measures how long each workload
+ * takes to complete. Per-command latency is measured from writing a command
+ * to the shell until the output of a trailing @c status builtin is observed,
+ * so each sample includes the (in-process) cost of one @c status command.
+ *
+ * Results are printed as one JSON object per workload (JSON lines), with keys
+ * in a fixed order, so that runs from different commits can be diffed.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#ifndef SMALLSH_BENCH_SHELL
+#define SMALLSH_BENCH_SHELL "./smallsh"
+#endif
+
+#ifndef SMALLSH_BENCH_SCRIPT
+#define SMALLSH_BENCH_SCRIPT "p3testscript.sh"
+#endif
+
+#define BENCH_MARKER "exit value " /**< output of the status builtin */
+#define BENCH_TIMEOUT_MS 30000 /**< maximum time to wait on the shell */
+#define BENCH_BUF_SIZE 65536
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A running shell under benchmark.
+ */
+typedef struct {
+        pid_t pid; /**< shell PID */
+        int in_fd; /**< write end of shell's stdin */
+        int out_fd; /**< read end of shell's stdout */
+        size_t len; /**< bytes of unscanned output in buf */
+        char buf[BENCH_BUF_SIZE]; /**< shell output not yet scanned */
+} BenchShell;
+
+/**
+ * @brief Benchmark configuration.
+ */
+typedef struct {
+        char const *shell; /**< path to smallsh binary */
+        char const *script; /**< path to p3testscript.sh */
+        char const *only; /**< run only this workload, if set */
+        size_t iterations; /**< samples per workload */
+        size_t fanout; /**< background jobs per fan-out sample */
+        size_t replays; /**< samples for script replay */
+        bool text; /**< print human-readable table instead of JSON */
+} BenchConfig;
+
+/**
+ * @brief Collected samples for one workload.
+ */
+typedef struct {
+        char const *name; /**< workload name */
+        size_t ops_per_sample; /**< commands executed per sample */
+        size_t n; /**< number of samples */
+        uint64_t *ns; /**< sample latencies in nanoseconds */
+} BenchResult;
+
+static char bench_tmpdir[] = "/tmp/smallsh-bench-XXXXXX";
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Returns the current monotonic time in nanoseconds.
+ */
+static uint64_t bench_now(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief Writes all of @p n bytes of @p data to @p fd.
+ * @return 0 on success, -1 on failure
+ */
+static int bench_write_all(int fd, char const *data, size_t n)
+{
+        ssize_t n_written;
+
+        while (n > 0) {
+                errno = 0;
+                n_written = write(fd, data, n);
+                if (n_written == -1) {
+                        if (errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                }
+                data += n_written;
+                n -= n_written;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Starts a shell whose stdin and stdout are connected to pipes.
+ * @return 0 on success, -1 on failure
+ */
+static int bench_start_shell(BenchShell *sh, char const *path)
+{
+        int in[2], out[2], null_fd;
+
+        if (pipe2(in, O_CLOEXEC) == -1 || pipe2(out, O_CLOEXEC) == -1) {
+                perror("pipe2");
+                return -1;
+        }
+
+        sh->pid = fork();
+        if (sh->pid == 0) {
+                dup2(in[0], STDIN_FILENO);
+                dup2(out[1], STDOUT_FILENO);
+                null_fd = open("/dev/null", O_WRONLY);
+                if (null_fd != -1) {
+                        dup2(null_fd, STDERR_FILENO);
+                }
+                if (chdir(bench_tmpdir) == -1) {
+                        _exit(127);
+                }
+                execl(path, path, (char *) NULL);
+                _exit(127);
+        } else if (sh->pid == -1) {
+                perror("fork");
+                return -1;
+        }
+
+        close(in[0]);
+        close(out[1]);
+        sh->in_fd = in[1];
+        sh->out_fd = out[0];
+        sh->len = 0;
+
+        return 0;
+}
+
+/**
+ * @brief Reads shell output until @p count markers have been observed.
+ * @return 0 on success, -1 on failure or timeout
+ */
+static int bench_await_markers(BenchShell *sh, size_t count)
+{
+        struct pollfd pfd;
+        ssize_t n_read;
+        size_t marker_len, scanned;
+        char *hit;
+
+        marker_len = strlen(BENCH_MARKER);
+        pfd.fd = sh->out_fd;
+        pfd.events = POLLIN;
+
+        while (count > 0) {
+                /* Consume any markers already buffered. */
+                sh->buf[sh->len] = '\0';
+                hit = strstr(sh->buf, BENCH_MARKER);
+                if (hit != NULL) {
+                        /* Background job notices end in a tab-led status. */
+                        if (hit == sh->buf || hit[-1] != '\t') {
+                                count--;
+                        }
+                        scanned = (hit - sh->buf) + marker_len;
+                        memmove(sh->buf, sh->buf + scanned, sh->len - scanned);
+                        sh->len -= scanned;
+                        continue;
+                }
+
+                /* Keep a marker-sized tail in case a marker straddles reads. */
+                if (sh->len > marker_len) {
+                        memmove(sh->buf, sh->buf + sh->len - marker_len - 1,
+                                marker_len + 1);
+                        sh->len = marker_len + 1;
+                }
+
+                if (poll(&pfd, 1, BENCH_TIMEOUT_MS) <= 0) {
+                        fprintf(stderr, "smallsh-bench: timed out\n");
+                        return -1;
+                }
+
+                n_read = read(sh->out_fd, sh->buf + sh->len,
+                              sizeof(sh->buf) - sh->len - 1);
+                if (n_read <= 0) {
+                        if (n_read == -1 && errno == EINTR) {
+                                continue;
+                        }
+                        fprintf(stderr, "smallsh-bench: shell exited early\n");
+                        return -1;
+                }
+                sh->len += n_read;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Discards shell output until it closes stdout.
+ */
+static void bench_drain(BenchShell *sh)
+{
+        char buf[4096];
+
+        while (read(sh->out_fd, buf, sizeof(buf)) > 0)
+                ;
+}
+
+/**
+ * @brief Tells the shell to exit and collects it.
+ * @return shell exit status on success, -1 on failure
+ */
+static int bench_stop_shell(BenchShell *sh)
+{
+        int status;
+
+        bench_write_all(sh->in_fd, "exit\n", 5);
+        close(sh->in_fd);
+        bench_drain(sh);
+        close(sh->out_fd);
+
+        while (waitpid(sh->pid, &status, 0) == -1) {
+                if (errno != EINTR) {
+                        return -1;
+                }
+        }
+
+        return status;
+}
+
+/**
+ * @brief Runs @p lines followed by a status marker @p n times within a single
+ * shell, recording the latency of each round trip.
+ * @return 0 on success, -1 on failure
+ */
+static int bench_run_lines(BenchConfig const *cfg, BenchResult *res,
+                           char const *lines, size_t markers)
+{
+        BenchShell *sh;
+        uint64_t start;
+        size_t len;
+        int status;
+
+        sh = malloc(sizeof *sh);
+        if (sh == NULL || bench_start_shell(sh, cfg->shell) == -1) {
+                free(sh);
+                return -1;
+        }
+
+        len = strlen(lines);
+        status = 0;
+        for (size_t i = 0; i < res->n; i++) {
+                start = bench_now();
+                if (bench_write_all(sh->in_fd, lines, len) == -1
+                    || bench_await_markers(sh, markers) == -1) {
+                        status = -1;
+                        break;
+                }
+                res->ns[i] = bench_now() - start;
+        }
+
+        bench_stop_shell(sh);
+        free(sh);
+
+        return status;
+}
+
+/**
+ * @brief Extracts the commands fed to smallsh from the grading script's
+ * heredoc.
+ * @return heap-allocated command text on success, @c NULL on failure
+ */
+static char *bench_load_script(char const *path, size_t *n_lines)
+{
+        FILE *stream;
+        char *line, *text;
+        size_t cap, len, text_len;
+        bool in_heredoc;
+
+        stream = fopen(path, "r");
+        if (stream == NULL) {
+                fprintf(stderr, "smallsh-bench: %s: %s\n", path,
+                        strerror(errno));
+                return NULL;
+        }
+
+        line = NULL;
+        cap = 0;
+        text = NULL;
+        text_len = 0;
+        *n_lines = 0;
+        in_heredoc = false;
+        while (getline(&line, &cap, stream) != -1) {
+                if (!in_heredoc) {
+                        in_heredoc = strncmp(line, "./smallsh <<", 12) == 0;
+                        continue;
+                }
+                if (strncmp(line, "___EOF___", 9) == 0) {
+                        break;
+                }
+
+                len = strlen(line);
+                text = realloc(text, text_len + len + 1);
+                if (text == NULL) {
+                        break;
+                }
+                memcpy(text + text_len, line, len + 1);
+                text_len += len;
+                (*n_lines)++;
+        }
+
+        free(line);
+        fclose(stream);
+
+        return text;
+}
+
+/**
+ * @brief Replays the grading script through a fresh shell per sample, as fast
+ * as the shell will accept input.
+ * @return 0 on success, -1 on failure
+ */
+static int bench_run_script(BenchConfig const *cfg, BenchResult *res)
+{
+        BenchShell *sh;
+        char *text;
+        uint64_t start;
+        size_t n_lines;
+        int status;
+
+        text = bench_load_script(cfg->script, &n_lines);
+        if (text == NULL) {
+                return -1;
+        }
+        res->ops_per_sample = n_lines;
+
+        sh = malloc(sizeof *sh);
+        if (sh == NULL) {
+                free(text);
+                return -1;
+        }
+
+        status = 0;
+        for (size_t i = 0; i < res->n; i++) {
+                start = bench_now();
+                if (bench_start_shell(sh, cfg->shell) == -1) {
+                        status = -1;
+                        break;
+                }
+
+                /* Script ends with its own exit command. */
+                bench_write_all(sh->in_fd, text, strlen(text));
+                close(sh->in_fd);
+                bench_drain(sh);
+                close(sh->out_fd);
+                while (waitpid(sh->pid, NULL, 0) == -1 && errno == EINTR)
+                        ;
+                res->ns[i] = bench_now() - start;
+        }
+
+        free(sh);
+        free(text);
+
+        return status;
+}
+
+static int bench_cmp_u64(void const *a, void const *b)
+{
+        uint64_t x = *(uint64_t const *) a;
+        uint64_t y = *(uint64_t const *) b;
+
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the nearest-rank percentile @p p of sorted @p res samples,
+ * in microseconds.
+ */
+static double bench_percentile(BenchResult const *res, double p)
+{
+        size_t rank;
+
+        rank = (size_t) (p * res->n + 0.999999);
+        if (rank < 1) {
+                rank = 1;
+        } else if (rank > res->n) {
+                rank = res->n;
+        }
+
+        return res->ns[rank - 1] / 1000.0;
+}
+
+/**
+ * @brief Prints summary statistics for @p res.
+ */
+static void bench_report(BenchConfig const *cfg, BenchResult *res)
+{
+        uint64_t total;
+        double ops_per_sec;
+
+        total = 0;
+        for (size_t i = 0; i < res->n; i++) {
+                total += res->ns[i];
+        }
+        qsort(res->ns, res->n, sizeof(*res->ns), bench_cmp_u64);
+
+        ops_per_sec = total > 0
+                ? (double) res->n * res->ops_per_sample / (total / 1e9) : 0.0;
+
+        if (cfg->text) {
+                printf("%-14s %8zu %12.1f %12.1f %12.1f %12.1f\n",
+                       res->name, res->n, ops_per_sec,
+                       bench_percentile(res, 0.50),
+                       bench_percentile(res, 0.99),
+                       bench_percentile(res, 0.999));
+        } else {
+                printf("{\"workload\":\"%s\",\"samples\":%zu,"
+                       "\"ops_per_sample\":%zu,\"ops_per_sec\":%.1f,"
+                       "\"min_us\":%.1f,\"p50_us\":%.1f,\"p99_us\":%.1f,"
+                       "\"p999_us\":%.1f,\"max_us\":%.1f}\n",
+                       res->name, res->n, res->ops_per_sample, ops_per_sec,
+                       res->ns[0] / 1000.0,
+                       bench_percentile(res, 0.50),
+                       bench_percentile(res, 0.99),
+                       bench_percentile(res, 0.999),
+                       res->ns[res->n - 1] / 1000.0);
+        }
+        fflush(stdout);
+}
+
+static void bench_usage(char const *prog)
+{
+        fprintf(stderr,
+                "usage: %s [-s shell] [-p script] [-n iterations] "
+                "[-j fanout] [-r replays] [-w workload] [-t]\n"
+                "workloads: fg-trivial builtin bg-fanout redirection "
+                "script-replay\n", prog);
+}
+
+/**
+ * @brief Runs workload @p name if it is selected, reporting its results.
+ * @return 0 on success or if skipped, -1 on failure
+ */
+static int bench_workload(BenchConfig const *cfg, char const *name,
+                          size_t n, size_t ops, char const *lines,
+                          size_t markers)
+{
+        BenchResult res;
+        int status;
+
+        if (cfg->only != NULL && strcmp(cfg->only, name) != 0) {
+                return 0;
+        }
+
+        res.name = name;
+        res.n = n;
+        res.ops_per_sample = ops;
+        res.ns = calloc(n, sizeof(*res.ns));
+        if (res.ns == NULL) {
+                return -1;
+        }
+
+        if (lines != NULL) {
+                status = bench_run_lines(cfg, &res, lines, markers);
+        } else {
+                status = bench_run_script(cfg, &res);
+        }
+
+        if (status == 0) {
+                bench_report(cfg, &res);
+        } else {
+                fprintf(stderr, "smallsh-bench: %s failed\n", name);
+        }
+        free(res.ns);
+
+        return status;
+}
+
+int main(int argc, char *argv[])
+{
+        BenchConfig cfg;
+        char *fanout;
+        size_t len;
+        int opt, status;
+
+        cfg.shell = SMALLSH_BENCH_SHELL;
+        cfg.script = SMALLSH_BENCH_SCRIPT;
+        cfg.only = NULL;
+        cfg.iterations = 1000;
+        cfg.fanout = 32;
+        cfg.replays = 3;
+        cfg.text = false;
+
+        while ((opt = getopt(argc, argv, "s:p:n:j:r:w:th")) != -1) {
+                switch (opt) {
+                        case 's': cfg.shell = optarg; break;
+                        case 'p': cfg.script = optarg; break;
+                        case 'n': cfg.iterations = strtoul(optarg, NULL, 10); break;
+                        case 'j': cfg.fanout = strtoul(optarg, NULL, 10); break;
+                        case 'r': cfg.replays = strtoul(optarg, NULL, 10); break;
+                        case 'w': cfg.only = optarg; break;
+                        case 't': cfg.text = true; break;
+                        default:
+                                bench_usage(argv[0]);
+                                return EXIT_FAILURE;
+                }
+        }
+        if (cfg.iterations == 0 || cfg.fanout == 0 || cfg.replays == 0) {
+                bench_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        /* Shell's SIGPIPE should not take down the benchmark. */
+        signal(SIGPIPE, SIG_IGN);
+
+        if (mkdtemp(bench_tmpdir) == NULL) {
+                perror("mkdtemp");
+                return EXIT_FAILURE;
+        }
+        setenv("HOME", bench_tmpdir, 1);
+
+        /* Background fan-out: N jobs launched per sample. */
+        len = strlen("true &\n") * cfg.fanout + strlen("status\n") + 1;
+        fanout = malloc(len);
+        if (fanout == NULL) {
+                return EXIT_FAILURE;
+        }
+        fanout[0] = '\0';
+        for (size_t i = 0; i < cfg.fanout; i++) {
+                strcat(fanout, "true &\n");
+        }
+        strcat(fanout, "status\n");
+
+        if (cfg.text) {
+                printf("%-14s %8s %12s %12s %12s %12s\n", "workload",
+                       "samples", "ops/sec", "p50(us)", "p99(us)", "p999(us)");
+        }
+
+        status = 0;
+        status |= bench_workload(&cfg, "fg-trivial", cfg.iterations, 1,
+                                 "true\nstatus\n", 1);
+        status |= bench_workload(&cfg, "builtin", cfg.iterations, 2,
+                                 "cd .\nstatus\n", 1);
+        status |= bench_workload(&cfg, "bg-fanout", cfg.iterations / 10 + 1,
+                                 cfg.fanout, fanout, 1);
+        status |= bench_workload(&cfg, "redirection", cfg.iterations, 2,
+                                 "echo bench > in\ncat < in > out\nstatus\n", 1);
+        status |= bench_workload(&cfg, "script-replay", cfg.replays, 0, NULL, 0);
+
+        free(fanout);
+
+        /* Clean up files left behind by the workloads. */
+        if (fork() == 0) {
+                execlp("rm", "rm", "-rf", bench_tmpdir, (char *) NULL);
+                _exit(127);
+        }
+        wait(NULL);
+
+        return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___' &
+echo --------------------
+echo placement policy (should print: every option, with affinity compact)
+set -o affinity=compact
+set -o
+echo
+echo --------------------
+echo background jobs are pinned (should print: the job, pinned to CPU 0, twice)
+sleep 2 &
+pin %1
+pin 0 %1
+pin %1
+echo
+echo --------------------
+echo bad arguments are refused (should print: usage, two no such job, two invalid)
+pin
+pin %9
+pin 0 12345678
+pin 0-x %1
+pin 99999 %1
+set -o affinity=random
+echo
+sleep 2.5
+exit
+___EOF___
+shell=$!
+
+sleep 0.5
+sleeper=$(pgrep -f "^sleep 2$")
+echo
+echo --------------------
+echo "the kernel agrees (should print: 0)"
+taskset -cp $sleeper | sed 's/.*: //'
+
+wait $shell
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+printf "ulimit -n\n" > substitution-limit.sh
+printf 'printf %%s "$1" | wc -c\n' > substitution-count.sh
+
+./smallsh <<'___EOF___'
+echo
+echo --------------------
+echo command substitution (should print: hello world)
+echo $(echo hello world)
+echo
+echo --------------------
+echo nested substitution with pid (should print: pid followed by smallsh pid)
+echo $(echo pid $(echo $$))
+echo
+echo --------------------
+echo builtin substitution (should print: exit value 0)
+echo $(status)
+echo
+echo --------------------
+echo redirected substitution (should print: first line of junk)
+echo substituted > junk
+echo $(cat < junk)
+echo
+echo --------------------
+echo other builtins (should print: [64], then a and b on two lines)
+ulimit -n 64
+echo [$(ulimit -n)]
+echo $(parallel echo {} ::: a b)
+echo
+echo --------------------
+echo builtin output larger than a pipe (should print: 108893)
+bash substitution-count.sh $(parallel seq {} ::: 20000)
+echo
+echo --------------------
+echo commands run under the shell limits (should print: [64])
+echo [$(bash substitution-limit.sh)]
+echo
+echo --------------------
+echo builtins cannot change the shell (should print: /tmp, then every option, with max-jobs 0)
+cd /tmp
+echo $(cd /) $(exit)
+pwd
+echo $(set -o max-jobs=3)
+set -o
+echo
+exit
+___EOF___
+rm -f substitution-limit.sh substitution-count.sh
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# A job that ignores SIGTERM, and one whose own child outlives it. The
+# stubborn job marks when its trap is set, and exit-ready.sh waits for that.
+printf "trap '' TERM\ntouch exit-trapped\nsleep 30\n" > exit-stubborn.sh
+printf "sleep 31 &\nwait\n" > exit-parent.sh
+printf "for i in \$(seq 100); do [ -e exit-trapped ] && break; sleep 0.05; done\n" > exit-ready.sh
+rm -f exit-trapped
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo exit-timeout setting (should print: every option, with exit-timeout 0.5)
+set -o exit-timeout=0.5
+set -o
+echo
+echo --------------------
+echo exit stops every job (should print: three pids, two terminated by signal 15, one by signal 9)
+bash exit-stubborn.sh &
+bash exit-parent.sh &
+sleep 32 &
+bash exit-ready.sh
+exit
+___EOF___
+
+echo
+echo --------------------
+echo "no job processes outlive the shell (should print: none left)"
+if pgrep -f "^sleep 3[012]$" > /dev/null; then
+        echo "some left"
+else
+        echo "none left"
+fi
+rm -f exit-stubborn.sh exit-parent.sh exit-ready.sh exit-trapped
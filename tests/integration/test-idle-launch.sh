@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Input arrives late, so the shell sits waiting for it while jobs complete.
+for backend in uring select; do
+        rm -f idle-launch.marker
+        echo "--------------------"
+        echo "$backend: pending job starts while the shell awaits input (should print: started)"
+        {
+                echo "set -o max-jobs=1"
+                echo "sleep 0.3 &"
+                echo "touch idle-launch.marker &"
+                sleep 1
+                if [ -e idle-launch.marker ]; then
+                        echo "started" >&2
+                else
+                        echo "not started" >&2
+                fi
+                echo "exit"
+        } | if [ "$backend" = select ]; then
+                SMALLSH_EVENTS=select ./smallsh
+        else
+                ./smallsh
+        fi
+        echo
+done
+rm -f idle-launch.marker
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# A job that leaves an orphan behind, and a main job for signals to end.
+printf "sleep 0.2 &\nexit 0\n" > init-orphan.sh
+printf "sleep 30 &\nbash init-orphan.sh\nsleep 0.5\nsleep 30\necho not reached\n" > init-main.sh
+
+echo --------------------
+echo "orphans are reaped, and SIGTERM ends every job (should print: a pid, signal 15 twice, exit)"
+./smallsh --init init-main.sh &
+shell=$!
+sleep 1
+zombies=$(ps -o stat= --ppid $shell | grep -c Z)
+kill -TERM $shell
+wait $shell
+status=$?
+
+echo
+echo --------------------
+echo "no zombies were left (should print: 0 zombies)"
+echo "$zombies zombies"
+echo
+echo --------------------
+echo "exit code follows the main job (should print: exit value 143)"
+echo "exit value $status"
+echo
+echo --------------------
+echo "no job processes outlive the shell (should print: none left)"
+if pgrep -f "^sleep 30$" > /dev/null; then
+        echo "some left"
+else
+        echo "none left"
+fi
+rm -f init-orphan.sh init-main.sh
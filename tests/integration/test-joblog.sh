@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Output longer than the log, with no line ending.
+printf "head -c 3000 /dev/zero | tr '\\\\0' x\n" > joblog-long.sh
+printf 'printf %%s "$1" | wc -c\n' > joblog-count.sh
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo log size (should print: every option, with bg-log 4)
+set -o bg-log=4
+set -o
+echo
+echo --------------------
+echo output is kept (should print: seq and ls listed, then the last lines up to 100000, then the ls error)
+seq 1 100000 &
+ls /nonexistent-dir &
+sleep 1
+joblog
+joblog %1
+joblog %2
+echo
+echo --------------------
+echo redirected output is not kept (should print: no output kept)
+sleep 0.3 > /dev/null 2> /dev/null &
+joblog %1
+sleep 0.5
+echo
+echo --------------------
+echo a single line longer than the log is kept (should print: 1024)
+set -o bg-log=1
+bash joblog-long.sh &
+sleep 0.5
+bash joblog-count.sh $(joblog %1)
+echo
+echo --------------------
+echo bad arguments are refused (should print: no output kept, a usage line, and an error)
+joblog %9
+joblog %1 %2
+set -o bg-log=65537
+echo
+exit
+___EOF___
+rm -f joblog-long.sh joblog-count.sh
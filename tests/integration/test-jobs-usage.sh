@@ -0,0 +1,18 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo jobs -l shows usage so far (should print: a pid, then a running job with real, user, sys, maxrss and csw)
+sleep 1 &
+jobs -l
+echo
+echo --------------------
+echo completion notices show usage (should print: done, with real about 1s)
+sleep 1.2
+echo
+echo --------------------
+echo bad options are refused (should print: an error)
+jobs -x
+echo
+exit
+___EOF___
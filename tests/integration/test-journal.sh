@@ -0,0 +1,22 @@
+#!/bin/bash
+
+rm -f journal-test.bin
+
+echo --------------------
+echo 'journaled jobs (should print: a pid, then a done line)'
+SMALLSH_JOURNAL=journal-test.bin ./smallsh <<'___EOF___'
+sleep 0.1 &
+true
+sleep 0.3
+exit
+___EOF___
+
+echo --------------------
+echo 'journal contents (should print: created, spawned and reaped for each of the three jobs)'
+./smallsh-journal -t journal-test.bin
+echo
+echo --------------------
+echo 'journal filtered by event (should print: three reaped events as JSON lines)'
+./smallsh-journal -e reaped journal-test.bin
+
+rm -f journal-test.bin
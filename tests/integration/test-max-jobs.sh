@@ -0,0 +1,34 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo max-jobs setting (should print: every option, with max-jobs 2)
+set -o max-jobs=2
+set -o
+echo
+echo --------------------
+echo jobs over the limit are queued (should print: two pids, then two pending)
+sleep 1 &
+sleep 1 &
+sleep 1 &
+sleep 1 &
+echo
+echo --------------------
+echo jobs lists them (should print: two running, two pending)
+jobs
+echo
+echo --------------------
+echo status counts queued jobs (should print: exit value 0, 2 jobs pending)
+status
+echo
+echo --------------------
+echo queued jobs start as others complete, while a foreground job runs (should print: two pids, then two done after 1s)
+sleep 1.5
+echo
+echo --------------------
+echo bad values are refused (should print: an error, then every option, with max-jobs 2)
+set -o max-jobs=lots
+set -o
+echo
+exit
+___EOF___
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo json notices (should print: every option, with notify json)
+set -o notify=json
+set -o
+echo
+echo --------------------
+echo started and completed jobs (should print: a started event with job 1, then a done event with exit 2 and usage)
+ls badfile &
+sleep 0.5
+echo
+echo --------------------
+echo text notices (should print: every option, with notify text, then a pid and a done line)
+set -o notify=text
+set -o
+sleep 0.1 &
+sleep 0.5
+echo
+exit
+___EOF___
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+printf 'one\ntwo\n\nthree\n' > parallel-list
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo parallel with placeholder (should print: item-a.txt item-b.txt item-c.txt)
+parallel -j 1 echo item-{}.txt ::: a b c
+echo
+echo --------------------
+echo parallel from list file (should print: got one, got two, got three)
+parallel -j1 echo got < parallel-list
+echo
+echo --------------------
+echo parallel runs four sleeps at once (should take about one second)
+parallel -j 4 sleep ::: 1 1 1 1
+echo
+echo --------------------
+echo parallel exit value counts failures (should print: exit value 2)
+parallel -j 2 ls ::: badfile1 parallel-list badfile2 > junk 2> junk2
+status
+echo
+echo --------------------
+echo parallel command lines (should print: a line, then exit value 0)
+parallel ::: true date
+status
+echo
+exit
+___EOF___
+
+rm -f parallel-list
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+mkdir -p prepare-a prepare-b
+echo a > prepare-a/in
+echo b > prepare-b/in
+
+cat > prepare.sh <<'___EOF___'
+echo input prepared while sleeping (should print: a)
+cd prepare-a
+sleep 0.1
+cat < in
+echo input after cd (should print: b)
+sleep 0.1
+cd ../prepare-b
+cat < in
+echo input replaced while prepared (should print: replaced)
+echo replaced > new
+sleep 0.1
+mv new in
+cat < in
+echo input removed while prepared (should print an error)
+sleep 0.1
+rm in
+cat < in
+exit
+___EOF___
+
+SMALLSH_CACHE_DIR= ./smallsh prepare.sh
+
+rm -rf prepare.sh prepare-a prepare-b
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Starts are paced at one job per CPU per interval, so one more than that
+# has to wait, whatever the load.
+n_cpus=$(nproc)
+burst() {
+        for _ in $(seq "$n_cpus"); do
+                echo "sleep $1 &"
+        done
+}
+
+{
+cat <<'___EOF___'
+echo --------------------
+echo pressure thresholds (should print: every option, with bg-load 2, bg-psi-cpu 50, bg-psi-io 0.5, bg-psi-memory 10)
+set -o bg-load=2 bg-psi-cpu=50 bg-psi-io=0.5 bg-psi-memory=10
+set -o
+set -o bg-load=0 bg-psi-cpu=0 bg-psi-io=0 bg-psi-memory=0
+echo
+echo --------------------
+echo starts are paced (should print: one job per CPU running, then one pending, then all done)
+set -o bg-psi-cpu=100
+___EOF___
+burst 0.3
+cat <<'___EOF___'
+echo last &
+jobs
+sleep 1
+sleep 0.5
+set -o bg-psi-cpu=0
+echo
+echo --------------------
+echo bad values are refused (should print: three errors)
+set -o bg-psi-cpu=101
+set -o bg-psi-memory=-1
+set -o bg-load=high
+echo
+exit
+___EOF___
+} | ./smallsh
+
+# Input arrives late, so the shell sits waiting for it between checks.
+for backend in uring select; do
+        rm -f pressure.marker
+        echo "--------------------"
+        echo "$backend: pending jobs are looked at again while the shell awaits input (should print: started)"
+        {
+                echo "set -o bg-psi-cpu=100 bg-load=1000"
+                burst 2
+                echo "touch pressure.marker &"
+                sleep 1.2
+                if [ -e pressure.marker ]; then
+                        echo "started" >&2
+                else
+                        echo "not started" >&2
+                fi
+                echo "exit"
+        } | if [ "$backend" = select ]; then
+                SMALLSH_EVENTS=select ./smallsh
+        else
+                ./smallsh
+        fi
+        echo
+done
+rm -f pressure.marker
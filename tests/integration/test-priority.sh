@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# A background job that keeps a CPU busy.
+printf "while :; do :; done\n" > priority-spin.sh
+
+./smallsh <<'___EOF___' &
+echo --------------------
+echo background policy (should print: every option, with bg-io idle, bg-nice 5, bg-sched batch, bg-stop on)
+set -o bg-io=idle bg-nice=5 bg-sched=batch bg-stop=on
+set -o
+echo
+echo --------------------
+echo heavy jobs are stopped during foreground ones (should print: two pids)
+sleep 3 &
+bash priority-spin.sh &
+sleep 0.5
+sleep 1.5
+set -o bg-stop=off
+sleep 1
+echo
+echo --------------------
+echo bad values are refused (should print: three errors)
+set -o bg-nice=20
+set -o bg-io=realtime
+set -o bg-stop=maybe
+echo
+exit
+___EOF___
+shell=$!
+
+sleep 0.3
+sleeper=$(pgrep -f "^sleep 3$")
+echo
+echo --------------------
+echo "background jobs run at a lower priority (should print: 5, idle, SCHED_BATCH)"
+ps -o ni= -p $sleeper | tr -d ' '
+ionice -p $sleeper | cut -d: -f1
+chrt -p $sleeper | head -1 | sed 's/.*: //'
+
+sleep 1
+spinner=$(pgrep -f "^bash priority-spin.sh$")
+echo
+echo --------------------
+echo "the heavy job is stopped (should print: T)"
+ps -o stat= -p $spinner | cut -c1
+
+sleep 1.2
+echo
+echo --------------------
+echo "and continued after (should print: R)"
+ps -o stat= -p $spinner | cut -c1
+
+wait $shell
+rm -f priority-spin.sh
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo append: out junk, append junk; cat junk (two lines)
+echo first > junk
+echo second >> junk
+cat junk
+echo
+echo --------------------
+echo stderr: ls badfile err junk (no error shown)
+ls badfile 2> junk
+cat junk
+echo
+echo --------------------
+echo stderr to stdout after out: error lands in junk
+ls badfile > junk 2>&1
+cat junk
+echo
+echo --------------------
+echo stderr to stdout before out: error shown, junk empty
+ls badfile 2>&1 > junk
+cat junk
+echo
+echo --------------------
+echo both: ls badfile smallsh both junk (error and listing in junk)
+ls badfile smallsh &> junk
+cat junk
+echo
+echo --------------------
+echo wc in badfile out junk2 (error before fork, junk2 not created)
+wc < badfile > junk2
+status
+ls junk2
+echo
+exit
+___EOF___
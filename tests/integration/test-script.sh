@@ -0,0 +1,37 @@
+#!/bin/bash
+
+cat > script-ok.sh <<'___EOF___'
+echo script mode (should print: pid followed by smallsh pid)
+echo pid $$
+echo substitution in script (should print: hello script)
+echo $(echo hello script)
+echo substituted > script-junk
+echo substitution after a write (should print: substituted)
+echo $(cat script-junk)
+exit
+echo SHOULD NOT BE PRINTED
+___EOF___
+
+cat > script-bad.sh <<'___EOF___'
+echo SHOULD NOT BE PRINTED
+ls >
+echo SHOULD NOT BE PRINTED EITHER
+< junk
+___EOF___
+
+export SMALLSH_CACHE_DIR=script-cache
+
+echo --------------------
+echo valid script
+./smallsh script-ok.sh
+echo
+echo --------------------
+echo "valid script, run from compiled cache (should print the same as above)"
+./smallsh script-ok.sh
+echo
+echo --------------------
+echo "script with syntax errors (should report lines 2 and 4, exit status 2)"
+./smallsh script-bad.sh
+echo "exit status $?"
+
+rm -rf script-junk script-ok.sh script-bad.sh script-cache
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo time an external command (should print: real, user, sys, run, parse, spawn and reap, with run about 0.5s)
+time sleep 0.5
+echo
+echo --------------------
+echo time a builtin (should print: exit value 0, then times with no spawn or reap)
+time status
+echo
+echo --------------------
+echo time with redirections (should print: times, and nothing else)
+time echo hidden > junk
+echo
+exit
+___EOF___
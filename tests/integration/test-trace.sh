@@ -0,0 +1,31 @@
+#!/bin/bash
+
+./smallsh <<'___EOF___'
+echo
+echo --------------------
+echo trace on; sleep 1; trace dump (should print trace-event JSON with spawn, exec and wait events)
+trace on
+sleep 1
+trace dump
+trace off
+echo
+echo --------------------
+echo trace dump to file (should print trace-event JSON from junk)
+trace dump junk
+cat junk
+echo
+exit
+___EOF___
+
+# The dump must hold the child's phases, and nothing timed from before
+# tracing was turned on.
+for name in spawn exec wait; do
+        if ! grep -q "\"name\":\"$name\"" junk; then
+                echo "FAIL: no $name event in trace dump"
+                exit 1
+        fi
+done
+if grep -q '"ts":0\.000,' junk; then
+        echo "FAIL: event timed from before trace on"
+        exit 1
+fi
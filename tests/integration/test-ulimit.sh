@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Prints the limits it was run with.
+printf "echo \$(ulimit -n) \$(ulimit -Sv) \$(ulimit -Hv)\n" > ulimit-show.sh
+
+./smallsh <<'___EOF___'
+echo --------------------
+echo limits are shown (should print: every limit)
+ulimit -a
+echo
+echo --------------------
+echo limits apply to jobs (should print: 64 100000 200000, twice)
+ulimit -n 64
+ulimit -Sv 100000
+ulimit -Hv 200000
+ulimit -n -v
+bash ulimit-show.sh
+bash ulimit-show.sh > ulimit-bg.out &
+sleep 0.5
+cat ulimit-bg.out
+echo
+echo --------------------
+echo overrides apply to their command alone (should print: 32 50000 50000, then 64 100000 200000)
+ulimit -n 32 -v 50000 bash ulimit-show.sh
+bash ulimit-show.sh
+echo
+echo --------------------
+echo jobs over their limits fail (should print: terminated by signal 25)
+ulimit -f 1 dd if=/dev/zero of=ulimit-big.out bs=4096 count=4 status=none
+echo
+echo --------------------
+echo bad arguments are refused (should print: invalid option and usage, invalid number, two cannot modify, two usage)
+ulimit -x
+ulimit -v 12x
+ulimit -Sv 300000
+ulimit -Sn 100
+ulimit -n bash ulimit-show.sh
+ulimit -a bash ulimit-show.sh
+echo
+exit
+___EOF___
+
+rm -f ulimit-show.sh ulimit-bg.out ulimit-big.out
@@ -0,0 +1,511 @@
+/**
+ * @file microbench.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Microbenchmarks for the shell's inner loops.
+ *
+ * Covers the lexer, parser, word expansion and job table at sizes from 1 to
+ * 100k operations, without forking. Lines are drawn round-robin from a corpus
+ * of realistic command lines checked in alongside this file. The corpus
+ * contains no command substitutions, since those fork.
+ *
+ * Each benchmark is warmed up before being repeated, and only the measured
+ * section is timed; setup such as building a job table is excluded. Results
+ * are printed as one JSON object per benchmark and size (JSON lines), or as a
+ * table with @c -t.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "interpreter/lexer.h"
+#include "interpreter/parser.h"
+#include "interpreter/token.h"
+#include "job-control/job-table.h"
+#include "job-control/job.h"
+#include "job-control/process.h"
+
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * MACROS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+#ifndef SMALLSH_MICROBENCH_CORPUS
+#define SMALLSH_MICROBENCH_CORPUS "corpus.txt"
+#endif
+
+#define MB_MAX_SIZE 100000 /**< largest benchmark size */
+#define MB_MAX_LOOKUPS 1000 /**< lookups per rep for linear-time searches */
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief A single microbenchmark.
+ */
+typedef struct {
+        char const *name; /**< benchmark name */
+        void (*setup)(size_t n); /**< untimed preparation for size @c n */
+        size_t (*run)(size_t n); /**< timed section; returns ops performed */
+        void (*teardown)(void); /**< untimed cleanup */
+} MicroBench;
+
+static char **mb_lines = NULL; /**< corpus command lines */
+static size_t mb_n_lines = 0; /**< number of corpus lines */
+static char **mb_words = NULL; /**< words split from corpus lines */
+static size_t mb_n_words = 0; /**< number of corpus words */
+
+static SH_JobTable *mb_table = NULL; /**< job table under benchmark */
+static SH_Job **mb_jobs = NULL; /**< jobs not yet added to table */
+static size_t mb_n_jobs = 0; /**< number of jobs in mb_jobs */
+
+static SH_Token *mb_toks[MAX_TOKENS + 1]; /**< lexer output */
+static volatile size_t mb_sink; /**< defeats dead-code elimination */
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+static uint64_t mb_now_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the CPU timestamp counter, or 0 where unavailable.
+ */
+static uint64_t mb_now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+}
+
+/**
+ * @brief Returns a pseudo-random index in [0, @p n), deterministically.
+ */
+static size_t mb_rand(size_t n)
+{
+        static uint64_t state = 0x2545f4914f6cdd1dULL;
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        return (size_t) (state % n);
+}
+
+/**
+ * @brief Loads command lines from @p path, and splits them into words.
+ * @return 0 on success, -1 on failure
+ */
+static int mb_load_corpus(char const *path)
+{
+        FILE *stream;
+        char *line, *copy, *word, *save;
+        size_t cap;
+        ssize_t len;
+
+        errno = 0;
+        stream = fopen(path, "r");
+        if (stream == NULL) {
+                fprintf(stderr, "smallsh-microbench: %s: %s\n", path,
+                        strerror(errno));
+                return -1;
+        }
+
+        line = NULL;
+        cap = 0;
+        while ((len = getline(&line, &cap, stream)) != -1) {
+                if (len <= 1) {
+                        continue;
+                }
+
+                /* Parser expects newline-terminated input. */
+                if (line[len - 1] != '\n') {
+                        copy = malloc(len + 2);
+                        memcpy(copy, line, len);
+                        copy[len] = '\n';
+                        copy[len + 1] = '\0';
+                } else {
+                        copy = strdup(line);
+                }
+
+                mb_lines = realloc(mb_lines, (mb_n_lines + 1) * sizeof(char *));
+                mb_lines[mb_n_lines++] = copy;
+
+                for (word = strtok_r(line, " \t\n", &save); word != NULL;
+                     word = strtok_r(NULL, " \t\n", &save)) {
+                        mb_words = realloc(mb_words,
+                                           (mb_n_words + 1) * sizeof(char *));
+                        mb_words[mb_n_words++] = strdup(word);
+                }
+        }
+
+        free(line);
+        fclose(stream);
+
+        if (mb_n_lines == 0) {
+                fprintf(stderr, "smallsh-microbench: %s: empty corpus\n", path);
+                return -1;
+        }
+
+        return 0;
+}
+
+static void mb_free_corpus(void)
+{
+        for (size_t i = 0; i < mb_n_lines; i++) {
+                free(mb_lines[i]);
+        }
+        for (size_t i = 0; i < mb_n_words; i++) {
+                free(mb_words[i]);
+        }
+        free(mb_lines);
+        free(mb_words);
+}
+
+static void mb_setup_none(size_t n)
+{
+        (void) n;
+}
+
+static void mb_teardown_none(void)
+{
+}
+
+/**
+ * @brief Tokenizes @p n corpus lines, freeing tokens after each line.
+ */
+static size_t mb_run_lexer(size_t n)
+{
+        size_t n_toks;
+
+        for (size_t i = 0; i < n; i++) {
+                n_toks = SH_LexerGenerateTokens(mb_lines[i % mb_n_lines],
+                                                MAX_TOKENS, mb_toks);
+                mb_sink += n_toks;
+                for (size_t j = 0; j < n_toks; j++) {
+                        SH_DestroyToken(&mb_toks[j]);
+                }
+        }
+
+        return n;
+}
+
+/**
+ * @brief Parses @p n corpus lines into statements, including expansion.
+ */
+static size_t mb_run_parser(size_t n)
+{
+        SH_Parser *parser;
+
+        for (size_t i = 0; i < n; i++) {
+                parser = SH_CreateParser();
+                mb_sink += SH_ParserParse(parser, mb_lines[i % mb_n_lines]);
+                SH_DestroyParser(&parser);
+        }
+
+        return n;
+}
+
+/**
+ * @brief Expands @p n corpus words.
+ */
+static size_t mb_run_expand(size_t n)
+{
+        char *word;
+
+        for (size_t i = 0; i < n; i++) {
+                word = SH_ParserExpandWord(mb_words[i % mb_n_words]);
+                mb_sink += word[0];
+                free(word);
+        }
+
+        return n;
+}
+
+/**
+ * @brief Creates @p n completed foreground jobs with PIDs and PGIDs 1 to
+ * @p n, leaving them in @c mb_jobs.
+ */
+static void mb_create_jobs(size_t n)
+{
+        char *line;
+        char *args[] = { "sleep", "5", NULL };
+        SH_Process *proc;
+
+        mb_jobs = malloc(n * sizeof(SH_Job *));
+        for (size_t i = 0; i < n; i++) {
+                line = mb_lines[i % mb_n_lines];
+                proc = SH_CreateProcess(2, args);
+                proc->pid = (pid_t) (i + 1);
+                proc->has_completed = true;
+                mb_jobs[i] = SH_CreateJob(line, proc, false);
+                mb_jobs[i]->pgid = (pid_t) (i + 1);
+        }
+        mb_n_jobs = n;
+        mb_table = SH_CreateJobTable();
+}
+
+/**
+ * @brief Adds all jobs created during setup to the table.
+ */
+static void mb_fill_table(void)
+{
+        for (size_t i = 0; i < mb_n_jobs; i++) {
+                SH_JobTableAddJob(mb_table, mb_jobs[i]);
+        }
+        mb_n_jobs = 0;
+}
+
+static void mb_setup_table(size_t n)
+{
+        mb_create_jobs(n);
+        mb_fill_table();
+}
+
+static void mb_teardown_table(void)
+{
+        /* Jobs never added to the table are still owned by us. */
+        for (size_t i = 0; i < mb_n_jobs; i++) {
+                SH_DestroyJob(mb_jobs[i]);
+        }
+        free(mb_jobs);
+        mb_jobs = NULL;
+        mb_n_jobs = 0;
+
+        SH_DestroyJobTable(mb_table);
+        mb_table = NULL;
+}
+
+static size_t mb_run_table_add(size_t n)
+{
+        mb_fill_table();
+
+        return n;
+}
+
+/**
+ * @brief Looks up random PGIDs within a table of @p n jobs.
+ */
+static size_t mb_run_table_find(size_t n)
+{
+        size_t n_ops;
+
+        n_ops = n < MB_MAX_LOOKUPS ? n : MB_MAX_LOOKUPS;
+        for (size_t i = 0; i < n_ops; i++) {
+                mb_sink += SH_JobTableFindJob(mb_table,
+                                              (pid_t) (mb_rand(n) + 1)) != NULL;
+        }
+
+        return n_ops;
+}
+
+/**
+ * @brief Updates the status of random PIDs within a table of @p n jobs, as
+ * the SIGCHLD receiver does.
+ */
+static size_t mb_run_table_update(size_t n)
+{
+        size_t n_ops;
+
+        n_ops = n < MB_MAX_LOOKUPS ? n : MB_MAX_LOOKUPS;
+        for (size_t i = 0; i < n_ops; i++) {
+                mb_sink += SH_JobTableUpdateJob(mb_table,
+                                                (pid_t) (mb_rand(n) + 1), 0,
+                                                NULL, 0);
+        }
+
+        return n_ops;
+}
+
+/**
+ * @brief Cleans a table of @p n completed jobs.
+ */
+static size_t mb_run_table_clean(size_t n)
+{
+        SH_JobTableCleanJobs(mb_table);
+
+        return n;
+}
+
+static const MicroBench MICROBENCHES[] = {
+        { "lexer", mb_setup_none, mb_run_lexer, mb_teardown_none },
+        { "parser", mb_setup_none, mb_run_parser, mb_teardown_none },
+        { "expand", mb_setup_none, mb_run_expand, mb_teardown_none },
+        { "jobtable-add", mb_create_jobs, mb_run_table_add, mb_teardown_table },
+        { "jobtable-find", mb_setup_table, mb_run_table_find, mb_teardown_table },
+        { "jobtable-update", mb_setup_table, mb_run_table_update,
+          mb_teardown_table },
+        { "jobtable-clean", mb_setup_table, mb_run_table_clean,
+          mb_teardown_table },
+};
+
+static int mb_cmp_double(void const *a, void const *b)
+{
+        double x = *(double const *) a;
+        double y = *(double const *) b;
+
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs @p mb at size @p n, reporting median and best per-op costs.
+ */
+static void mb_measure(MicroBench const *mb, size_t n, size_t warmups,
+                       size_t reps, bool text)
+{
+        double ns[reps], cycles[reps];
+        uint64_t t0, t1, c0, c1;
+        size_t ops;
+
+        for (size_t i = 0; i < warmups + reps; i++) {
+                mb->setup(n);
+                c0 = mb_now_cycles();
+                t0 = mb_now_ns();
+                ops = mb->run(n);
+                t1 = mb_now_ns();
+                c1 = mb_now_cycles();
+                mb->teardown();
+
+                if (i >= warmups) {
+                        ns[i - warmups] = (double) (t1 - t0) / ops;
+                        cycles[i - warmups] = (double) (c1 - c0) / ops;
+                }
+        }
+
+        qsort(ns, reps, sizeof(*ns), mb_cmp_double);
+        qsort(cycles, reps, sizeof(*cycles), mb_cmp_double);
+
+        if (text) {
+                printf("%-16s %8zu %12.1f %12.1f %12.1f\n", mb->name, n,
+                       ns[reps / 2], ns[0], cycles[reps / 2]);
+        } else {
+                printf("{\"bench\":\"%s\",\"n\":%zu,\"reps\":%zu,"
+                       "\"ns_per_op\":%.1f,\"min_ns_per_op\":%.1f,"
+                       "\"cycles_per_op\":%.1f}\n",
+                       mb->name, n, reps, ns[reps / 2], ns[0],
+                       cycles[reps / 2]);
+        }
+        fflush(stdout);
+}
+
+static void mb_usage(char const *prog)
+{
+        fprintf(stderr,
+                "usage: %s [-c corpus] [-b bench] [-N max-size] [-r reps] "
+                "[-w warmups] [-t]\n"
+                "benches:", prog);
+        for (size_t i = 0; i < sizeof(MICROBENCHES) / sizeof(*MICROBENCHES); i++) {
+                fprintf(stderr, " %s", MICROBENCHES[i].name);
+        }
+        fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+        char const *corpus, *only;
+        size_t max_size, reps, warmups;
+        bool text;
+        int opt;
+
+        corpus = SMALLSH_MICROBENCH_CORPUS;
+        only = NULL;
+        max_size = MB_MAX_SIZE;
+        reps = 5;
+        warmups = 1;
+        text = false;
+
+        while ((opt = getopt(argc, argv, "c:b:N:r:w:th")) != -1) {
+                switch (opt) {
+                        case 'c': corpus = optarg; break;
+                        case 'b': only = optarg; break;
+                        case 'N': max_size = strtoul(optarg, NULL, 10); break;
+                        case 'r': reps = strtoul(optarg, NULL, 10); break;
+                        case 'w': warmups = strtoul(optarg, NULL, 10); break;
+                        case 't': text = true; break;
+                        default:
+                                mb_usage(argv[0]);
+                                return EXIT_FAILURE;
+                }
+        }
+        if (reps == 0 || max_size == 0) {
+                mb_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        if (mb_load_corpus(corpus) == -1) {
+                return EXIT_FAILURE;
+        }
+
+        if (text) {
+                printf("%-16s %8s %12s %12s %12s\n", "bench", "n",
+                       "ns/op", "min ns/op", "cycles/op");
+        }
+
+        for (size_t i = 0; i < sizeof(MICROBENCHES) / sizeof(*MICROBENCHES); i++) {
+                if (only != NULL && strcmp(only, MICROBENCHES[i].name) != 0) {
+                        continue;
+                }
+                for (size_t n = 1; n <= max_size; n *= 10) {
+                        mb_measure(&MICROBENCHES[i], n, warmups, reps, text);
+                }
+        }
+
+        mb_free_corpus();
+
+        return EXIT_SUCCESS;
+}
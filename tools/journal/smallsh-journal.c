@@ -0,0 +1,288 @@
+/**
+ * @file smallsh-journal.c
+ * @author Mohamed Al-Hussein
+ * @date 18 Oct 2026
+ * @brief Dumps the job lifecycle journal written by the shell.
+ *
+ * Records are printed oldest first, as one JSON object per line (JSON lines)
+ * by default, or as a table with @c -t. They can be filtered by event, job
+ * PID, and shell session.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "job-control/journal.h"
+
+/* *****************************************************************************
+ * PRIVATE DEFINITIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/* *****************************************************************************
+ * OBJECTS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Translates journal events into their names.
+ */
+static char const * const JR_EVENTS[] = {
+        [JOURNAL_CREATED] = "created",
+        [JOURNAL_SPAWNED] = "spawned",
+        [JOURNAL_STOPPED] = "stopped",
+        [JOURNAL_CONTINUED] = "continued",
+        [JOURNAL_REAPED] = "reaped",
+};
+
+/**
+ * @brief Records to print; a negative field matches anything.
+ */
+typedef struct {
+        int event; /**< event to print */
+        long pid; /**< job PID to print */
+        long session; /**< shell session to print */
+} JournalFilter;
+/* *****************************************************************************
+ * FUNCTIONS
+ *
+ *
+ *
+ *
+ *
+ *
+ *
+ ******************************************************************************/
+/**
+ * @brief Looks up the event called @p name.
+ * @return event, or -1 if there is none by that name
+ */
+static int jr_event(char const *name)
+{
+        for (int i = 0; i < JOURNAL_COUNT; i++) {
+                if (strcmp(JR_EVENTS[i], name) == 0) {
+                        return i;
+                }
+        }
+
+        return -1;
+}
+
+/**
+ * @brief Prints the command of @p rec, up to its line ending, escaped as a
+ * JSON string if @p json is set.
+ */
+static void jr_print_command(SH_JournalRecord const *rec, bool json)
+{
+        unsigned char c;
+
+        if (json) {
+                putchar('"');
+        }
+        for (size_t i = 0; i < sizeof rec->command; i++) {
+                c = (unsigned char) rec->command[i];
+                if (c == '\0' || c == '\n') {
+                        break;
+                }
+                if (json && (c == '"' || c == '\\')) {
+                        putchar('\\');
+                        putchar(c);
+                } else if (json && c < 0x20) {
+                        printf("\\u%04x", c);
+                } else {
+                        putchar(c);
+                }
+        }
+        if (json) {
+                putchar('"');
+        }
+}
+
+/**
+ * @brief Prints @p rec, whose event happened at wall time @p time.
+ */
+static void jr_print(SH_JournalRecord const *rec, int64_t time, bool text)
+{
+        char const *event;
+
+        event = rec->event < JOURNAL_COUNT ? JR_EVENTS[rec->event] : "?";
+
+        if (text) {
+                printf("%-10llu %10lld.%06lld %8d %-10s %5u %8d %6d %10lld "
+                       "%10lld %10lld  ",
+                       (unsigned long long) rec->seq,
+                       (long long) (time / 1000000000),
+                       (long long) (time % 1000000000 / 1000),
+                       rec->session, event, rec->spec, rec->pid, rec->status,
+                       (long long) rec->utime_us, (long long) rec->stime_us,
+                       (long long) rec->maxrss_kb);
+                jr_print_command(rec, false);
+                putchar('\n');
+                return;
+        }
+
+        printf("{\"seq\":%llu,\"time\":%lld.%09lld,\"session\":%d,"
+               "\"event\":\"%s\",\"job\":%u,\"pid\":%d,\"pgid\":%d,"
+               "\"background\":%s,\"status\":%d,\"user_us\":%lld,"
+               "\"sys_us\":%lld,\"maxrss_kb\":%lld,\"nvcsw\":%lld,"
+               "\"nivcsw\":%lld,\"command\":",
+               (unsigned long long) rec->seq,
+               (long long) (time / 1000000000),
+               (long long) (time % 1000000000), rec->session, event,
+               rec->spec, rec->pid, rec->pgid,
+               rec->background ? "true" : "false", rec->status,
+               (long long) rec->utime_us, (long long) rec->stime_us,
+               (long long) rec->maxrss_kb, (long long) rec->nvcsw,
+               (long long) rec->nivcsw);
+        jr_print_command(rec, true);
+        printf("}\n");
+}
+
+/**
+ * @brief Prints the records of journal @p header that pass @p filter.
+ */
+static void jr_dump(SH_JournalHeader const *header, JournalFilter const *filter,
+                    bool text)
+{
+        SH_JournalRecord const *records, *rec;
+        uint64_t first;
+
+        records = (SH_JournalRecord const *) (header + 1);
+
+        /* Only the last capacity records are still held. */
+        first = header->head > header->capacity
+                ? header->head - header->capacity : 0;
+
+        if (text) {
+                printf("%-10s %17s %8s %-10s %5s %8s %6s %10s %10s %10s  %s\n",
+                       "seq", "time", "session", "event", "job", "pid",
+                       "status", "user_us", "sys_us", "maxrss_kb", "command");
+        }
+
+        for (uint64_t seq = first; seq < header->head; seq++) {
+                rec = &records[seq % header->capacity];
+
+                /* Skip slots overwritten, or still being written, since. */
+                if (rec->seq != seq) {
+                        continue;
+                }
+                if ((filter->event >= 0 && rec->event != filter->event)
+                    || (filter->pid >= 0 && rec->pid != filter->pid)
+                    || (filter->session >= 0
+                        && rec->session != filter->session)) {
+                        continue;
+                }
+
+                jr_print(rec, (int64_t) rec->time + header->clock_offset, text);
+        }
+        fflush(stdout);
+}
+
+static void jr_usage(char const *prog)
+{
+        fprintf(stderr,
+                "usage: %s [-e event] [-p pid] [-s session] [-t] journal\n"
+                "events:", prog);
+        for (int i = 0; i < JOURNAL_COUNT; i++) {
+                fprintf(stderr, " %s", JR_EVENTS[i]);
+        }
+        fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+        JournalFilter filter;
+        SH_JournalHeader const *header;
+        struct stat st;
+        bool text;
+        void *map;
+        int opt, fd;
+
+        filter.event = -1;
+        filter.pid = -1;
+        filter.session = -1;
+        text = false;
+
+        while ((opt = getopt(argc, argv, "e:p:s:th")) != -1) {
+                switch (opt) {
+                        case 'e': filter.event = jr_event(optarg); break;
+                        case 'p': filter.pid = strtol(optarg, NULL, 10); break;
+                        case 's': filter.session = strtol(optarg, NULL, 10); break;
+                        case 't': text = true; break;
+                        default:
+                                jr_usage(argv[0]);
+                                return EXIT_FAILURE;
+                }
+                if (opt == 'e' && filter.event == -1) {
+                        jr_usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+        if (optind != argc - 1) {
+                jr_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        fd = open(argv[optind], O_RDONLY | O_CLOEXEC);
+        if (fd == -1 || fstat(fd, &st) == -1) {
+                fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+                return EXIT_FAILURE;
+        }
+        if ((size_t) st.st_size < sizeof *header) {
+                fprintf(stderr, "%s: not a journal\n", argv[optind]);
+                return EXIT_FAILURE;
+        }
+
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+                fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+                return EXIT_FAILURE;
+        }
+        header = map;
+
+        if (memcmp(header->magic, SH_JOURNAL_MAGIC, sizeof header->magic) != 0
+            || header->version != SH_JOURNAL_VERSION
+            || header->record_size != sizeof(SH_JournalRecord)
+            || header->capacity == 0
+            || (size_t) st.st_size < sizeof *header
+                                     + header->capacity
+                                       * sizeof(SH_JournalRecord)) {
+                fprintf(stderr, "%s: not a journal\n", argv[optind]);
+                return EXIT_FAILURE;
+        }
+
+        jr_dump(header, &filter, text);
+
+        munmap(map, (size_t) st.st_size);
+
+        return EXIT_SUCCESS;
+}